@@ -10,6 +10,8 @@
 #include <QDBusMessage>
 #include <QDBusPendingReply>
 #include <QDebug>
+#include <QThread>
+#include <QThreadStorage>
 
 using namespace QAccessibleClient;
 
@@ -39,8 +41,17 @@ void DBusConnection::init()
 
 void DBusConnection::initFinished()
 {
-    if (!m_initWatcher)
+    QMutexLocker lock(&m_mutex);
+    if (!finishInit())
         return;
+    lock.unlock();
+    Q_EMIT connectionFetched();
+}
+
+bool DBusConnection::finishInit()
+{
+    if (!m_initWatcher)
+        return false;
     m_status = ConnectionError;
     QDBusPendingReply<QString> reply = *m_initWatcher;
     if (reply.isError() || reply.value().isEmpty()) {
@@ -52,6 +63,7 @@ void DBusConnection::initFinished()
         if (c.isConnected()) {
             qDebug() << "Connected to Accessibility DBus at address=" << busAddress;
             m_connection = c;
+            m_address = busAddress;
             m_status = Connected;
         } else {
             qWarning() << "Found Accessibility DBus address=" << busAddress << "but cannot connect. Falling back to session bus.";
@@ -59,25 +71,77 @@ void DBusConnection::initFinished()
     }
     m_initWatcher->deleteLater();
     m_initWatcher = nullptr;
-    Q_EMIT connectionFetched();
+    return true;
 }
 
 bool DBusConnection::isFetchingConnection() const
 {
+    QMutexLocker lock(&m_mutex);
     return m_initWatcher;
 }
 
 QDBusConnection DBusConnection::connection() const
 {
+    QMutexLocker lock(&m_mutex);
+    bool fetched = false;
     if (m_initWatcher) {
-        m_initWatcher->waitForFinished();
-        const_cast<DBusConnection*>(this)->initFinished();
+        // Waiting on the watcher delivers its finished() right away and initFinished() locks
+        // the mutex again, the plain call sends no signals and is waited for without the lock.
+        QDBusPendingCall call = *m_initWatcher;
+        lock.unlock();
+        call.waitForFinished();
+        lock.relock();
+        fetched = const_cast<DBusConnection*>(this)->finishInit();
+    }
+    const QDBusConnection connection = QThread::currentThread() == thread() ? m_connection : threadConnection();
+    lock.unlock();
+    // receivers in the thread of this instance get the signal queued when emitted from another thread
+    if (fetched)
+        Q_EMIT const_cast<DBusConnection*>(this)->connectionFetched();
+    return connection;
+}
+
+namespace {
+
+// Closes the connection of a thread when the thread finishes.
+class ThreadConnection
+{
+public:
+    explicit ThreadConnection(const QDBusConnection &connection)
+        : connection(connection)
+    {
+    }
+    ~ThreadConnection()
+    {
+        QDBusConnection::disconnectFromBus(connection.name());
+    }
+
+    QDBusConnection connection;
+};
+
+}
+
+QDBusConnection DBusConnection::threadConnection() const
+{
+    // the connections are named after the thread and shared by all instances, they all talk to the same bus
+    static QThreadStorage<ThreadConnection *> connections;
+    if (!connections.hasLocalData()) {
+        const QString name = QStringLiteral("a11y-thread-%1").arg(quintptr(QThread::currentThreadId()), 0, 16);
+        const QDBusConnection connection = m_address.isEmpty()
+                ? QDBusConnection::connectToBus(QDBusConnection::SessionBus, name)
+                : QDBusConnection::connectToBus(m_address, name);
+        if (!connection.isConnected()) {
+            qWarning() << "Cannot connect thread" << QThread::currentThread() << "to the Accessibility DBus, sharing the connection of the main thread.";
+            return m_connection;
+        }
+        connections.setLocalData(new ThreadConnection(connection));
     }
-    return m_connection;
+    return connections.localData()->connection;
 }
 
 DBusConnection::Status DBusConnection::status() const
 {
+    QMutexLocker lock(&m_mutex);
     return m_status;
 }
 
@@ -8,6 +8,7 @@
 #define DBUSCONNECTION_H
 
 #include <QObject>
+#include <QMutex>
 #include <QDBusConnection>
 #include <QDBusPendingCallWatcher>
 
@@ -53,6 +54,11 @@ public:
         yet, means \a isFetchingConnection returns true, then
         calling this method will block till the connection was
         fetched.
+
+        Called from another thread than the one of this instance
+        a connection of that thread to the same bus is returned,
+        so threads making blocking calls do not queue up behind
+        each other. It is closed when the thread finishes.
      */
     QDBusConnection connection() const;
 
@@ -92,8 +98,15 @@ private Q_SLOTS:
 
 private:
     void init();
+    // Returns whether the fetch finished just now, false if it was finished before.
+    // The caller emits connectionFetched() without holding m_mutex.
+    bool finishInit();
+    QDBusConnection threadConnection() const;
 
+    mutable QMutex m_mutex;
     QDBusConnection m_connection;
+    // empty when falling back to the session bus
+    QString m_address;
     mutable Status m_status = Disconnected;
     QDBusPendingCallWatcher *m_initWatcher = nullptr;
 };
@@ -22,6 +22,12 @@ void registerDBusTypes()
 
     qRegisterMetaType<QAccessibleClient::QSpiActionArray>();
     qDBusRegisterMetaType<QAccessibleClient::QSpiActionArray>();
+
+    qRegisterMetaType<QAccessibleClient::QSpiAccessibleCacheItem>();
+    qDBusRegisterMetaType<QAccessibleClient::QSpiAccessibleCacheItem>();
+
+    qRegisterMetaType<QAccessibleClient::QSpiAccessibleCacheArray>();
+    qDBusRegisterMetaType<QAccessibleClient::QSpiAccessibleCacheArray>();
 }
 
 /* QSpiObjectReference */
@@ -65,6 +71,46 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, QAccessibleClient
     return argument;
 }
 
+/* QSpiAccessibleCacheItem */
+/*---------------------------------------------------------------------------*/
+
+QDBusArgument &operator<<(QDBusArgument &argument, const QAccessibleClient::QSpiAccessibleCacheItem &item)
+{
+    argument.beginStructure();
+    argument << item.path;
+    argument << item.application;
+    argument << item.parent;
+    argument << item.children;
+    argument << item.supportedInterfaces;
+    argument << item.name;
+    argument << item.role;
+    argument << item.description;
+    argument << item.state;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, QAccessibleClient::QSpiAccessibleCacheItem &item)
+{
+    argument.beginStructure();
+    argument >> item.path;
+    argument >> item.application;
+    argument >> item.parent;
+    if (argument.currentType() == QDBusArgument::ArrayType) {
+        argument >> item.children;
+    } else {
+        argument >> item.indexInParent;
+        argument >> item.childCount;
+    }
+    argument >> item.supportedInterfaces;
+    argument >> item.name;
+    argument >> item.role;
+    argument >> item.description;
+    argument >> item.state;
+    argument.endStructure();
+    return argument;
+}
+
 }
 QDebug operator<<(QDebug d, const QAccessibleClient::QSpiAction &t)
 {
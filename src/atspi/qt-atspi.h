@@ -11,6 +11,7 @@
 
 #include <QList>
 #include <QString>
+#include <QStringList>
 #include <QDBusArgument>
 #include <QDebug>
 
@@ -30,6 +31,11 @@ struct QSpiObjectReference
 {
     QString service;
     QDBusObjectPath path;
+
+    bool operator==(const QSpiObjectReference &other) const
+    {
+        return path == other.path && service == other.service;
+    }
 };
 
 typedef QList<QAccessibleClient::QSpiObjectReference> QSpiObjectReferenceList;
@@ -43,6 +49,33 @@ struct QSpiAction
 
 typedef QList <QSpiAction> QSpiActionArray;
 
+/**
+    One entry of the org.a11y.atspi.Cache interface.
+
+    Two layouts are in use. Qt and older at-spi2-atk send
+    ((so)(so)(so)a(so)assusau) that lists the children while newer
+    at-spi2 versions send ((so)(so)(so)iiassusau) with the index in
+    parent and the number of children instead. Reading handles both,
+    the members not transmitted keep their defaults.
+    \internal
+ */
+struct QSpiAccessibleCacheItem
+{
+    QSpiObjectReference path;
+    QSpiObjectReference application;
+    QSpiObjectReference parent;
+    QSpiObjectReferenceList children;
+    int indexInParent = -1;
+    int childCount = -1;
+    QStringList supportedInterfaces;
+    QString name;
+    uint role = 0;
+    QString description;
+    QList<quint32> state;
+};
+
+typedef QList<QSpiAccessibleCacheItem> QSpiAccessibleCacheArray;
+
 /**
     \internal
  */
@@ -63,11 +96,23 @@ QDBusArgument &operator<<(QDBusArgument &argument, const QSpiAction &address);
  */
 const QDBusArgument &operator>>(const QDBusArgument &argument, QSpiAction &address);
 
+/**
+    \internal
+ */
+QDBusArgument &operator<<(QDBusArgument &argument, const QSpiAccessibleCacheItem &item);
+
+/**
+    \internal
+ */
+const QDBusArgument &operator>>(const QDBusArgument &argument, QSpiAccessibleCacheItem &item);
+
 }
 
 Q_DECLARE_METATYPE(QAccessibleClient::QSpiObjectReference);
 Q_DECLARE_METATYPE(QAccessibleClient::QSpiObjectReferenceList);
 Q_DECLARE_METATYPE(QAccessibleClient::QSpiAction)
 Q_DECLARE_METATYPE(QAccessibleClient::QSpiActionArray)
+Q_DECLARE_METATYPE(QAccessibleClient::QSpiAccessibleCacheItem)
+Q_DECLARE_METATYPE(QAccessibleClient::QSpiAccessibleCacheArray)
 QDebug operator<<(QDebug d, const QAccessibleClient::QSpiAction &t);
 #endif
@@ -0,0 +1,28 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "accessibleevent.h"
+
+#include <QDebug>
+#include <QMetaEnum>
+
+using namespace QAccessibleClient;
+
+#ifndef QT_NO_DEBUG_STREAM
+QACCESSIBILITYCLIENT_EXPORT QDebug QAccessibleClient::operator<<(QDebug d, const AccessibleEvent &event)
+{
+    QDebugStateSaver saver(d);
+    d.nospace() << "AccessibleEvent(" << QMetaEnum::fromType<AccessibleEvent::Type>().valueToKey(event.type())
+                << " handle=" << Qt::hex << event.handle() << Qt::dec
+                << " detail1=" << event.detail1() << " detail2=" << event.detail2();
+    if (event.payload().isValid())
+        d << " payload=" << event.payload();
+    d << ')';
+    return d;
+}
+#endif
+
+#include "moc_accessibleevent.cpp"
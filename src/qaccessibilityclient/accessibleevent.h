@@ -0,0 +1,192 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef QACCESSIBILITYCLIENT_ACCESSIBLEEVENT_H
+#define QACCESSIBILITYCLIENT_ACCESSIBLEEVENT_H
+
+#include <QMetaType>
+#include <QVariant>
+
+#include "qaccessibilityclient_export.h"
+
+namespace QAccessibleClient {
+
+class AccessibleEvent;
+class RegistryPrivate;
+
+#ifndef QT_NO_DEBUG_STREAM
+    QACCESSIBILITYCLIENT_EXPORT QDebug operator<<(QDebug, const AccessibleEvent &);
+#endif
+
+/*!
+    \inmodule QAccessibilityClient
+    \class QAccessibleClient::AccessibleEvent
+    \brief This class describes an event sent by an accessible application.
+
+    Registry::accessibleEvent() and Registry::accessibleEvents() deliver
+    all events as AccessibleEvent, an alternative to connecting to each
+    of the specific signals of Registry.
+
+    The object the event is about is only referred to by its handle, no
+    AccessibleObject is created for it. Registry::accessibleFromEvent()
+    returns the object when needed.
+
+    Events are cheap to copy and only created by the library.
+*/
+class QACCESSIBILITYCLIENT_EXPORT AccessibleEvent
+{
+    Q_GADGET
+public:
+    /*!
+      \enum QAccessibleClient::AccessibleEvent::Type
+      \brief The kind of event, named after the Registry signal it accompanies.
+
+      Unless listed below detail1(), detail2() and payload() are not used.
+
+      \value InvalidEvent
+      \value WindowCreated
+      \value WindowDestroyed
+      \value WindowClosed
+      \value WindowReparented
+      \value WindowMinimized
+      \value WindowMaximized
+      \value WindowRestored
+      \value WindowActivated
+      \value WindowDeactivated
+      \value WindowDesktopCreated
+      \value WindowDesktopDestroyed
+      \value WindowRaised
+      \value WindowLowered
+      \value WindowMoved
+      \value WindowResized
+      \value WindowShaded
+      \value WindowUnshaded
+      \value StateChanged
+             detail1() is 1 if the state is now set, detail2() the
+             AccessibleObject::State or 0 for states the library does not
+             know and payload() the name of the state.
+      \value FocusChanged
+      \value ChildAdded
+             detail1() is the index of the child.
+      \value ChildRemoved
+             detail1() is the index of the child.
+      \value VisibleDataChanged
+      \value SelectionChanged
+      \value ModelChanged
+      \value TextCaretMoved
+             detail1() is the new caret offset.
+      \value TextSelectionChanged
+      \value TextInserted
+             detail1() and detail2() are the start and end offset,
+             payload() the text.
+      \value TextRemoved
+             Like TextInserted.
+      \value TextChanged
+             Like TextInserted.
+      \value NameChanged
+      \value DescriptionChanged
+    */
+    enum Type {
+        InvalidEvent,
+        WindowCreated,
+        WindowDestroyed,
+        WindowClosed,
+        WindowReparented,
+        WindowMinimized,
+        WindowMaximized,
+        WindowRestored,
+        WindowActivated,
+        WindowDeactivated,
+        WindowDesktopCreated,
+        WindowDesktopDestroyed,
+        WindowRaised,
+        WindowLowered,
+        WindowMoved,
+        WindowResized,
+        WindowShaded,
+        WindowUnshaded,
+        StateChanged,
+        FocusChanged,
+        ChildAdded,
+        ChildRemoved,
+        VisibleDataChanged,
+        SelectionChanged,
+        ModelChanged,
+        TextCaretMoved,
+        TextSelectionChanged,
+        TextInserted,
+        TextRemoved,
+        TextChanged,
+        NameChanged,
+        DescriptionChanged
+    };
+    Q_ENUM(Type)
+
+    /*!
+      Constructs an invalid event.
+     */
+    AccessibleEvent() = default;
+
+    /*!
+      Returns \c true unless the event was default constructed.
+     */
+    bool isValid() const { return m_type != InvalidEvent; }
+    /*!
+      Returns the kind of event.
+     */
+    Type type() const { return m_type; }
+    /*!
+      Returns the handle of the object the event is about.
+
+      Handles identify an object within the Registry that delivered the
+      event, they are equal for events about the same object.
+      \sa Registry::accessibleFromEvent()
+     */
+    quint64 handle() const { return m_handle; }
+    /*!
+      Returns the first detail, see Type for its meaning.
+     */
+    int detail1() const { return m_detail1; }
+    /*!
+      Returns the second detail, see Type for its meaning.
+     */
+    int detail2() const { return m_detail2; }
+    /*!
+      Returns the data the event carries, see Type for its meaning.
+     */
+    const QVariant &payload() const { return m_payload; }
+    /*!
+      Returns when the event arrived, in nanoseconds of the monotonic
+      clock QDeadlineTimer uses.
+     */
+    qint64 timestamp() const { return m_timestamp; }
+
+private:
+    AccessibleEvent(Type type, quint64 handle, int detail1, int detail2, const QVariant &payload, qint64 timestamp)
+        : m_type(type)
+        , m_detail1(detail1)
+        , m_detail2(detail2)
+        , m_handle(handle)
+        , m_timestamp(timestamp)
+        , m_payload(payload)
+    {
+    }
+
+    Type m_type = InvalidEvent;
+    int m_detail1 = 0;
+    int m_detail2 = 0;
+    quint64 m_handle = 0;
+    qint64 m_timestamp = 0;
+    QVariant m_payload;
+
+    friend class RegistryPrivate;
+};
+
+}
+
+Q_DECLARE_METATYPE(QAccessibleClient::AccessibleEvent)
+
+#endif
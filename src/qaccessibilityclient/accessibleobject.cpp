@@ -15,6 +15,10 @@
 
 #include <atspi/atspi-constants.h>
 
+static_assert(QAccessibleClient::AccessibleObject::ActiveState == ATSPI_STATE_ACTIVE, "State values follow AtspiStateType");
+static_assert(QAccessibleClient::AccessibleObject::FocusableState == ATSPI_STATE_FOCUSABLE, "State values follow AtspiStateType");
+static_assert(QAccessibleClient::AccessibleObject::VisitedState == ATSPI_STATE_VISITED, "State values follow AtspiStateType");
+
 using namespace QAccessibleClient;
 
 AccessibleObject::AccessibleObject()
@@ -28,16 +32,7 @@ AccessibleObject::AccessibleObject(RegistryPrivate *registryPrivate, const QStri
     Q_ASSERT(registryPrivate);
     Q_ASSERT(!service.isEmpty());
     Q_ASSERT(!path.isEmpty());
-    if (registryPrivate->m_cache) {
-        const QString id = path + service;
-        d = registryPrivate->m_cache->get(id);
-        if (!d) {
-            d = QSharedPointer<AccessibleObjectPrivate>(new AccessibleObjectPrivate(registryPrivate, service, path));
-            registryPrivate->m_cache->add(id, d);
-        }
-    } else {
-        d = QSharedPointer<AccessibleObjectPrivate>(new AccessibleObjectPrivate(registryPrivate, service, path));
-    }
+    d = registryPrivate->accessibleFromHandle(registryPrivate->m_identities.handle(service, path)).d;
 }
 
 AccessibleObject::AccessibleObject(const QSharedPointer<AccessibleObjectPrivate> &dd)
@@ -58,7 +53,7 @@ QString AccessibleObject::id() const
 {
     if (!d || !d->registryPrivate)
         return QString();
-    return d->path + d->service;
+    return d->registryPrivate->m_identities.id(d->handle);
 }
 
 QUrl AccessibleObject::url() const
@@ -67,17 +62,15 @@ QUrl AccessibleObject::url() const
         return QUrl();
     QUrl u;
     u.setScheme(d->registryPrivate->ACCESSIBLE_OBJECT_SCHEME_STRING);
-    u.setPath(d->path);
-    u.setFragment(d->service);
+    u.setPath(d->path());
+    u.setFragment(d->service());
     return u;
 }
 
 bool AccessibleObject::isValid() const
 {
     return d && d->registryPrivate
-             && (!d->service.isEmpty())
-             && (!d->path.isEmpty())
-             && (d->path != QLatin1String("/org/a11y/atspi/null"));
+             && d->registryPrivate->m_identities.isValid(d->handle);
 }
 
 AccessibleObject &AccessibleObject::operator=(const AccessibleObject &other)
@@ -105,15 +98,22 @@ QVector< QList<AccessibleObject> > AccessibleObject::children(const QList<Role>
 {
     QVector< QList<AccessibleObject> > result(roles.count());
     const QList<AccessibleObject> all = children();
+    const Registry::QueryResult query = d->registryPrivate->query(all, Registry::QueryRole);
     for(int i = 0; i < all.count(); ++i) {
         const AccessibleObject &child = all[i];
-        int index = roles.indexOf(child.role());
+        int index = roles.indexOf(query.roles.at(i));
         if (index < 0) continue;
         result[index].append(child);
     }
     return result;
 }
 
+QList<AccessibleObject> AccessibleObject::findMatches(const QList<Role> &roles, const QList<State> &states, Interfaces interfaces,
+                                                      const QMap<QString, QString> &attributes, int depth, int limit) const
+{
+    return d->registryPrivate->findMatches(*this, roles, states, interfaces, attributes, depth, limit);
+}
+
 int AccessibleObject::childCount() const
 {
     return d->registryPrivate->childCount(*this);
@@ -199,6 +199,11 @@ AccessibleObject::Interfaces AccessibleObject::supportedInterfaces() const
     return d->registryPrivate->supportedInterfaces(*this);
 }
 
+void AccessibleObject::prefetch(Interfaces interfaces)
+{
+    d->registryPrivate->prefetch(*this, interfaces);
+}
+
 int AccessibleObject::caretOffset() const
 {
     if( supportedInterfaces() & AccessibleObject::TextInterface ){
@@ -397,12 +402,15 @@ QVector< QSharedPointer<QAction> > AccessibleObject::actions() const
 {
     // Actions in atspi are supposed to be static what means they cannot change in
     // between (e.g. actions removed or added or edited) so we can safely just
-    // fetch them only once and store the result for the life-time of the object,
-    if (!d->actionsFetched) {
-        d->actionsFetched = true;
-        d->actions = d->registryPrivate->actions(*this);
+    // fetch them only once and store the result for the life-time of the object.
+    // The call is made without the lock, of threads asking at the same time the first
+    // answer is kept.
+    {
+        QMutexLocker lock(&d->mutex);
+        if (d->actionsFetched)
+            return d->actions;
     }
-    return d->actions;
+    return d->publishActions(d->registryPrivate->actions(*this));
 }
 
 bool AccessibleObject::hasSelectableText() const
@@ -442,7 +450,7 @@ bool AccessibleObject::isChecked() const
 
 bool AccessibleObject::isDefunct() const
 {
-    return d->defunct;
+    return d->defunct.loadAcquire();
 }
 
 bool AccessibleObject::isDefault() const
@@ -535,14 +543,204 @@ bool AccessibleObject::supportsAutocompletion() const
     return d->registryPrivate->state(*this) & (quint64(1) << ATSPI_STATE_SUPPORTS_AUTOCOMPLETION);
 }
 
+QFuture<QString> AccessibleObject::accessibleIdAsync() const
+{
+    return d->registryPrivate->accessibleIdAsync(*this);
+}
+
+QFuture<QString> AccessibleObject::nameAsync() const
+{
+    return d->registryPrivate->nameAsync(*this);
+}
+
+QFuture<QString> AccessibleObject::descriptionAsync() const
+{
+    return d->registryPrivate->descriptionAsync(*this);
+}
+
+QFuture<AccessibleObject::Role> AccessibleObject::roleAsync() const
+{
+    return d->registryPrivate->roleAsync(*this);
+}
+
+QFuture<QString> AccessibleObject::roleNameAsync() const
+{
+    return d->registryPrivate->roleNameAsync(*this);
+}
+
+QFuture<QString> AccessibleObject::localizedRoleNameAsync() const
+{
+    return d->registryPrivate->localizedRoleNameAsync(*this);
+}
+
+QFuture<AccessibleObject> AccessibleObject::parentAsync() const
+{
+    return d->registryPrivate->parentAccessibleAsync(*this);
+}
+
+QFuture<int> AccessibleObject::indexInParentAsync() const
+{
+    return d->registryPrivate->indexInParentAsync(*this);
+}
+
+QFuture<QList<AccessibleObject> > AccessibleObject::childrenAsync() const
+{
+    return d->registryPrivate->childrenAsync(*this);
+}
+
+QFuture<int> AccessibleObject::childCountAsync() const
+{
+    return d->registryPrivate->childCountAsync(*this);
+}
+
+QFuture<AccessibleObject> AccessibleObject::childAsync(int index) const
+{
+    return d->registryPrivate->childAsync(*this, index);
+}
+
+QFuture<QRect> AccessibleObject::boundingRectAsync() const
+{
+    return d->registryPrivate->boundingRectAsync(*this);
+}
+
+QFuture<AccessibleObject::Interfaces> AccessibleObject::supportedInterfacesAsync() const
+{
+    return d->registryPrivate->supportedInterfacesAsync(*this);
+}
+
+QFuture<int> AccessibleObject::caretOffsetAsync() const
+{
+    return d->registryPrivate->caretOffsetAsync(*this);
+}
+
+QFuture<int> AccessibleObject::characterCountAsync() const
+{
+    return d->registryPrivate->characterCountAsync(*this);
+}
+
+QFuture<QString> AccessibleObject::textAsync(int startOffset, int endOffset) const
+{
+    return d->registryPrivate->textAsync(*this, startOffset, endOffset);
+}
+
+QFuture<AccessibleObject> AccessibleObject::applicationAsync() const
+{
+    return d->registryPrivate->applicationAsync(*this);
+}
+
+QFuture<double> AccessibleObject::currentValueAsync() const
+{
+    return d->registryPrivate->currentValueAsync(*this);
+}
+
+QFuture<double> AccessibleObject::minimumValueAsync() const
+{
+    return d->registryPrivate->minimumValueAsync(*this);
+}
+
+QFuture<double> AccessibleObject::maximumValueAsync() const
+{
+    return d->registryPrivate->maximumValueAsync(*this);
+}
+
+QFuture<double> AccessibleObject::minimumValueIncrementAsync() const
+{
+    return d->registryPrivate->minimumValueIncrementAsync(*this);
+}
+
+QFuture<int> AccessibleObject::layerAsync() const
+{
+    return d->registryPrivate->layerAsync(*this);
+}
+
+QFuture<int> AccessibleObject::mdiZOrderAsync() const
+{
+    return d->registryPrivate->mdiZOrderAsync(*this);
+}
+
+QFuture<double> AccessibleObject::alphaAsync() const
+{
+    return d->registryPrivate->alphaAsync(*this);
+}
+
+QFuture<QRect> AccessibleObject::characterRectAsync(int offset) const
+{
+    return d->registryPrivate->characterRectAsync(*this, offset);
+}
+
+QFuture<QList< QPair<int,int> > > AccessibleObject::textSelectionsAsync() const
+{
+    return d->registryPrivate->textSelectionsAsync(*this);
+}
+
+QFuture<AccessibleObject::TextRange> AccessibleObject::textWithBoundaryAsync(int offset, TextBoundary boundary) const
+{
+    return d->registryPrivate->textWithBoundaryAsync(*this, offset, boundary);
+}
+
+QFuture<QString> AccessibleObject::appToolkitNameAsync() const
+{
+    return d->registryPrivate->appToolkitNameAsync(*this);
+}
+
+QFuture<QString> AccessibleObject::appVersionAsync() const
+{
+    return d->registryPrivate->appVersionAsync(*this);
+}
+
+QFuture<int> AccessibleObject::appIdAsync() const
+{
+    return d->registryPrivate->appIdAsync(*this);
+}
+
+QFuture<QString> AccessibleObject::appLocaleAsync(LocaleType lctype) const
+{
+    return d->registryPrivate->appLocaleAsync(*this, lctype);
+}
+
+QFuture<QString> AccessibleObject::appBusAddressAsync() const
+{
+    return d->registryPrivate->appBusAddressAsync(*this);
+}
+
+QFuture<QList<AccessibleObject> > AccessibleObject::selectionAsync() const
+{
+    return d->registryPrivate->selectionAsync(*this);
+}
+
+QFuture<QString> AccessibleObject::imageDescriptionAsync() const
+{
+    return d->registryPrivate->imageDescriptionAsync(*this);
+}
+
+QFuture<QString> AccessibleObject::imageLocaleAsync() const
+{
+    return d->registryPrivate->imageLocaleAsync(*this);
+}
+
+QFuture<QRect> AccessibleObject::imageRectAsync() const
+{
+    return d->registryPrivate->imageRectAsync(*this);
+}
+
+QFuture<quint64> AccessibleObject::stateAsync() const
+{
+    return d->registryPrivate->stateAsync(*this);
+}
+
+QFuture<QVector< QSharedPointer<QAction> > > AccessibleObject::actionsAsync() const
+{
+    return d->registryPrivate->actionsAsync(*this);
+}
+
 #ifndef QT_NO_DEBUG_STREAM
 QACCESSIBILITYCLIENT_EXPORT QDebug QAccessibleClient::operator<<(QDebug d, const AccessibleObject &object)
 {
     d.nospace();
     d << "AccessibleObject(";
     if (object.d) {
-        d << "service=" << object.d->service;
-        d << " path=" << object.d->path;
+        d << "service=" << object.d->service();
+        d << " path=" << object.d->path();
         d << " name=" << object.name();
     } else {
         d << "invalid";
@@ -13,8 +13,10 @@ namespace QAccessibleClient {
 }
 
 #include <QList>
+#include <QMap>
 #include <QSharedPointer>
 #include <QAction>
+#include <QFuture>
 
 #include "qaccessibilityclient_export.h"
 
@@ -246,6 +248,96 @@ public:
 //    LayeredPane    = 0x00000080,
     };
 
+    /*!
+      \enum QAccessibleClient::AccessibleObject::State
+      The states an AccessibleObject can be in, used to search for objects
+      with findMatches(). The values are the bit positions of the state
+      set as returned by the accessibility bus.
+
+      \value ActiveState
+      \value ArmedState
+      \value BusyState
+      \value CheckedState
+      \value CollapsedState
+      \value DefunctState
+      \value EditableState
+      \value EnabledState
+      \value ExpandableState
+      \value ExpandedState
+      \value FocusableState
+      \value FocusedState
+      \value HasToolTipState
+      \value HorizontalState
+      \value IconifiedState
+      \value ModalState
+      \value MultiLineState
+      \value MultiSelectableState
+      \value OpaqueState
+      \value PressedState
+      \value ResizableState
+      \value SelectableState
+      \value SelectedState
+      \value SensitiveState
+      \value ShowingState
+      \value SingleLineState
+      \value StaleState
+      \value TransientState
+      \value VerticalState
+      \value VisibleState
+      \value ManagesDescendantsState
+      \value IndeterminateState
+      \value RequiredState
+      \value TruncatedState
+      \value AnimatedState
+      \value InvalidEntryState
+      \value SupportsAutocompletionState
+      \value SelectableTextState
+      \value IsDefaultState
+      \value VisitedState
+     */
+    enum State {
+        ActiveState = 1,
+        ArmedState = 2,
+        BusyState = 3,
+        CheckedState = 4,
+        CollapsedState = 5,
+        DefunctState = 6,
+        EditableState = 7,
+        EnabledState = 8,
+        ExpandableState = 9,
+        ExpandedState = 10,
+        FocusableState = 11,
+        FocusedState = 12,
+        HasToolTipState = 13,
+        HorizontalState = 14,
+        IconifiedState = 15,
+        ModalState = 16,
+        MultiLineState = 17,
+        MultiSelectableState = 18,
+        OpaqueState = 19,
+        PressedState = 20,
+        ResizableState = 21,
+        SelectableState = 22,
+        SelectedState = 23,
+        SensitiveState = 24,
+        ShowingState = 25,
+        SingleLineState = 26,
+        StaleState = 27,
+        TransientState = 28,
+        VerticalState = 29,
+        VisibleState = 30,
+        ManagesDescendantsState = 31,
+        IndeterminateState = 32,
+        RequiredState = 33,
+        TruncatedState = 34,
+        AnimatedState = 35,
+        InvalidEntryState = 36,
+        SupportsAutocompletionState = 37,
+        SelectableTextState = 38,
+        IsDefaultState = 39,
+        VisitedState = 40
+    };
+
     /*!
         \enum QAccessibleClient::AccessibleObject::TextBoundary
         \brief The TextBoundaries enum represents the different boundaries when
@@ -357,6 +449,35 @@ public:
      */
     QVector< QList<AccessibleObject> > children(const QList<Role> &roles) const;
 
+    /*!
+        \brief Searches the subtree below this object.
+
+        Returns the descendants that have one of the \a roles, all of the
+        \a states, all of the \a interfaces and all of the \a attributes.
+        Empty criteria match every object. The search goes \a depth levels
+        deep, -1 searches the whole subtree and 1 only the direct children.
+        At most \a limit objects are returned, 0 means no limit. The
+        objects are returned in tree order.
+
+        If the object implements the CollectionInterface and the whole
+        subtree or only the children are searched, the matching happens
+        inside the application with a single GetMatches call. Otherwise
+        the tree is walked here, fetching the properties of each group
+        of siblings at once.
+
+        Example usage:
+        \code
+        QList<AccessibleObject> buttons = window.findMatches(
+            QList<AccessibleObject::Role>() << AccessibleObject::Button,
+            QList<AccessibleObject::State>() << AccessibleObject::FocusableState);
+        \endcode
+     */
+    QList<AccessibleObject> findMatches(const QList<Role> &roles,
+                                        const QList<State> &states = QList<State>(),
+                                        Interfaces interfaces = NoInterface,
+                                        const QMap<QString, QString> &attributes = QMap<QString, QString>(),
+                                        int depth = -1, int limit = 0) const;
+
     /*!
         \brief Returns the number of children for this accessible.
      */
@@ -463,6 +584,28 @@ public:
     */
     Interfaces supportedInterfaces() const;
 
+    /*!
+        \brief Fetches all properties of the given \a interfaces at once.
+
+        Reading many properties of one object normally costs one D-Bus round
+        trip each. This asks for all properties of the AccessibleInterface,
+        ValueInterface, TextInterface and ApplicationInterface, as far as
+        they are part of \a interfaces, with one GetAll call per interface.
+        The calls are sent together, so warming an object costs about one
+        round trip. Afterwards name(), description(), parent(), childCount(),
+        minimumValue(), maximumValue(), currentValue(), caretOffset(),
+        characterCount() and similar getters are answered from memory.
+
+        The values are dropped again when the matching property, text or
+        children change events arrive. This needs the events to be
+        subscribed, otherwise the values reflect the time of the prefetch.
+        Interfaces the object does not implement are skipped.
+
+        This blocks until all replies arrived and, right after the registry
+        was created, until the accessibility bus is connected.
+    */
+    void prefetch(Interfaces interfaces = Interfaces(AccessibleInterface));
+
     /*!
         \brief Returns the offset of the caret from the beginning of the text.
 
@@ -817,6 +960,138 @@ public:
     /*! Returns if the AccessibleObject supports automatic text completion. */
     bool supportsAutocompletion() const;
 
+    // asynchronous variants
+
+    /*!
+        \brief Asynchronous variant of accessibleId().
+
+        All the *Async() functions send their request and return right away.
+        The returned future is fulfilled from the event loop of the thread
+        owning the Registry as soon as the reply arrived, so many queries
+        can be in flight at the same time without blocking the caller.
+        Use QFuture::then() or a QFutureWatcher to get notified.
+
+        Calling QFuture::waitForFinished() on the thread that owns the
+        Registry will dead-lock since the reply can never be delivered.
+     */
+    QFuture<QString> accessibleIdAsync() const;
+    /*! \brief Asynchronous variant of name(). \sa accessibleIdAsync() */
+    QFuture<QString> nameAsync() const;
+    /*! \brief Asynchronous variant of description(). \sa accessibleIdAsync() */
+    QFuture<QString> descriptionAsync() const;
+    /*! \brief Asynchronous variant of role(). \sa accessibleIdAsync() */
+    QFuture<Role> roleAsync() const;
+    /*! \brief Asynchronous variant of roleName(). \sa accessibleIdAsync() */
+    QFuture<QString> roleNameAsync() const;
+    /*! \brief Asynchronous variant of localizedRoleName(). \sa accessibleIdAsync() */
+    QFuture<QString> localizedRoleNameAsync() const;
+    /*! \brief Asynchronous variant of parent(). \sa accessibleIdAsync() */
+    QFuture<AccessibleObject> parentAsync() const;
+    /*! \brief Asynchronous variant of indexInParent(). \sa accessibleIdAsync() */
+    QFuture<int> indexInParentAsync() const;
+    /*! \brief Asynchronous variant of children(). \sa accessibleIdAsync() */
+    QFuture<QList<AccessibleObject> > childrenAsync() const;
+    /*! \brief Asynchronous variant of childCount(). \sa accessibleIdAsync() */
+    QFuture<int> childCountAsync() const;
+    /*! \brief Asynchronous variant of child() for the child at \a index. \sa accessibleIdAsync() */
+    QFuture<AccessibleObject> childAsync(int index) const;
+    /*!
+        \brief Asynchronous variant of boundingRect().
+
+        Unlike boundingRect() this does not check supportedInterfaces() first,
+        an empty rectangle is delivered if the object does not implement
+        the component interface.
+        \sa accessibleIdAsync()
+     */
+    QFuture<QRect> boundingRectAsync() const;
+    /*! \brief Asynchronous variant of supportedInterfaces(). \sa accessibleIdAsync() */
+    QFuture<Interfaces> supportedInterfacesAsync() const;
+    /*! \brief Asynchronous variant of caretOffset(). \sa accessibleIdAsync() */
+    QFuture<int> caretOffsetAsync() const;
+    /*! \brief Asynchronous variant of characterCount(). \sa accessibleIdAsync() */
+    QFuture<int> characterCountAsync() const;
+    /*!
+        \brief Asynchronous variant of text() between \a startOffset and \a endOffset.
+        \sa accessibleIdAsync()
+     */
+    QFuture<QString> textAsync(int startOffset = 0, int endOffset = -1) const;
+    /*! \brief Asynchronous variant of application(). \sa accessibleIdAsync() */
+    QFuture<AccessibleObject> applicationAsync() const;
+    /*! \brief Asynchronous variant of currentValue(). \sa accessibleIdAsync() */
+    QFuture<double> currentValueAsync() const;
+    /*! \brief Asynchronous variant of minimumValue(). \sa accessibleIdAsync() */
+    QFuture<double> minimumValueAsync() const;
+    /*! \brief Asynchronous variant of maximumValue(). \sa accessibleIdAsync() */
+    QFuture<double> maximumValueAsync() const;
+    /*! \brief Asynchronous variant of minimumValueIncrement(). \sa accessibleIdAsync() */
+    QFuture<double> minimumValueIncrementAsync() const;
+    /*! \brief Asynchronous variant of layer(). \sa accessibleIdAsync() */
+    QFuture<int> layerAsync() const;
+    /*! \brief Asynchronous variant of mdiZOrder(). \sa accessibleIdAsync() */
+    QFuture<int> mdiZOrderAsync() const;
+    /*! \brief Asynchronous variant of alpha(). \sa accessibleIdAsync() */
+    QFuture<double> alphaAsync() const;
+    /*!
+        \brief Asynchronous variant of characterRect() for the character at \a offset.
+
+        Like boundingRectAsync() this does not check supportedInterfaces()
+        first, as neither do textSelectionsAsync() and textWithBoundaryAsync().
+        \sa accessibleIdAsync()
+     */
+    QFuture<QRect> characterRectAsync(int offset) const;
+    /*! \brief Asynchronous variant of textSelections(). \sa characterRectAsync() */
+    QFuture<QList< QPair<int,int> > > textSelectionsAsync() const;
+
+    /*!
+        \brief A piece of text and its offsets, as delivered by textWithBoundaryAsync().
+     */
+    struct TextRange {
+        QString text;
+        int startOffset = 0;
+        int endOffset = 0;
+    };
+    /*!
+        \brief Asynchronous variant of textWithBoundary() at \a offset for \a boundary.
+
+        The offsets textWithBoundary() writes to its arguments are part of the result.
+        \sa characterRectAsync()
+     */
+    QFuture<TextRange> textWithBoundaryAsync(int offset, TextBoundary boundary) const;
+    /*! \brief Asynchronous variant of appToolkitName(). \sa accessibleIdAsync() */
+    QFuture<QString> appToolkitNameAsync() const;
+    /*! \brief Asynchronous variant of appVersion(). \sa accessibleIdAsync() */
+    QFuture<QString> appVersionAsync() const;
+    /*! \brief Asynchronous variant of appId(). \sa accessibleIdAsync() */
+    QFuture<int> appIdAsync() const;
+    /*! \brief Asynchronous variant of appLocale() for \a lctype. \sa accessibleIdAsync() */
+    QFuture<QString> appLocaleAsync(LocaleType lctype = LocaleTypeMessages) const;
+    /*! \brief Asynchronous variant of appBusAddress(). \sa accessibleIdAsync() */
+    QFuture<QString> appBusAddressAsync() const;
+    /*! \brief Asynchronous variant of selection(). \sa accessibleIdAsync() */
+    QFuture<QList<AccessibleObject> > selectionAsync() const;
+    /*! \brief Asynchronous variant of imageDescription(). \sa accessibleIdAsync() */
+    QFuture<QString> imageDescriptionAsync() const;
+    /*! \brief Asynchronous variant of imageLocale(). \sa accessibleIdAsync() */
+    QFuture<QString> imageLocaleAsync() const;
+    /*! \brief Asynchronous variant of imageRect(). \sa accessibleIdAsync() */
+    QFuture<QRect> imageRectAsync() const;
+    /*!
+        \brief Asynchronous variant of the state accessors like isFocused().
+
+        Delivers the state set of the object, the bit at the position of
+        each State the object is in is set, as in Registry::QueryResult.
+        \sa accessibleIdAsync()
+     */
+    QFuture<quint64> stateAsync() const;
+    /*!
+        \brief Asynchronous variant of actions().
+
+        The actions are fetched only once like for actions(), the same
+        list is delivered by both.
+        \sa accessibleIdAsync()
+     */
+    QFuture<QVector< QSharedPointer<QAction> > > actionsAsync() const;
+
 private:
     AccessibleObject(RegistryPrivate *reg, const QString &service, const QString &path);
     AccessibleObject(const QSharedPointer<AccessibleObjectPrivate> &dd);
@@ -837,5 +1112,6 @@ private:
 }
 
 Q_DECLARE_METATYPE(QAccessibleClient::AccessibleObject)
+Q_DECLARE_METATYPE(QAccessibleClient::AccessibleObject::State)
 
 #endif
@@ -11,12 +11,12 @@
 
 using namespace QAccessibleClient;
 
-AccessibleObjectPrivate::AccessibleObjectPrivate(RegistryPrivate *reg, const QString &service_, const QString &path_)
+AccessibleObjectPrivate::AccessibleObjectPrivate(RegistryPrivate *reg, ObjectHandle handle_)
     : registryPrivate(reg)
-    , service(service_)
-    , path(path_)
-    , defunct(false)
+    , handle(handle_)
+    , defunct(0)
     , actionsFetched(false)
+    , prefetched(false)
 {
     //qDebug() << Q_FUNC_INFO;
 }
@@ -25,25 +25,50 @@ AccessibleObjectPrivate::~AccessibleObjectPrivate()
 {
     //qDebug() << Q_FUNC_INFO;
 
-    if (registryPrivate->m_cache) {
-        const QString id = path + service;
-        registryPrivate->m_cache->remove(id);
-    }
+    // another thread may have cached a new object for the handle meanwhile, that one stays
+    if (registryPrivate->m_cache)
+        registryPrivate->m_cache->remove(handle, this);
+    if (prefetched)
+        registryPrivate->removePrefetchedObject(handle);
+}
+
+QString AccessibleObjectPrivate::service() const
+{
+    return registryPrivate->m_identities.service(handle);
+}
+
+QString AccessibleObjectPrivate::path() const
+{
+    return registryPrivate->m_identities.path(handle);
 }
 
 bool AccessibleObjectPrivate::operator==(const AccessibleObjectPrivate &other) const
 {
     return registryPrivate == other.registryPrivate &&
-            service == other.service &&
-            path == other.path;
+            handle == other.handle;
 }
 
 void AccessibleObjectPrivate::setDefunct()
 {
-    defunct = true;
+    defunct.storeRelease(1);
 
+    QMutexLocker lock(&mutex);
     for(int i = 0; i < actions.count(); ++i) {
         const QSharedPointer<QAction> &action = actions[i];
         action->setEnabled(false);
     }
 }
+
+QVector< QSharedPointer<QAction> > AccessibleObjectPrivate::publishActions(const QVector< QSharedPointer<QAction> > &fetched)
+{
+    QMutexLocker lock(&mutex);
+    if (!actionsFetched) {
+        actionsFetched = true;
+        actions = fetched;
+        if (defunct.loadAcquire()) {
+            for (const QSharedPointer<QAction> &action : std::as_const(actions))
+                action->setEnabled(false);
+        }
+    }
+    return actions;
+}
@@ -8,9 +8,15 @@
 #define QACCESSIBILITYCLIENT_ACCESSIBLEOBJECT_P_H
 
 #include <QString>
+#include <QHash>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QVariantMap>
 #include <QSharedPointer>
 #include <QAction>
 
+#include "identitytable_p.h"
+
 namespace QAccessibleClient {
 
 class RegistryPrivate;
@@ -18,20 +24,33 @@ class RegistryPrivate;
 class AccessibleObjectPrivate
 {
 public:
-    AccessibleObjectPrivate(RegistryPrivate *reg, const QString &service_, const QString &path_);
+    AccessibleObjectPrivate(RegistryPrivate *reg, ObjectHandle handle_);
     ~AccessibleObjectPrivate();
 
+    // Service and path live in the identity table of the registry, shared by all objects.
+    QString service() const;
+    QString path() const;
+
     RegistryPrivate *registryPrivate;
-    QString service;
-    QString path;
+    ObjectHandle handle;
 
-    bool defunct;
+    // Objects are shared by all threads using the registry, the members below are guarded.
+    QAtomicInt defunct;
+    // actions and actionsFetched are guarded by mutex
     mutable QVector< QSharedPointer<QAction> > actions;
     mutable bool actionsFetched;
 
+    // Values fetched by AccessibleObject::prefetch(), per D-Bus interface name, guarded by mutex.
+    QHash<QString, QVariantMap> prefetchedProperties;
+    // whether the registry lists the object among the prefetched ones, guarded by mutex
+    bool prefetched;
+    mutable QMutex mutex;
+
     bool operator==(const AccessibleObjectPrivate &other) const;
 
     void setDefunct();
+    // Stores fetched actions unless another fetch was first, returns the ones stored.
+    QVector< QSharedPointer<QAction> > publishActions(const QVector< QSharedPointer<QAction> > &fetched);
 
 private:
     Q_DISABLE_COPY(AccessibleObjectPrivate)
@@ -8,87 +8,604 @@
 #define QACCESSIBILITYCLIENT_CACHESTRATEGY_P_H
 
 #include "accessibleobject.h"
+#include "accessibleobject_p.h"
+#include "atspi/qt-atspi.h"
+#include "identitytable_p.h"
+#include "registry.h"
 
+#include <QMutex>
 #include <QPair>
+#include <QSet>
+
+#include <array>
+#include <list>
+#include <optional>
 
 namespace QAccessibleClient {
 
+/*
+    The caches may be used from several threads at once, each
+    implementation does its own locking.
+*/
 class ObjectCache
 {
 public:
-    virtual QStringList ids() const = 0;
-    virtual QSharedPointer<AccessibleObjectPrivate> get(const QString &id) const = 0;
-    virtual void add(const QString &id, const QSharedPointer<AccessibleObjectPrivate> &objectPrivate) = 0;
-    virtual bool remove(const QString &id) = 0;
+    virtual QList<ObjectHandle> handles() const = 0;
+    virtual QSharedPointer<AccessibleObjectPrivate> get(ObjectHandle handle) const = 0;
+    // Caches \a objectPrivate unless another thread cached a live object for \a handle first, returns the object that is cached.
+    virtual QSharedPointer<AccessibleObjectPrivate> add(ObjectHandle handle, const QSharedPointer<AccessibleObjectPrivate> &objectPrivate) = 0;
+    // Removes what is cached for \a handle, only if it belongs to \a object unless that is null.
+    virtual bool remove(ObjectHandle handle, const AccessibleObjectPrivate *object = nullptr) = 0;
     virtual void clear() = 0;
     virtual AccessibleObject::Interfaces interfaces(const AccessibleObject &object) = 0;
     virtual void setInterfaces(const AccessibleObject &object, AccessibleObject::Interfaces interfaces) = 0;
     virtual quint64 state(const AccessibleObject &object) = 0;
     virtual void setState(const AccessibleObject &object, quint64 state) = 0;
     virtual void cleanState(const AccessibleObject &object) = 0;
+    virtual std::optional<QString> name(const AccessibleObject &object) = 0;
+    virtual void setName(const AccessibleObject &object, const QString &name) = 0;
+    virtual std::optional<QString> description(const AccessibleObject &object) = 0;
+    virtual void setDescription(const AccessibleObject &object, const QString &description) = 0;
+    virtual std::optional<AccessibleObject::Role> role(const AccessibleObject &object) = 0;
+    virtual void setRole(const AccessibleObject &object, AccessibleObject::Role role) = 0;
+    virtual std::optional<QSpiObjectReference> parent(const AccessibleObject &object) = 0;
+    virtual void setParent(const AccessibleObject &object, const QSpiObjectReference &parent) = 0;
+    virtual std::optional<QSpiObjectReferenceList> children(const AccessibleObject &object) = 0;
+    virtual void setChildren(const AccessibleObject &object, const QSpiObjectReferenceList &children) = 0;
+    virtual std::optional<int> childCount(const AccessibleObject &object) = 0;
+    virtual void setChildCount(const AccessibleObject &object, int childCount) = 0;
+    virtual void cleanName(const AccessibleObject &object) = 0;
+    virtual void cleanDescription(const AccessibleObject &object) = 0;
+    virtual void cleanRole(const AccessibleObject &object) = 0;
+    virtual void cleanParent(const AccessibleObject &object) = 0;
+    virtual void cleanChildren(const AccessibleObject &object) = 0;
+    // Drops the cached properties of all objects but the ones of the services in \a keptServices.
+    virtual void clearProperties(const QSet<quint32> &keptServices) = 0;
+    // Counters of all lookups since creation or resetStatistics(), plus the current size.
+    virtual Registry::CacheStatistics statistics() const = 0;
+    virtual void resetStatistics() = 0;
     virtual ~ObjectCache() {}
     static const quint64 StateNotFound = ~0;
+
+protected:
+    template<typename T>
+    static std::optional<T> counted(Registry::CacheCounters &counters, const std::optional<T> &value)
+    {
+        if (value)
+            ++counters.hits;
+        else
+            ++counters.misses;
+        return value;
+    }
+
+    static void addCounters(Registry::CacheCounters &total, const Registry::CacheCounters &counters)
+    {
+        total.hits += counters.hits;
+        total.misses += counters.misses;
+    }
+
+    static void addStatistics(Registry::CacheStatistics &total, const Registry::CacheStatistics &statistics)
+    {
+        addCounters(total.objects, statistics.objects);
+        addCounters(total.names, statistics.names);
+        addCounters(total.descriptions, statistics.descriptions);
+        addCounters(total.roles, statistics.roles);
+        addCounters(total.parents, statistics.parents);
+        addCounters(total.children, statistics.children);
+        addCounters(total.childCounts, statistics.childCounts);
+        addCounters(total.interfaces, statistics.interfaces);
+        addCounters(total.states, statistics.states);
+        total.insertions += statistics.insertions;
+        total.evictions += statistics.evictions;
+        total.invalidations += statistics.invalidations;
+        total.objectCount += statistics.objectCount;
+        total.approximateBytes += statistics.approximateBytes;
+    }
 };
 
+/*
+    Caches objects as long as someone holds them.
+
+    The entries are spread over ShardCount shards by handle, each with a
+    lock of its own, so threads walking different objects rarely wait
+    for each other. All values of one object live in the same shard.
+*/
 class CacheWeakStrategy : public ObjectCache
 {
 public:
-    QStringList ids() const override
+    QList<ObjectHandle> handles() const override
     {
-        return accessibleObjectsHash.keys();
+        QList<ObjectHandle> handles;
+        for (const Shard &shard : m_shards) {
+            QMutexLocker lock(&shard.mutex);
+            handles += shard.objects.keys();
+        }
+        return handles;
     }
-    QSharedPointer<AccessibleObjectPrivate> get(const QString &id) const override
+    QSharedPointer<AccessibleObjectPrivate> get(ObjectHandle handle) const override
     {
-        return accessibleObjectsHash[id].first;
+        Shard &shard = shardOf(handle);
+        QMutexLocker lock(&shard.mutex);
+        const QSharedPointer<AccessibleObjectPrivate> object = shard.objects.value(handle).first.toStrongRef();
+        if (object)
+            ++shard.statistics.objects.hits;
+        else
+            ++shard.statistics.objects.misses;
+        return object;
     }
-    void add(const QString &id, const QSharedPointer<AccessibleObjectPrivate> &objectPrivate) override
+    QSharedPointer<AccessibleObjectPrivate> add(ObjectHandle handle, const QSharedPointer<AccessibleObjectPrivate> &objectPrivate) override
     {
-        accessibleObjectsHash[id] = QPair<QWeakPointer<AccessibleObjectPrivate>, AccessibleObjectPrivate*>(objectPrivate, objectPrivate.data());
+        Shard &shard = shardOf(handle);
+        QMutexLocker lock(&shard.mutex);
+        CachedObject &entry = shard.objects[handle];
+        if (const QSharedPointer<AccessibleObjectPrivate> cached = entry.first.toStrongRef())
+            return cached;
+        // an object that died but did not get to remove itself yet leaves its values behind
+        if (entry.second)
+            removeValues(shard, entry.second);
+        ++shard.statistics.insertions;
+        entry = CachedObject(objectPrivate, objectPrivate.data());
+        return objectPrivate;
     }
-    bool remove(const QString &id) override
+    bool remove(ObjectHandle handle, const AccessibleObjectPrivate *object = nullptr) override
     {
-        QPair<QWeakPointer<AccessibleObjectPrivate>, AccessibleObjectPrivate*> data = accessibleObjectsHash.take(id);
-        return (interfaceHash.remove(data.second) >= 1) || (stateHash.remove(data.second) >= 1);
+        Shard &shard = shardOf(handle);
+        QMutexLocker lock(&shard.mutex);
+        AccessibleObjectPrivate *key = const_cast<AccessibleObjectPrivate*>(object);
+        const auto it = shard.objects.find(handle);
+        if (it != shard.objects.end() && (!object || it->second == object)) {
+            key = it->second;
+            shard.objects.erase(it);
+        }
+        return key && removeValues(shard, key);
     }
     void clear() override
     {
-        accessibleObjectsHash.clear();
-        stateHash.clear();
-        interfaceHash.clear();
+        for (Shard &shard : m_shards) {
+            QMutexLocker lock(&shard.mutex);
+            shard.objects.clear();
+            shard.states.clear();
+            shard.interfaces.clear();
+            shard.properties.clear();
+        }
     }
     AccessibleObject::Interfaces interfaces(const AccessibleObject &object) override
     {
-        if (!interfaceHash.contains(object.d.data()))
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        const auto it = shard.interfaces.constFind(object.d.data());
+        if (it == shard.interfaces.constEnd()) {
+            ++shard.statistics.interfaces.misses;
             return AccessibleObject::InvalidInterface;
-        return interfaceHash.value(object.d.data());
+        }
+        ++shard.statistics.interfaces.hits;
+        return it.value();
     }
     void setInterfaces(const AccessibleObject &object, AccessibleObject::Interfaces interfaces) override
     {
-        interfaceHash.insert(object.d.data(), interfaces);
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        ++shard.statistics.insertions;
+        shard.interfaces.insert(object.d.data(), interfaces);
     }
     quint64 state(const AccessibleObject &object) override
     {
-        if (!stateHash.contains(object.d.data()))
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        const auto it = shard.states.constFind(object.d.data());
+        if (it == shard.states.constEnd()) {
+            ++shard.statistics.states.misses;
             return ObjectCache::StateNotFound;
-
-        return stateHash.value(object.d.data());
+        }
+        ++shard.statistics.states.hits;
+        return it.value();
     }
     void setState(const AccessibleObject &object, quint64 state) override
     {
-        stateHash[object.d.data()] = state;
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        ++shard.statistics.insertions;
+        shard.states[object.d.data()] = state;
     }
     void cleanState(const AccessibleObject &object) override
     {
-        stateHash.remove(object.d.data());
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        if (shard.states.remove(object.d.data()))
+            ++shard.statistics.invalidations;
+    }
+    std::optional<QString> name(const AccessibleObject &object) override
+    {
+        return property(object, &CachedProperties::name, &Registry::CacheStatistics::names);
+    }
+    void setName(const AccessibleObject &object, const QString &name) override
+    {
+        setProperty(object, &CachedProperties::name, name);
+    }
+    std::optional<QString> description(const AccessibleObject &object) override
+    {
+        return property(object, &CachedProperties::description, &Registry::CacheStatistics::descriptions);
+    }
+    void setDescription(const AccessibleObject &object, const QString &description) override
+    {
+        setProperty(object, &CachedProperties::description, description);
+    }
+    std::optional<AccessibleObject::Role> role(const AccessibleObject &object) override
+    {
+        return property(object, &CachedProperties::role, &Registry::CacheStatistics::roles);
+    }
+    void setRole(const AccessibleObject &object, AccessibleObject::Role role) override
+    {
+        setProperty(object, &CachedProperties::role, role);
+    }
+    std::optional<QSpiObjectReference> parent(const AccessibleObject &object) override
+    {
+        return property(object, &CachedProperties::parent, &Registry::CacheStatistics::parents);
+    }
+    void setParent(const AccessibleObject &object, const QSpiObjectReference &parent) override
+    {
+        setProperty(object, &CachedProperties::parent, parent);
+    }
+    std::optional<QSpiObjectReferenceList> children(const AccessibleObject &object) override
+    {
+        return property(object, &CachedProperties::children, &Registry::CacheStatistics::children);
+    }
+    void setChildren(const AccessibleObject &object, const QSpiObjectReferenceList &children) override
+    {
+        setProperty(object, &CachedProperties::children, children);
+    }
+    std::optional<int> childCount(const AccessibleObject &object) override
+    {
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        const CachedProperties properties = shard.properties.value(object.d.data());
+        if (properties.children)
+            return counted(shard.statistics.childCounts, std::optional<int>(int(properties.children->size())));
+        return counted(shard.statistics.childCounts, properties.childCount);
+    }
+    void setChildCount(const AccessibleObject &object, int childCount) override
+    {
+        setProperty(object, &CachedProperties::childCount, childCount);
+    }
+    void cleanName(const AccessibleObject &object) override
+    {
+        cleanProperty(object, &CachedProperties::name);
+    }
+    void cleanDescription(const AccessibleObject &object) override
+    {
+        cleanProperty(object, &CachedProperties::description);
+    }
+    void cleanRole(const AccessibleObject &object) override
+    {
+        cleanProperty(object, &CachedProperties::role);
+    }
+    void cleanParent(const AccessibleObject &object) override
+    {
+        cleanProperty(object, &CachedProperties::parent);
+    }
+    void cleanChildren(const AccessibleObject &object) override
+    {
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        const auto it = shard.properties.find(object.d.data());
+        if (it != shard.properties.end() && (it->children || it->childCount)) {
+            it->children.reset();
+            it->childCount.reset();
+            ++shard.statistics.invalidations;
+        }
+    }
+    void clearProperties(const QSet<quint32> &keptServices) override
+    {
+        for (Shard &shard : m_shards) {
+            QMutexLocker lock(&shard.mutex);
+            if (keptServices.isEmpty()) {
+                shard.statistics.invalidations += shard.properties.size();
+                shard.properties.clear();
+                continue;
+            }
+            for (auto it = shard.properties.begin(); it != shard.properties.end();) {
+                if (keptServices.contains(IdentityTable::serviceKey(it.key()->handle))) {
+                    ++it;
+                } else {
+                    ++shard.statistics.invalidations;
+                    it = shard.properties.erase(it);
+                }
+            }
+        }
+    }
+    Registry::CacheStatistics statistics() const override
+    {
+        Registry::CacheStatistics statistics;
+        for (const Shard &shard : m_shards) {
+            QMutexLocker lock(&shard.mutex);
+            addStatistics(statistics, shard.statistics);
+            statistics.objectCount += int(shard.objects.size());
+            for (const auto &entry : shard.objects)
+                statistics.approximateBytes += sizeof(ObjectHandle) + sizeof(entry) + cachedSize(shard, entry.second);
+            statistics.approximateBytes += (shard.interfaces.size() + shard.states.size()) * (sizeof(AccessibleObjectPrivate*) + sizeof(quint64));
+        }
+        return statistics;
+    }
+    void resetStatistics() override
+    {
+        for (Shard &shard : m_shards) {
+            QMutexLocker lock(&shard.mutex);
+            shard.statistics = Registry::CacheStatistics();
+        }
+    }
+
+protected:
+    // Rough memory use of an object and the values cached for it, in bytes.
+    qint64 cachedSize(AccessibleObjectPrivate *object) const
+    {
+        const Shard &shard = shardOf(object->handle);
+        QMutexLocker lock(&shard.mutex);
+        return cachedSize(shard, object);
     }
 
 private:
-    QHash<QString, QPair<QWeakPointer<AccessibleObjectPrivate>, AccessibleObjectPrivate*> > accessibleObjectsHash;
-    QHash<AccessibleObjectPrivate*, AccessibleObject::Interfaces> interfaceHash;
-    QHash<AccessibleObjectPrivate*, qint64> stateHash;
+    static constexpr int ShardCount = 16;
+
+    struct CachedProperties
+    {
+        std::optional<QString> name;
+        std::optional<QString> description;
+        std::optional<AccessibleObject::Role> role;
+        std::optional<QSpiObjectReference> parent;
+        std::optional<QSpiObjectReferenceList> children;
+        std::optional<int> childCount;
+    };
+    typedef QPair<QWeakPointer<AccessibleObjectPrivate>, AccessibleObjectPrivate*> CachedObject;
+
+    struct Shard
+    {
+        mutable QMutex mutex;
+        Registry::CacheStatistics statistics;
+        QHash<ObjectHandle, CachedObject> objects;
+        QHash<AccessibleObjectPrivate*, AccessibleObject::Interfaces> interfaces;
+        QHash<AccessibleObjectPrivate*, qint64> states;
+        QHash<AccessibleObjectPrivate*, CachedProperties> properties;
+    };
+
+    Shard &shardOf(ObjectHandle handle) const
+    {
+        // the service is in the upper half, the path in the lower one
+        return m_shards[quint32(handle ^ (handle >> 32)) % ShardCount];
+    }
+    Shard &shardOf(const AccessibleObject &object) const
+    {
+        return shardOf(object.d->handle);
+    }
+
+    // The shard needs to be locked for the functions below.
+    static bool removeValues(Shard &shard, AccessibleObjectPrivate *object)
+    {
+        const bool hadInterfaces = shard.interfaces.remove(object);
+        const bool hadState = shard.states.remove(object);
+        const bool hadProperties = shard.properties.remove(object);
+        return hadInterfaces || hadState || hadProperties;
+    }
+    static qint64 cachedSize(const Shard &shard, AccessibleObjectPrivate *object)
+    {
+        qint64 size = sizeof(AccessibleObjectPrivate) + sizeof(CachedProperties);
+        const auto it = shard.properties.constFind(object);
+        if (it == shard.properties.constEnd())
+            return size;
+        if (it->name)
+            size += it->name->size() * sizeof(QChar);
+        if (it->description)
+            size += it->description->size() * sizeof(QChar);
+        if (it->children) {
+            for (const QSpiObjectReference &child : *it->children)
+                size += sizeof(QSpiObjectReference) + (child.service.size() + child.path.path().size()) * sizeof(QChar);
+        }
+        return size;
+    }
+
+    template<typename T>
+    std::optional<T> property(const AccessibleObject &object, std::optional<T> CachedProperties::*value,
+                              Registry::CacheCounters Registry::CacheStatistics::*counters)
+    {
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        const auto it = shard.properties.constFind(object.d.data());
+        return counted(shard.statistics.*counters, it == shard.properties.constEnd() ? std::optional<T>() : (*it).*value);
+    }
+    template<typename T>
+    void setProperty(const AccessibleObject &object, std::optional<T> CachedProperties::*value, const T &newValue)
+    {
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        ++shard.statistics.insertions;
+        shard.properties[object.d.data()].*value = newValue;
+    }
+    template<typename T>
+    void cleanProperty(const AccessibleObject &object, std::optional<T> CachedProperties::*value)
+    {
+        Shard &shard = shardOf(object);
+        QMutexLocker lock(&shard.mutex);
+        const auto it = shard.properties.find(object.d.data());
+        if (it != shard.properties.end() && (*it).*value) {
+            ((*it).*value).reset();
+            ++shard.statistics.invalidations;
+        }
+    }
+
+    mutable std::array<Shard, ShardCount> m_shards;
 };
 
+
+/*
+    Holds strong references to the most recently used objects, so walking
+    the same tree again finds the objects including their cached values
+    instead of creating and querying them anew.
+
+    Once more than maxObjects objects are held or their cachedSize() adds
+    up to more than maxBytes, the least recently used ones are released.
+    Released objects stay cached as long as someone else holds them, just
+    like in the weak cache. A limit of 0 disables that limit.
+
+    The order of use is shared by all objects and guarded by one lock,
+    taken before the lock of a shard. It is recursive as releasing an
+    object calls remove() from its destructor.
+*/
+class CacheStrongLruStrategy : public CacheWeakStrategy
+{
+public:
+    CacheStrongLruStrategy(int maxObjects, qint64 maxBytes)
+        : m_maxObjects(maxObjects)
+        , m_maxBytes(maxBytes)
+    {
+    }
+
+    void setLimits(int maxObjects, qint64 maxBytes)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_maxObjects = maxObjects;
+        m_maxBytes = maxBytes;
+        evict();
+    }
+    int maxObjects() const { QMutexLocker lock(&m_mutex); return m_maxObjects; }
+    qint64 maxBytes() const { QMutexLocker lock(&m_mutex); return m_maxBytes; }
+    int objectCount() const { QMutexLocker lock(&m_mutex); return int(m_entries.size()); }
+    qint64 bytes() const { QMutexLocker lock(&m_mutex); return m_bytes; }
+    quint64 hits() const { return statistics().objects.hits; }
+    quint64 misses() const { return statistics().objects.misses; }
+    quint64 evictions() const { QMutexLocker lock(&m_mutex); return m_statistics.evictions; }
+
+    QSharedPointer<AccessibleObjectPrivate> get(ObjectHandle handle) const override
+    {
+        CacheStrongLruStrategy *self = const_cast<CacheStrongLruStrategy*>(this);
+        QMutexLocker lock(&m_mutex);
+        const auto entry = self->m_entries.find(handle);
+        if (entry != self->m_entries.end()) {
+            ++m_statistics.objects.hits;
+            self->m_order.splice(self->m_order.end(), self->m_order, entry->position);
+            return entry->object;
+        }
+        // released earlier but still alive somewhere else, counted by the weak cache
+        const QSharedPointer<AccessibleObjectPrivate> object = CacheWeakStrategy::get(handle);
+        if (object)
+            self->retain(handle, object);
+        return object;
+    }
+    QSharedPointer<AccessibleObjectPrivate> add(ObjectHandle handle, const QSharedPointer<AccessibleObjectPrivate> &objectPrivate) override
+    {
+        QMutexLocker lock(&m_mutex);
+        const QSharedPointer<AccessibleObjectPrivate> object = CacheWeakStrategy::add(handle, objectPrivate);
+        retain(handle, object);
+        return object;
+    }
+    bool remove(ObjectHandle handle, const AccessibleObjectPrivate *object = nullptr) override
+    {
+        QMutexLocker lock(&m_mutex);
+        // the destructor of the released object calls remove() again, it finds nothing then
+        const QSharedPointer<AccessibleObjectPrivate> released = release(handle, object);
+        return CacheWeakStrategy::remove(handle, object);
+    }
+    void clear() override
+    {
+        QHash<ObjectHandle, Entry> entries;
+        QMutexLocker lock(&m_mutex);
+        entries.swap(m_entries);
+        m_order.clear();
+        m_bytes = 0;
+        CacheWeakStrategy::clear();
+    }
+    void setName(const AccessibleObject &object, const QString &name) override
+    {
+        QMutexLocker lock(&m_mutex);
+        CacheWeakStrategy::setName(object, name);
+        updateSize(object);
+    }
+    void setDescription(const AccessibleObject &object, const QString &description) override
+    {
+        QMutexLocker lock(&m_mutex);
+        CacheWeakStrategy::setDescription(object, description);
+        updateSize(object);
+    }
+    void setChildren(const AccessibleObject &object, const QSpiObjectReferenceList &children) override
+    {
+        QMutexLocker lock(&m_mutex);
+        CacheWeakStrategy::setChildren(object, children);
+        updateSize(object);
+    }
+    Registry::CacheStatistics statistics() const override
+    {
+        // strongly held objects are counted by the weak cache, add the bookkeeping of the order
+        QMutexLocker lock(&m_mutex);
+        Registry::CacheStatistics statistics = CacheWeakStrategy::statistics();
+        addStatistics(statistics, m_statistics);
+        statistics.approximateBytes += m_entries.size() * (sizeof(ObjectHandle) + sizeof(Entry) + 3 * sizeof(void*));
+        return statistics;
+    }
+    void resetStatistics() override
+    {
+        QMutexLocker lock(&m_mutex);
+        CacheWeakStrategy::resetStatistics();
+        m_statistics = Registry::CacheStatistics();
+    }
+
+private:
+    struct Entry
+    {
+        QSharedPointer<AccessibleObjectPrivate> object;
+        std::list<ObjectHandle>::iterator position;
+        qint64 size;
+    };
+
+    // The functions below expect the caller to hold m_mutex.
+    void retain(ObjectHandle handle, const QSharedPointer<AccessibleObjectPrivate> &object)
+    {
+        if (m_entries.contains(handle))
+            return;
+        m_order.push_back(handle);
+        const qint64 size = cachedSize(object.data());
+        m_entries.insert(handle, Entry{object, std::prev(m_order.end()), size});
+        m_bytes += size;
+        evict();
+    }
+    QSharedPointer<AccessibleObjectPrivate> release(ObjectHandle handle, const AccessibleObjectPrivate *object = nullptr)
+    {
+        const auto entry = m_entries.find(handle);
+        if (entry == m_entries.end() || (object && entry->object.data() != object))
+            return QSharedPointer<AccessibleObjectPrivate>();
+        const QSharedPointer<AccessibleObjectPrivate> released = entry->object;
+        m_order.erase(entry->position);
+        m_bytes -= entry->size;
+        m_entries.erase(entry);
+        return released;
+    }
+    void updateSize(const AccessibleObject &object)
+    {
+        const auto entry = m_entries.find(object.d->handle);
+        if (entry == m_entries.end())
+            return;
+        const qint64 size = cachedSize(object.d.data());
+        m_bytes += size - entry->size;
+        entry->size = size;
+        evict();
+    }
+    void evict()
+    {
+        // objects only die once the loop is done, their destructors call remove()
+        QList<QSharedPointer<AccessibleObjectPrivate> > released;
+        while (!m_order.empty()
+               && ((m_maxObjects > 0 && m_entries.size() > m_maxObjects) || (m_maxBytes > 0 && m_bytes > m_maxBytes))) {
+            released.append(release(m_order.front()));
+            ++m_statistics.evictions;
+        }
+    }
+
+    mutable QRecursiveMutex m_mutex;
+    // the lookups of strongly held objects and the evictions, the weak cache counts the rest
+    mutable Registry::CacheStatistics m_statistics;
+    int m_maxObjects;
+    qint64 m_maxBytes;
+    qint64 m_bytes = 0;
+    QHash<ObjectHandle, Entry> m_entries;
+    std::list<ObjectHandle> m_order;
+};
 }
 
 #endif
-
@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "crawler_p.h"
+#include "registry_p.h"
+
+using namespace QAccessibleClient;
+
+Crawler::Crawler(RegistryPrivate *registry, const Registry::CrawlOptions &options,
+                 const std::function<void(const Registry::CrawledObject &)> &visitor)
+    : m_registry(registry)
+    , m_options(options)
+    , m_visitor(visitor)
+{
+    m_promise.start();
+}
+
+QFuture<int> Crawler::future()
+{
+    return m_promise.future();
+}
+
+void Crawler::start()
+{
+    // the registry deletes crawlers still running when it goes away, the future is canceled then
+    setParent(m_registry);
+    m_started = true;
+
+    if (!m_options.applications.isEmpty()) {
+        for (const AccessibleObject &application : m_options.applications)
+            enqueue(Node{application, AccessibleObject(), 0});
+        pump();
+        return;
+    }
+
+    ++m_inFlight;
+    m_registry->topLevelAccessiblesAsync().then(this, [this](const QList<AccessibleObject> &applications) {
+        --m_inFlight;
+        for (const AccessibleObject &application : applications)
+            enqueue(Node{application, AccessibleObject(), 0});
+        pump();
+    });
+}
+
+void Crawler::enqueue(const Node &node)
+{
+    if (!node.object.isValid())
+        return;
+    const ObjectHandle handle = RegistryPrivate::handleOf(node.object);
+    if (m_seen.contains(handle))
+        return;
+    m_seen.insert(handle);
+    m_services[RegistryPrivate::serviceOf(node.object)].queue.push_back(node);
+}
+
+void Crawler::pump()
+{
+    // replies served from the cache come back right away and pump again, the outer loop picks that up
+    if (m_pumping) {
+        m_pumpAgain = true;
+        return;
+    }
+    m_pumping = true;
+    do {
+        m_pumpAgain = false;
+        if (m_promise.isCanceled()) {
+            m_services.clear();
+            break;
+        }
+        // fetching may queue objects of services not seen yet, iterate over a copy of the keys
+        const QStringList services = m_services.keys();
+        for (const QString &service : services) {
+            while (!m_promise.isCanceled()) {
+                Service &queue = m_services[service];
+                if (queue.queue.empty() || queue.inFlight >= qMax(1, m_options.maxRequestsPerService))
+                    break;
+                const Node node = queue.queue.front();
+                queue.queue.pop_front();
+                ++queue.inFlight;
+                ++m_inFlight;
+                fetch(service, node);
+            }
+        }
+    } while (m_pumpAgain);
+    m_pumping = false;
+    finishIfDone();
+}
+
+void Crawler::fetch(const QString &service, const Node &node)
+{
+    m_registry->roleAsync(node.object).then(this, [this, service, node](AccessibleObject::Role role) {
+        if (m_promise.isCanceled()) {
+            requestFinished(service);
+            return;
+        }
+        ++m_visited;
+        if (m_visitor)
+            m_visitor(Registry::CrawledObject{node.object, node.parent, role, node.depth});
+
+        const bool descend = (m_options.maxDepth < 0 || node.depth < m_options.maxDepth)
+                && !m_options.prunedRoles.contains(role);
+        if (!descend || m_promise.isCanceled()) {
+            requestFinished(service);
+            return;
+        }
+        m_registry->childrenAsync(node.object).then(this, [this, service, node](const QList<AccessibleObject> &children) {
+            if (!m_promise.isCanceled()) {
+                for (const AccessibleObject &child : children)
+                    enqueue(Node{child, node.object, node.depth + 1});
+            }
+            requestFinished(service);
+        });
+    });
+}
+
+void Crawler::requestFinished(const QString &service)
+{
+    const auto it = m_services.find(service);
+    if (it != m_services.end())
+        --it->inFlight;
+    --m_inFlight;
+    pump();
+}
+
+void Crawler::finishIfDone()
+{
+    if (m_finished || !m_started || m_inFlight > 0)
+        return;
+    if (!m_promise.isCanceled()) {
+        for (const Service &service : std::as_const(m_services)) {
+            if (!service.queue.empty())
+                return;
+        }
+    }
+
+    m_finished = true;
+    m_promise.addResult(m_visited);
+    m_promise.finish();
+    deleteLater();
+}
+
+#include "moc_crawler_p.cpp"
@@ -0,0 +1,86 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef QACCESSIBILITYCLIENT_CRAWLER_P_H
+#define QACCESSIBILITYCLIENT_CRAWLER_P_H
+
+#include <QFuture>
+#include <QHash>
+#include <QObject>
+#include <QPromise>
+#include <QSet>
+
+#include <deque>
+#include <functional>
+
+#include "qaccessibilityclient/registry.h"
+#include "identitytable_p.h"
+
+namespace QAccessibleClient {
+
+class RegistryPrivate;
+
+/*
+    Walks the trees of several applications at once for Registry::crawl().
+
+    Every application is a D-Bus peer of its own, so the crawler keeps
+    requests to all of them in flight at the same time and only limits
+    the requests per service. Each object found is queued with the
+    service it lives in; whenever a request finishes the queues are
+    pumped again. For an object its role is asked for first, it is
+    handed to the visitor and then its children are queued unless the
+    depth limit is reached or the role is pruned.
+
+    The crawler lives in the thread of the registry and deletes itself
+    once all requests came back or the future was canceled.
+*/
+class Crawler : public QObject
+{
+    Q_OBJECT
+public:
+    Crawler(RegistryPrivate *registry, const Registry::CrawlOptions &options,
+            const std::function<void(const Registry::CrawledObject &)> &visitor);
+
+    QFuture<int> future();
+    // To be called in the thread of the registry.
+    void start();
+
+private:
+    struct Node {
+        AccessibleObject object;
+        AccessibleObject parent;
+        int depth;
+    };
+    struct Service {
+        std::deque<Node> queue;
+        int inFlight = 0;
+    };
+
+    void enqueue(const Node &node);
+    void pump();
+    void fetch(const QString &service, const Node &node);
+    void requestFinished(const QString &service);
+    void finishIfDone();
+
+    RegistryPrivate *const m_registry;
+    const Registry::CrawlOptions m_options;
+    const std::function<void(const Registry::CrawledObject &)> m_visitor;
+    QPromise<int> m_promise;
+    QHash<QString, Service> m_services;
+    // handles of the objects already queued, trees with cycles are only walked once;
+    // without a cache every reference is a new object, they compare by handle only
+    QSet<ObjectHandle> m_seen;
+    int m_inFlight = 0;
+    int m_visited = 0;
+    bool m_started = false;
+    bool m_pumping = false;
+    bool m_pumpAgain = false;
+    bool m_finished = false;
+};
+
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef QACCESSIBILITYCLIENT_EVENTNAMES_P_H
+#define QACCESSIBILITYCLIENT_EVENTNAMES_P_H
+
+#include <QLatin1String>
+#include <QStringView>
+
+#include <array>
+#include <iterator>
+
+#include "accessibleobject.h"
+
+namespace QAccessibleClient {
+
+/*
+    Maps the detail strings of AT-SPI events to enums.
+
+    Every event carries its detail as string, "focused" for a state
+    change or "accessible-name" for a property change. The tables
+    below hash a name into a slot that holds at most one candidate,
+    a lookup costs one hash and one string comparison no matter how
+    many names are known.
+
+    The hash is FNV-1a, the seed of each table is picked such that no
+    two names share a slot, which is verified at compile time. Adding
+    a name may require a new seed, any that satisfies the
+    static_assert will do.
+*/
+namespace EventNames {
+
+constexpr quint32 hash(const char *name, quint32 seed)
+{
+    quint32 h = 2166136261u ^ seed;
+    for (; *name; ++name) {
+        h ^= quint8(*name);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 16);
+}
+
+// The names are ASCII, anything else cannot match and only needs to land in some slot.
+inline quint32 hash(QStringView name, quint32 seed)
+{
+    quint32 h = 2166136261u ^ seed;
+    for (const QChar c : name) {
+        h ^= quint8(c.unicode());
+        h *= 16777619u;
+    }
+    return h ^ (h >> 16);
+}
+
+template<std::size_t Count, std::size_t Size>
+class PerfectHash
+{
+    static_assert((Size & (Size - 1)) == 0, "The table size must be a power of two");
+
+public:
+    constexpr PerfectHash(const char *const (&names)[Count], quint32 seed)
+        : m_names(names)
+        , m_seed(seed)
+    {
+        for (auto &slot : m_slots)
+            slot = -1;
+        for (std::size_t i = 0; i < Count; ++i) {
+            auto &slot = m_slots[hash(names[i], seed) & (Size - 1)];
+            if (slot != -1)
+                m_perfect = false;
+            slot = qint16(i);
+        }
+    }
+
+    constexpr bool isPerfect() const
+    {
+        return m_perfect;
+    }
+
+    // The index of \a name in the names the table was built from, -1 if it is none of them.
+    int indexOf(QStringView name) const
+    {
+        const int index = m_slots[hash(name, m_seed) & (Size - 1)];
+        if (index < 0 || name != QLatin1String(m_names[index]))
+            return -1;
+        return index;
+    }
+
+private:
+    const char *const *m_names;
+    quint32 m_seed;
+    std::array<qint16, Size> m_slots = {};
+    bool m_perfect = true;
+};
+
+// In the order of AtspiStateType, the index plus one is the AccessibleObject::State.
+constexpr const char *StateNames[] = {
+    "active", "armed", "busy", "checked", "collapsed", "defunct", "editable", "enabled",
+    "expandable", "expanded", "focusable", "focused", "has-tooltip", "horizontal", "iconified", "modal",
+    "multi-line", "multiselectable", "opaque", "pressed", "resizable", "selectable", "selected", "sensitive",
+    "showing", "single-line", "stale", "transient", "vertical", "visible", "manages-descendants", "indeterminate",
+    "required", "truncated", "animated", "invalid-entry", "supports-autocompletion", "selectable-text", "is-default", "visited",
+};
+static_assert(std::size(StateNames) == std::size_t(AccessibleObject::VisitedState), "Every state needs a name");
+
+constexpr PerfectHash<std::size(StateNames), 128> StateTable(StateNames, 995);
+static_assert(StateTable.isPerfect(), "State names collide, pick another seed");
+
+// Returns 0 for names that are not a state.
+inline int state(QStringView name)
+{
+    return StateTable.indexOf(name) + 1;
+}
+
+inline QLatin1String stateName(AccessibleObject::State state)
+{
+    return QLatin1String(StateNames[state - 1]);
+}
+
+/*
+    The details of ChildrenChanged, TextChanged and PropertyChange
+    events, the values index DetailNames.
+*/
+enum Detail {
+    UnknownDetail = -1,
+    AddDetail,
+    RemoveDetail,
+    InsertDetail,
+    DeleteDetail,
+    AccessibleNameDetail,
+    AccessibleDescriptionDetail,
+    AccessibleRoleDetail,
+    AccessibleParentDetail,
+    AccessibleValueDetail,
+};
+
+constexpr const char *DetailNames[] = {
+    "add", "remove", "insert", "delete",
+    "accessible-name", "accessible-description", "accessible-role", "accessible-parent", "accessible-value",
+};
+static_assert(std::size(DetailNames) == std::size_t(AccessibleValueDetail + 1), "Every detail needs a name");
+
+constexpr PerfectHash<std::size(DetailNames), 16> DetailTable(DetailNames, 3);
+static_assert(DetailTable.isPerfect(), "Detail names collide, pick another seed");
+
+inline Detail detail(QStringView name)
+{
+    return Detail(DetailTable.indexOf(name));
+}
+
+}
+
+}
+
+#endif
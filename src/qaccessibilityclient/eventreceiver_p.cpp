@@ -0,0 +1,100 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "eventreceiver_p.h"
+
+#include <QDBusVariant>
+#include <QDeadlineTimer>
+
+using namespace QAccessibleClient;
+
+EventReceiver::EventReceiver(const QHash<std::pair<QString, QString>, int> &connections, int capacity)
+    : m_connections(connections)
+    , m_queue(capacity)
+{
+}
+
+void EventReceiver::receive(const QDBusMessage &message)
+{
+    const QVariantList arguments = message.arguments();
+    const int connection = m_connections.value(std::make_pair(message.interface(), message.member()), -1);
+    if (connection < 0 || arguments.size() < 4)
+        return;
+
+    EventRecord record;
+    record.connection = connection;
+    record.service = message.service();
+    record.path = message.path();
+    record.detail = arguments.at(0).toString();
+    record.detail1 = arguments.at(1).toInt();
+    record.detail2 = arguments.at(2).toInt();
+    record.any = qvariant_cast<QDBusVariant>(arguments.at(3)).variant();
+    record.timestamp = QDeadlineTimer::current().deadlineNSecs();
+
+    m_received.fetchAndAddRelaxed(1);
+    if (m_queue.push(std::move(record))) {
+        const int size = m_queue.size();
+        if (size > m_highWaterMark.loadRelaxed())
+            m_highWaterMark.storeRelaxed(size);
+    } else {
+        m_dropped.fetchAndAddRelaxed(1);
+        m_overflow.storeRelease(1);
+    }
+
+    // Ordered on both sides: the push has to be seen by a drain that cleared the flag before,
+    // otherwise this store and the load of the queue in pop() may pass each other.
+    if (!m_notified.fetchAndStoreOrdered(1))
+        Q_EMIT eventsAvailable();
+}
+
+bool EventReceiver::pop(EventRecord &record)
+{
+    return m_queue.pop(record);
+}
+
+void EventReceiver::resetNotification()
+{
+    m_notified.fetchAndStoreOrdered(0);
+}
+
+bool EventReceiver::takeOverflow()
+{
+    return m_overflow.fetchAndStoreAcquire(0);
+}
+
+int EventReceiver::capacity() const
+{
+    return m_queue.capacity();
+}
+
+int EventReceiver::pending() const
+{
+    return m_queue.size();
+}
+
+int EventReceiver::highWaterMark() const
+{
+    return m_highWaterMark.loadRelaxed();
+}
+
+quint64 EventReceiver::received() const
+{
+    return m_received.loadRelaxed();
+}
+
+quint64 EventReceiver::dropped() const
+{
+    return m_dropped.loadRelaxed();
+}
+
+void EventReceiver::resetStatistics()
+{
+    m_highWaterMark.storeRelaxed(0);
+    m_received.storeRelaxed(0);
+    m_dropped.storeRelaxed(0);
+}
+
+#include "moc_eventreceiver_p.cpp"
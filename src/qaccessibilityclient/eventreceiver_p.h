@@ -0,0 +1,84 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef QACCESSIBILITYCLIENT_EVENTRECEIVER_P_H
+#define QACCESSIBILITYCLIENT_EVENTRECEIVER_P_H
+
+#include <QAtomicInteger>
+#include <QDBusMessage>
+#include <QHash>
+#include <QObject>
+#include <QVariant>
+
+#include "spscqueue_p.h"
+
+namespace QAccessibleClient {
+
+/*
+    Receives the AT-SPI events on a thread of its own.
+
+    With Registry::setEventReceiverThread() the match rules of the events
+    are connected to receive() instead of the slots of RegistryPrivate,
+    so QtDBus delivers the signals to the thread of the receiver. There
+    the arguments are unpacked into an EventRecord, which is pushed into
+    a ring buffer the registry drains on its own thread.
+
+    eventsAvailable() is only emitted when the registry has not been told
+    about earlier events yet, a burst of events costs one queued signal.
+*/
+class EventReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    struct EventRecord
+    {
+        // index into RegistryPrivate::eventConnections()
+        int connection = -1;
+        QString service;
+        QString path;
+        QString detail;
+        int detail1 = 0;
+        int detail2 = 0;
+        QVariant any;
+        qint64 timestamp = 0;
+    };
+
+    // \a connections maps interface and member of a signal to its index in RegistryPrivate::eventConnections().
+    EventReceiver(const QHash<std::pair<QString, QString>, int> &connections, int capacity);
+
+    // Only for the thread of the registry.
+    bool pop(EventRecord &record);
+    // Clears the notification, events pushed afterwards are announced again.
+    void resetNotification();
+    // Returns whether events were dropped since the last call.
+    bool takeOverflow();
+
+    int capacity() const;
+    int pending() const;
+    int highWaterMark() const;
+    quint64 received() const;
+    quint64 dropped() const;
+    void resetStatistics();
+
+public Q_SLOTS:
+    void receive(const QDBusMessage &message);
+
+Q_SIGNALS:
+    void eventsAvailable();
+
+private:
+    const QHash<std::pair<QString, QString>, int> m_connections;
+    SpscQueue<EventRecord> m_queue;
+    QAtomicInt m_notified = 0;
+    QAtomicInt m_overflow = 0;
+    QAtomicInt m_highWaterMark = 0;
+    QAtomicInteger<quint64> m_received = 0;
+    QAtomicInteger<quint64> m_dropped = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,263 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef QACCESSIBILITYCLIENT_IDENTITYTABLE_P_H
+#define QACCESSIBILITYCLIENT_IDENTITYTABLE_P_H
+
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QString>
+
+#include <optional>
+
+namespace QAccessibleClient {
+
+/*
+    Identifies an accessible object by its service and path.
+
+    The upper 32 bit are the key of the service in the IdentityTable,
+    the lower 32 bit the key of the path. The value is unique per
+    registry and doubles as its own hash.
+*/
+typedef quint64 ObjectHandle;
+
+/*
+    Interns the service names and object paths of accessible objects.
+
+    Qt, GTK and Chromium name their objects /org/a11y/atspi/accessible/<n>,
+    the number of those paths is used as key directly. Any other path,
+    like the root or the null path every application has, is stored
+    once for all services and keyed by its index with the top bit set.
+    Each service counts as one user of the paths it interned. Looking
+    up the handle of a known object thus costs a hash lookup of the
+    service name and does not allocate.
+
+    AccessibleObjectPrivate only keeps the handle, every object of an
+    application shares the single copy of its service name kept here.
+    Once an application left the bus removeService() drops its name and
+    the paths no other service uses. Service keys are not reused, handles
+    of the gone application stay invalid even if the name shows up again.
+
+    The table may be used from several threads. Known names only take
+    the read lock, the write lock is needed the first time a service or
+    a path that is not numbered shows up.
+*/
+class IdentityTable
+{
+public:
+    ObjectHandle handle(const QString &service, const QString &path)
+    {
+        {
+            QReadLocker lock(&m_lock);
+            const auto serviceKey = m_serviceKeys.constFind(service);
+            if (serviceKey != m_serviceKeys.constEnd()) {
+                const std::optional<quint32> key = existingPathKey(*m_services.constFind(serviceKey.value()), path);
+                if (key)
+                    return (ObjectHandle(serviceKey.value()) << 32) | *key;
+            }
+        }
+        QWriteLocker lock(&m_lock);
+        const quint32 key = serviceKey(service);
+        return (ObjectHandle(key) << 32) | pathKey(m_services[key], path);
+    }
+
+    // The key of the service of \a handle, shared by all objects of an application.
+    static quint32 serviceKey(ObjectHandle handle)
+    {
+        return quint32(handle >> 32);
+    }
+
+    std::optional<quint32> findService(const QString &service) const
+    {
+        QReadLocker lock(&m_lock);
+        const auto it = m_serviceKeys.constFind(service);
+        if (it == m_serviceKeys.constEnd())
+            return std::nullopt;
+        return it.value();
+    }
+
+    // Forgets \a service and the paths interned only for it.
+    void removeService(const QString &service)
+    {
+        QWriteLocker lock(&m_lock);
+        const auto it = m_serviceKeys.constFind(service);
+        if (it == m_serviceKeys.constEnd())
+            return;
+        const auto entry = m_services.constFind(it.value());
+        for (const quint32 key : entry->pathKeys) {
+            Path &path = m_paths[int(key & ~InternedPath)];
+            if (--path.services > 0)
+                continue;
+            m_pathKeys.remove(path.path);
+            path.path.clear();
+            m_freePaths.append(key);
+        }
+        m_services.erase(entry);
+        m_serviceKeys.erase(it);
+    }
+
+    int serviceCount() const
+    {
+        QReadLocker lock(&m_lock);
+        return int(m_services.size());
+    }
+
+    // The number of paths that are not numbered, each is kept once for all services.
+    int internedPathCount() const
+    {
+        QReadLocker lock(&m_lock);
+        return int(m_pathKeys.size());
+    }
+
+    QString service(ObjectHandle handle) const
+    {
+        QReadLocker lock(&m_lock);
+        const auto it = m_services.constFind(serviceKey(handle));
+        return it != m_services.constEnd() ? it->name : QString();
+    }
+
+    QString path(ObjectHandle handle) const
+    {
+        const quint32 key = quint32(handle);
+        if (key & InternedPath) {
+            QReadLocker lock(&m_lock);
+            // the entry may serve another path once the service of the handle is gone
+            if (!m_services.contains(serviceKey(handle)))
+                return QString();
+            return m_paths.value(int(key & ~InternedPath)).path;
+        }
+        return QLatin1String(NumberedPathPrefix) + QString::number(key);
+    }
+
+    // Whether the handle names a real object, the null path of AT-SPI does not.
+    bool isValid(ObjectHandle handle) const
+    {
+        QReadLocker lock(&m_lock);
+        const auto it = m_services.constFind(serviceKey(handle));
+        if (it == m_services.constEnd() || it->name.isEmpty())
+            return false;
+        const quint32 key = quint32(handle);
+        if (!(key & InternedPath))
+            return true;
+        const QString path = m_paths.value(int(key & ~InternedPath)).path;
+        return !path.isEmpty() && path != QLatin1String("/org/a11y/atspi/null");
+    }
+
+    // The string AccessibleObject::id() returns, path followed by service.
+    QString id(ObjectHandle handle) const
+    {
+        return path(handle) + service(handle);
+    }
+
+    // Splits an id back into service and path, only known objects are found.
+    std::optional<ObjectHandle> find(const QString &id) const
+    {
+        QReadLocker lock(&m_lock);
+        for (auto it = m_services.constBegin(); it != m_services.constEnd(); ++it) {
+            if (!id.endsWith(it->name))
+                continue;
+            const std::optional<quint32> key = existingPathKey(it.value(), id.chopped(it->name.size()));
+            if (key)
+                return (ObjectHandle(it.key()) << 32) | *key;
+        }
+        return std::nullopt;
+    }
+
+private:
+    static constexpr quint32 InternedPath = 0x80000000u;
+    static constexpr const char NumberedPathPrefix[] = "/org/a11y/atspi/accessible/";
+
+    struct Service {
+        QString name;
+        // the keys of the interned paths of the service
+        QSet<quint32> pathKeys;
+    };
+    struct Path {
+        QString path;
+        // the number of services that interned the path
+        int services = 0;
+    };
+
+    // The functions below expect the caller to hold the lock.
+    quint32 serviceKey(const QString &service)
+    {
+        const auto it = m_serviceKeys.constFind(service);
+        if (it != m_serviceKeys.constEnd())
+            return it.value();
+        const quint32 key = m_nextServiceKey++;
+        m_services.insert(key, Service{service, {}});
+        m_serviceKeys.insert(service, key);
+        return key;
+    }
+
+    static std::optional<quint32> numberedPathKey(const QString &path)
+    {
+        const QLatin1String prefix(NumberedPathPrefix);
+        if (path.size() <= prefix.size() || !path.startsWith(prefix))
+            return std::nullopt;
+        const QStringView number = QStringView(path).mid(prefix.size());
+        // only the canonical spelling maps back to the same path
+        if (number.size() > 1 && number.at(0) == QLatin1Char('0'))
+            return std::nullopt;
+        for (const QChar c : number) {
+            if (c < QLatin1Char('0') || c > QLatin1Char('9'))
+                return std::nullopt;
+        }
+        bool ok = false;
+        const uint key = number.toUInt(&ok);
+        if (!ok || key >= InternedPath)
+            return std::nullopt;
+        return key;
+    }
+
+    std::optional<quint32> existingPathKey(const Service &service, const QString &path) const
+    {
+        if (const std::optional<quint32> key = numberedPathKey(path))
+            return key;
+        const auto it = m_pathKeys.constFind(path);
+        if (it == m_pathKeys.constEnd() || !service.pathKeys.contains(it.value()))
+            return std::nullopt;
+        return it.value();
+    }
+
+    quint32 pathKey(Service &service, const QString &path)
+    {
+        if (const std::optional<quint32> key = numberedPathKey(path))
+            return *key;
+        quint32 key;
+        const auto it = m_pathKeys.constFind(path);
+        if (it != m_pathKeys.constEnd()) {
+            key = it.value();
+        } else if (!m_freePaths.isEmpty()) {
+            key = m_freePaths.takeLast();
+            m_paths[int(key & ~InternedPath)].path = path;
+            m_pathKeys.insert(path, key);
+        } else {
+            key = InternedPath | quint32(m_paths.size());
+            m_paths.append(Path{path, 0});
+            m_pathKeys.insert(path, key);
+        }
+        if (!service.pathKeys.contains(key)) {
+            service.pathKeys.insert(key);
+            ++m_paths[int(key & ~InternedPath)].services;
+        }
+        return key;
+    }
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, quint32> m_serviceKeys;
+    QHash<quint32, Service> m_services;
+    quint32 m_nextServiceKey = 0;
+    // the paths that are not numbered, shared by all services, and the keys of the unused entries
+    QHash<QString, quint32> m_pathKeys;
+    QList<Path> m_paths;
+    QList<quint32> m_freePaths;
+};
+}
+
+#endif
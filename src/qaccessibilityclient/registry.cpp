@@ -9,6 +9,8 @@
 
 #include <qurl.h>
 
+#include <utility>
+
 using namespace QAccessibleClient;
 
 Registry::Registry(QObject *parent)
@@ -52,18 +54,192 @@ Registry::EventListeners Registry::subscribedEventListeners() const
     return d->eventListeners();
 }
 
+void Registry::setEventScope(const QList<AccessibleObject> &applications, EventListeners listeners)
+{
+    d->setEventScope(applications, listeners);
+}
+
+QList<AccessibleObject> Registry::eventScope(EventListener listener) const
+{
+    return d->eventScope(listener);
+}
+
+bool Registry::subscribeEventDetails(EventListener listener, const QStringList &details)
+{
+    return d->subscribeEventDetails(listener, details);
+}
+
+QStringList Registry::subscribedEventDetails(EventListener listener) const
+{
+    return d->subscribedEventDetails(listener);
+}
+
 QList<AccessibleObject> Registry::applications() const
 {
     return d->topLevelAccessibles();
 }
 
+QFuture<QList<AccessibleObject> > Registry::applicationsAsync() const
+{
+    return d->topLevelAccessiblesAsync();
+}
+
 AccessibleObject Registry::accessibleFromUrl(const QUrl &url) const
 {
     return d->fromUrl(url);
 }
 
+AccessibleObject Registry::accessibleFromEvent(const AccessibleEvent &event) const
+{
+    if (!event.isValid())
+        return AccessibleObject();
+    return d->accessibleFromPath(d->m_identities.service(event.handle()), d->m_identities.path(event.handle()));
+}
+
+QList<AccessibleObject> Registry::snapshotApplication(const AccessibleObject &app)
+{
+    return d->snapshotApplication(app);
+}
+
+bool Registry::mirrorApplication(const AccessibleObject &app)
+{
+    return d->mirrorApplication(app);
+}
+
+void Registry::stopMirroring(const AccessibleObject &app)
+{
+    d->stopMirroring(app);
+}
+
+bool Registry::isMirrored(const AccessibleObject &app) const
+{
+    return d->isMirrored(app);
+}
+
+void Registry::setCallPolicy(const CallPolicy &policy)
+{
+    QMutexLocker lock(&d->m_callMutex);
+    d->m_callPolicy = policy;
+}
+
+Registry::CallPolicy Registry::callPolicy() const
+{
+    QMutexLocker lock(&d->m_callMutex);
+    return d->m_callPolicy;
+}
+
+QList<Registry::ServiceHealth> Registry::serviceHealth() const
+{
+    return d->serviceHealth();
+}
+
+QList<Registry::CallStatistics> Registry::callStatisticsByMethod() const
+{
+    QMutexLocker lock(&d->m_callMutex);
+    return d->m_methodStatistics.values();
+}
+
+QList<Registry::CallStatistics> Registry::callStatisticsByService() const
+{
+    QMutexLocker lock(&d->m_callMutex);
+    return d->m_serviceStatistics.values();
+}
+
+void Registry::resetCallStatistics()
+{
+    QMutexLocker lock(&d->m_callMutex);
+    d->m_methodStatistics.clear();
+    d->m_serviceStatistics.clear();
+}
+
+void Registry::dumpCallStatistics() const
+{
+    d->dumpCallStatistics();
+}
+
+Registry::CacheStatistics Registry::cacheStatistics() const
+{
+    if (d->m_cache)
+        return d->m_cache->statistics();
+    return CacheStatistics();
+}
+
+void Registry::resetCacheStatistics()
+{
+    if (d->m_cache)
+        d->m_cache->resetStatistics();
+}
+
+void Registry::setCacheStatisticsInterval(int msec)
+{
+    if (msec > 0)
+        d->m_statisticsTimer.start(msec);
+    else
+        d->m_statisticsTimer.stop();
+}
+
+void Registry::setEventCoalescing(const EventCoalescing &coalescing)
+{
+    d->m_coalescing = coalescing;
+    if (coalescing.window <= 0) {
+        d->m_coalescingTimer.stop();
+        d->flushCoalescedEvents(0);
+    }
+}
+
+Registry::EventCoalescing Registry::eventCoalescing() const
+{
+    return d->m_coalescing;
+}
+
+Registry::EventCoalescingStatistics Registry::eventCoalescingStatistics() const
+{
+    EventCoalescingStatistics statistics = d->m_coalescingStatistics;
+    statistics.pending = int(d->m_coalescedEvents.size());
+    return statistics;
+}
+
+void Registry::resetEventCoalescingStatistics()
+{
+    d->m_coalescingStatistics = EventCoalescingStatistics();
+}
+
+void Registry::setEventReceiverThread(bool enabled, int capacity)
+{
+    d->setEventReceiverThread(enabled, capacity);
+}
+
+bool Registry::isEventReceiverThreadEnabled() const
+{
+    return d->m_eventReceiver != nullptr;
+}
+
+Registry::EventQueueStatistics Registry::eventQueueStatistics() const
+{
+    return d->eventQueueStatistics();
+}
+
+void Registry::resetEventQueueStatistics()
+{
+    if (d->m_eventReceiver)
+        d->m_eventReceiver->resetStatistics();
+    d->m_eventsDelivered = 0;
+}
+
+Registry::QueryResult Registry::query(const QList<AccessibleObject> &objects, QueryFields fields) const
+{
+    return d->query(objects, fields);
+}
+
+QFuture<int> Registry::crawl(const CrawlOptions &options, const std::function<void(const CrawledObject &)> &visitor)
+{
+    return d->crawl(options, visitor);
+}
+
 Registry::CacheType Registry::cacheType() const
 {
+    if (dynamic_cast<CacheStrongLruStrategy*>(d->m_cache))
+        return StrongLruCache;
     if (dynamic_cast<CacheWeakStrategy*>(d->m_cache))
         return WeakCache;
     return NoCache;
@@ -72,21 +248,30 @@ Registry::CacheType Registry::cacheType() const
 void Registry::setCacheType(Registry::CacheType type)
 {
     //if (cacheType() == type) return;
-    delete d->m_cache;
-    d->m_cache = nullptr;
+    // mirrors live in the cache, they cannot survive it
+    const QStringList mirrored = d->m_mirroredApplications.keys();
+    for (const QString &service : mirrored)
+        d->stopMirroring(service);
+    // objects released by the old cache must not find it while it is being deleted
+    delete std::exchange(d->m_cache, nullptr);
     switch (type) {
         case NoCache:
             break;
         case WeakCache:
             d->m_cache = new CacheWeakStrategy();
             break;
+        case StrongLruCache:
+            d->m_cache = new CacheStrongLruStrategy(d->m_cacheMaxObjects, d->m_cacheMaxBytes);
+            break;
     }
+    d->updateCachedValues();
 }
 
 AccessibleObject Registry::clientCacheObject(const QString &id) const
 {
     if (d->m_cache) {
-        QSharedPointer<AccessibleObjectPrivate> p = d->m_cache->get(id);
+        const std::optional<ObjectHandle> handle = d->m_identities.find(id);
+        QSharedPointer<AccessibleObjectPrivate> p = handle ? d->m_cache->get(*handle) : QSharedPointer<AccessibleObjectPrivate>();
         if (p)
             return AccessibleObject(p);
     }
@@ -96,9 +281,13 @@ AccessibleObject Registry::clientCacheObject(const QString &id) const
 QStringList Registry::clientCacheObjects() const
 {
     QStringList result;
-    if (d->m_cache)
-        return d->m_cache->ids();
-    return QStringList();
+    if (d->m_cache) {
+        const QList<ObjectHandle> handles = d->m_cache->handles();
+        result.reserve(handles.size());
+        for (ObjectHandle handle : handles)
+            result.append(d->m_identities.id(handle));
+    }
+    return result;
 }
 
 void Registry::clearClientCache()
@@ -8,11 +8,17 @@
 #define QACCESSIBILITYCLIENT_REGISTRY_H
 
 #include <QObject>
+#include <QFuture>
+#include <QHash>
+#include <QRect>
 
 #include "qaccessibilityclient_export.h"
+#include "accessibleevent.h"
 #include "accessibleobject.h"
 #include <QUrl>
 
+#include <functional>
+
 #define accessibleRegistry (QAccessibleClient::Registry::instance())
 
 namespace QAccessibleClient {
@@ -27,6 +33,15 @@ class RegistryPrivateCacheApi;
 
     It provides information about running applications.
     All updates of accessible objects will result in signals emitted by this class.
+
+    The AccessibleObject accessors may be called from several threads at
+    once, for example one thread per application when crawling the
+    desktop. Each thread makes its blocking calls over a connection of
+    its own and the object cache is split into independently locked
+    parts. Signals are emitted in the thread of the registry, and the
+    configuration, like setCacheType() or subscribeEventListeners(),
+    must be changed from that thread while no other thread uses the
+    registry.
 */
 class QACCESSIBILITYCLIENT_EXPORT Registry : public QObject
 {
@@ -91,6 +106,293 @@ public:
     Q_ENUM(EventListener)
     Q_DECLARE_FLAGS(EventListeners, EventListener)
 
+    /*!
+     * \enum QAccessibleClient::Registry::QueryField
+     * The properties query() can fetch for a list of objects.
+     *
+     * \value QueryName
+     *        AccessibleObject::name()
+     * \value QueryDescription
+     *        AccessibleObject::description()
+     * \value QueryRole
+     *        AccessibleObject::role()
+     * \value QueryChildCount
+     *        AccessibleObject::childCount()
+     * \value QueryState
+     *        The state bits as returned by the GetState call.
+     * \value QueryInterfaces
+     *        AccessibleObject::supportedInterfaces()
+     * \value QueryBoundingRect
+     *        AccessibleObject::boundingRect()
+     */
+    enum QueryField {
+        QueryName = 0x1,
+        QueryDescription = 0x2,
+        QueryRole = 0x4,
+        QueryChildCount = 0x8,
+        QueryState = 0x10,
+        QueryInterfaces = 0x20,
+        QueryBoundingRect = 0x40
+    };
+    Q_ENUM(QueryField)
+    Q_DECLARE_FLAGS(QueryFields, QueryField)
+
+    /*!
+        \brief The column oriented result of query().
+
+        Every list that belongs to a requested field has one entry per
+        object, in the order of \c objects. The lists of fields that were
+        not requested stay empty. Objects that failed to answer get the
+        same default value the single getters return.
+    */
+    struct QueryResult
+    {
+        QList<AccessibleObject> objects;
+        QueryFields fields;
+        QStringList names;
+        QStringList descriptions;
+        QList<AccessibleObject::Role> roles;
+        QList<int> childCounts;
+        QList<quint64> states;
+        QList<AccessibleObject::Interfaces> interfaces;
+        QList<QRect> boundingRects;
+    };
+
+    /*!
+        \brief Timeouts and failure handling for calls into applications.
+
+        Every call is sent with \c defaultTimeout milliseconds unless
+        \c interfaceTimeouts has an entry for the method, like
+        \c org.a11y.atspi.Action.DoAction, or for the D-Bus interface of
+        the call. For property access through org.freedesktop.DBus.Properties
+        the interface of the property is used. Fetching the whole tree
+        and searching it can take a while in big applications, so the
+        org.a11y.atspi.Cache and org.a11y.atspi.Collection interfaces
+        get more time by default. Calls that change the application,
+        like triggering an action or editing text, only return once the
+        application handled them, which may open a modal dialog. They
+        keep the 25 second default of QtDBus.
+
+        After \c failureThreshold calls to the same application timed out
+        in a row, the application is quarantined: further calls fail
+        immediately, so getters return cached or default values. Every
+        \c quarantineInterval milliseconds the registry probes the
+        application in the background and lifts the quarantine as soon
+        as it answers. A \c failureThreshold of 0 disables this.
+
+        \sa Registry::setCallPolicy(), Registry::serviceHealth()
+    */
+    struct CallPolicy
+    {
+        int defaultTimeout = 500;
+        QHash<QString, int> interfaceTimeouts = {
+            { QStringLiteral("org.a11y.atspi.Cache"), 5000 },
+            { QStringLiteral("org.a11y.atspi.Collection"), 5000 },
+            { QStringLiteral("org.a11y.atspi.Action.DoAction"), 25000 },
+            { QStringLiteral("org.a11y.atspi.EditableText"), 25000 },
+            { QStringLiteral("org.a11y.atspi.Value.SetCurrentValue"), 25000 },
+        };
+        int failureThreshold = 3;
+        int quarantineInterval = 10000;
+    };
+
+    /*!
+        \brief Call statistics of one application.
+
+        \c calls counts the replies and timeouts seen from \c service,
+        \c errors the ones that were errors and \c timeouts those that
+        did not arrive in time. Latencies are in milliseconds,
+        \c averageLatency is weighted towards recent calls.
+        \sa Registry::serviceHealth()
+    */
+    struct ServiceHealth
+    {
+        QString service;
+        int calls = 0;
+        int errors = 0;
+        int timeouts = 0;
+        int consecutiveTimeouts = 0;
+        int lastLatency = 0;
+        int averageLatency = 0;
+        bool quarantined = false;
+    };
+
+    /*!
+        \brief Timing of the D-Bus calls to one method or one application.
+
+        \c key is either the interface and method, like
+        \c org.a11y.atspi.Accessible.GetChildren, or the service name of
+        the application. Property access is keyed by the property, like
+        \c Properties.Get:Name. Latencies are in microseconds.
+
+        Entry \c i of \c histogram counts the calls that took at least
+        2^i and less than 2^(i+1) microseconds, entry 0 includes faster
+        calls and the last entry all slower ones.
+        \sa Registry::callStatisticsByMethod(), Registry::callStatisticsByService()
+    */
+    struct CallStatistics
+    {
+        static constexpr int HistogramBuckets = 26;
+
+        QString key;
+        quint64 calls = 0;
+        quint64 errors = 0;
+        qint64 totalLatency = 0;
+        qint64 maxLatency = 0;
+        QList<quint64> histogram;
+
+        qint64 averageLatency() const { return calls ? totalLatency / qint64(calls) : 0; }
+    };
+
+    /*!
+        \brief Lookups of one kind of value in the object cache.
+
+        A hit means the value was answered from the cache, a miss that
+        it had to be asked for over D-Bus.
+        \sa CacheStatistics
+    */
+    struct CacheCounters
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+
+        quint64 lookups() const { return hits + misses; }
+    };
+
+    /*!
+        \brief Counters of the object cache.
+
+        \c objects counts the lookups of AccessibleObjects themselves,
+        the other counters the lookups of the cached values of objects.
+        \c insertions counts objects and values put into the cache,
+        \c evictions objects released because the cache was full and
+        \c invalidations cached values dropped because an event
+        reported a change or the events were unsubscribed. \c objectCount and \c approximateBytes
+        describe the current content of the cache.
+        \sa Registry::cacheStatistics()
+    */
+    struct CacheStatistics
+    {
+        CacheCounters objects;
+        CacheCounters names;
+        CacheCounters descriptions;
+        CacheCounters roles;
+        CacheCounters parents;
+        CacheCounters children;
+        CacheCounters childCounts;
+        CacheCounters interfaces;
+        CacheCounters states;
+        quint64 insertions = 0;
+        quint64 evictions = 0;
+        quint64 invalidations = 0;
+        int objectCount = 0;
+        qint64 approximateBytes = 0;
+    };
+
+    /*!
+        \brief Merging of events that arrive in bursts.
+
+        Applications repopulating a view send a flood of state, children
+        and visible data changes for the same objects. With a \c window
+        greater than 0 these events are held back for up to \c window
+        milliseconds; further events of the same kind for the same object
+        arriving meanwhile are merged into the held back one. For state
+        changes the last value of each state wins. Children changes are
+        merged as long as their indexes form one consecutive range,
+        otherwise the held back event is emitted and the new one held
+        instead; additions and removals of the same parent are delivered
+        in the order they arrived. Other events and focus changes are not
+        delayed.
+
+        \c maxEventsPerWindow limits the signals emitted per window,
+        the rest waits for the next one. Once \c maxPendingEvents events
+        are held back, further ones are dropped. A value of 0 disables
+        either limit.
+
+        \sa Registry::setEventCoalescing(), Registry::eventCoalescingStatistics()
+    */
+    struct EventCoalescing
+    {
+        int window = 0;
+        int maxEventsPerWindow = 0;
+        int maxPendingEvents = 10000;
+    };
+
+    /*!
+        \brief Counters of the event coalescing.
+
+        \c received counts the events that could be merged since
+        coalescing was enabled, \c emitted the signals emitted for them,
+        \c merged the events folded into a held back one and \c dropped
+        the events lost because too many were held back. \c pending is
+        the number of events currently held back.
+        \sa Registry::EventCoalescing
+    */
+    struct EventCoalescingStatistics
+    {
+        quint64 received = 0;
+        quint64 emitted = 0;
+        quint64 merged = 0;
+        quint64 dropped = 0;
+        int pending = 0;
+    };
+
+    /*!
+        \brief Counters of the queue between the event receiver thread and the registry.
+
+        \c capacity is the number of events the queue holds, \c pending
+        the events currently waiting in it and \c highWaterMark the most
+        that were waiting at once. \c received counts the events the
+        thread took off the bus, \c delivered those handled by the
+        registry and \c dropped those lost because the queue was full.
+        \sa Registry::setEventReceiverThread()
+    */
+    struct EventQueueStatistics
+    {
+        int capacity = 0;
+        int pending = 0;
+        int highWaterMark = 0;
+        quint64 received = 0;
+        quint64 delivered = 0;
+        quint64 dropped = 0;
+    };
+
+    /*!
+        \brief What crawl() walks.
+
+        \c applications are the roots of the walk, all applications on
+        the bus if empty. Objects deeper than \c maxDepth below their
+        application are not visited, the applications themselves have
+        depth 0 and a negative \c maxDepth does not limit the depth.
+        Objects with one of the \c prunedRoles are visited, their
+        children are not. At most \c maxRequestsPerService requests are
+        in flight per application, so a busy application is not flooded
+        while the others are walked in parallel.
+        \sa Registry::crawl()
+    */
+    struct CrawlOptions
+    {
+        QList<AccessibleObject> applications;
+        int maxDepth = -1;
+        int maxRequestsPerService = 4;
+        QList<AccessibleObject::Role> prunedRoles;
+    };
+
+    /*!
+        \brief An object found by crawl().
+
+        \c parent is invalid for the applications, \c depth counts the
+        levels below the application.
+        \sa Registry::crawl()
+    */
+    struct CrawledObject
+    {
+        AccessibleObject object;
+        AccessibleObject parent;
+        AccessibleObject::Role role = AccessibleObject::NoRole;
+        int depth = 0;
+    };
+
     /*!
       Construct a Registry object with \a parent as QObject parent.
      */
@@ -100,6 +402,15 @@ public:
      */
     ~Registry() override;
 
+    /*!
+        Asynchronous variant of applications().
+
+        The list is delivered through the returned future once the
+        accessibility registry replied, the caller is never blocked.
+        \sa AccessibleObject::accessibleIdAsync()
+    */
+    QFuture<QList<AccessibleObject> > applicationsAsync() const;
+
 public Q_SLOTS:
 
     /*!
@@ -146,6 +457,53 @@ public Q_SLOTS:
      */
     EventListeners subscribedEventListeners() const;
 
+    /*!
+        Limits the events of the \a listeners to those sent by the \a applications.
+
+        The limit is installed as match rule on the accessibility bus,
+        so the bus does not even send events of other applications to
+        this process. An empty list of \a applications lifts the limit,
+        which is the default. Setting a scope does not subscribe the
+        \a listeners, see subscribeEventListeners().
+
+        Applications that leave the bus and return are new applications
+        and need a new scope.
+        \sa eventScope()
+    */
+    void setEventScope(const QList<AccessibleObject> &applications, EventListeners listeners = AllEventListeners);
+    /*!
+        Returns the applications the events of \a listener are limited to,
+        an empty list if they are not limited.
+        \sa setEventScope()
+     */
+    QList<AccessibleObject> eventScope(EventListener listener) const;
+
+    /*!
+        Limits the events of \a listener to those with one of the \a details.
+
+        The details are the states for StateChanged, like \c focused,
+        \c add or \c remove for ChildrenChanged, \c insert or \c delete
+        for TextChanged and the property names for PropertyChanged, like
+        \c accessible-name. Other listeners cannot be limited, for them
+        \c false is returned.
+
+        Only the events with the \a details are registered with the
+        accessibility registry, toolkits that honour it do not even send
+        the others, and only they are matched on the bus. An empty list
+        of \a details lifts the limit, which is the default. The state
+        \c defunct is always received, the registry needs it to notice
+        objects going away. Values cached for objects are not trusted
+        while the property or children changes are limited.
+        \sa subscribedEventDetails(), subscribeEventListeners()
+    */
+    bool subscribeEventDetails(EventListener listener, const QStringList &details);
+    /*!
+        Returns the details the events of \a listener are limited to,
+        an empty list if they are not limited.
+        \sa subscribeEventDetails()
+     */
+    QStringList subscribedEventDetails(EventListener listener) const;
+
     /*!
         List of all currently running applications that
         expose an accessibility interface.
@@ -162,6 +520,214 @@ public Q_SLOTS:
     */
     AccessibleObject accessibleFromUrl(const QUrl &url) const;
 
+    /*!
+        Returns the AccessibleObject the \a event is about.
+        \sa accessibleEvent()
+    */
+    AccessibleObject accessibleFromEvent(const AccessibleEvent &event) const;
+
+    /*!
+        Fetches the whole accessible tree of the application \a app at once.
+
+        This asks the org.a11y.atspi.Cache interface of the application for
+        all the objects it knows about. Path, parent, children, supported
+        interfaces, name, role, description and state of every object arrive
+        in a single reply and are put into the object cache, so walking the
+        tree afterwards does not need further round trips as long as the
+        returned objects are kept alive.
+
+        Nothing is cached if caching is disabled, the returned list is still
+        filled in that case. Like for the other accessors name, description,
+        role, parent and children are only cached while the events telling
+        about their changes are subscribed, see subscribeEventListeners(),
+        unless the application is mirrored. Applications that do not implement the cache
+        interface, or that keep it empty, return an empty list; callers then
+        need to fall back to AccessibleObject::children().
+
+        This call blocks until the reply arrived, including the time it
+        takes to look up the accessibility bus right after the registry
+        was created.
+    */
+    QList<AccessibleObject> snapshotApplication(const AccessibleObject &app);
+
+    /*!
+        Fetches the \a fields of all \a objects in one go.
+
+        All requests are sent back to back before waiting for the first
+        reply, so asking for the role and name of thousands of siblings
+        costs roughly one round trip plus the transfer time instead of one
+        round trip per object and field. Values found in the object cache
+        are not requested again.
+
+        Unlike the *Async() accessors this blocks until all replies arrived
+        and, right after the registry was created, until the accessibility
+        bus is connected.
+    */
+    QueryResult query(const QList<AccessibleObject> &objects, QueryFields fields) const;
+
+    /*!
+        Walks the accessible trees of applications as described by \a options.
+
+        Unlike asking each object for its children in turn, requests to
+        all applications are in flight at the same time, so the time a
+        walk of the desktop takes is bound by the slowest application
+        rather than the sum of all of them. Each object is passed to
+        \a visitor as soon as its role arrived, in the thread of the
+        registry; objects of different applications interleave and
+        siblings may arrive in any order.
+
+        The returned future finishes with the number of objects visited
+        once the walk is done. Canceling it stops the walk, no further
+        objects are visited then. Objects and values found are cached
+        like for the other accessors.
+    */
+    QFuture<int> crawl(const CrawlOptions &options, const std::function<void(const CrawledObject &)> &visitor);
+
+    /*!
+        Keeps a local copy of the accessible tree of the application \a app.
+
+        The tree is fetched with snapshotApplication() and then kept up to
+        date by listening to the AddAccessible and RemoveAccessible signals
+        of the application's org.a11y.atspi.Cache interface. As long as the
+        application is mirrored, its objects are held by the registry and
+        children(), parent(), role() and supportedInterfaces() of those
+        objects are answered from memory. Since the cache signals keep them
+        up to date, the values of mirrored applications are cached whether
+        or not PropertyChanged and ChildrenChanged are subscribed.
+
+        Returns \c false if caching is disabled or the signals could not
+        be subscribed. Mirroring ends with stopMirroring(), when the cache
+        type changes or when the application leaves the bus.
+        \sa added(), removed()
+    */
+    bool mirrorApplication(const AccessibleObject &app);
+    /*!
+        Stops keeping the tree of the application \a app in sync.
+        \sa mirrorApplication()
+     */
+    void stopMirroring(const AccessibleObject &app);
+    /*!
+        Returns \c true if the application \a app is mirrored.
+        \sa mirrorApplication()
+     */
+    bool isMirrored(const AccessibleObject &app) const;
+
+    /*!
+        Sets the timeouts and failure handling used for all calls
+        into accessible applications to \a policy.
+
+        Applications currently quarantined stay so until their
+        quarantine ends.
+        \sa callPolicy()
+     */
+    void setCallPolicy(const CallPolicy &policy);
+    /*!
+        Returns the policy used for calls into accessible applications.
+        \sa setCallPolicy()
+     */
+    CallPolicy callPolicy() const;
+    /*!
+        Returns the call statistics of all applications that were called.
+
+        Applications leaving the bus are dropped from the list.
+        \sa CallPolicy, serviceQuarantined(), serviceReadmitted()
+     */
+    QList<ServiceHealth> serviceHealth() const;
+
+    /*!
+        Returns the timing of all calls made so far, one entry per
+        D-Bus interface and method.
+        \sa callStatisticsByService(), dumpCallStatistics()
+     */
+    QList<CallStatistics> callStatisticsByMethod() const;
+    /*!
+        Returns the timing of all calls made so far, one entry per
+        application.
+        \sa callStatisticsByMethod()
+     */
+    QList<CallStatistics> callStatisticsByService() const;
+    /*!
+        Forgets the timing of all calls made so far.
+     */
+    void resetCallStatistics();
+    /*!
+        Writes the call statistics, slowest first, to the
+        org.kde.qaccessibilityclient.calls logging category at info level.
+     */
+    void dumpCallStatistics() const;
+
+    /*!
+        Returns the counters of the object cache.
+
+        All counters are zero while caching is disabled. The counters
+        start over when the cache type changes or resetCacheStatistics()
+        is called.
+        \sa cacheStatisticsUpdated()
+     */
+    CacheStatistics cacheStatistics() const;
+    /*!
+        Sets all counters of the object cache back to zero.
+     */
+    void resetCacheStatistics();
+    /*!
+        Emits cacheStatisticsUpdated() every \a msec milliseconds.
+
+        An interval of 0, the default, stops the updates.
+     */
+    void setCacheStatisticsInterval(int msec);
+
+    /*!
+        Merges bursts of events as described by \a coalescing.
+
+        A window of 0, the default, emits every event right away.
+        Events held back when coalescing is disabled are emitted
+        immediately.
+        \sa eventCoalescing(), eventCoalescingStatistics()
+     */
+    void setEventCoalescing(const EventCoalescing &coalescing);
+    /*!
+        Returns how bursts of events are merged.
+        \sa setEventCoalescing()
+     */
+    EventCoalescing eventCoalescing() const;
+    /*!
+        Returns the counters of the event coalescing.
+     */
+    EventCoalescingStatistics eventCoalescingStatistics() const;
+    /*!
+        Sets the counters of the event coalescing back to zero.
+     */
+    void resetEventCoalescingStatistics();
+
+    /*!
+        Receives the events on a thread of their own if \a enabled.
+
+        The thread takes the events off the accessibility bus and unpacks
+        them, the registry handles them in its own thread and emits the
+        signals as before. Up to \a capacity events, rounded up to a power
+        of two, wait for the registry; when it falls behind further events
+        are dropped and counted instead of piling up, and the cached
+        properties are cleared as they may have missed a change.
+
+        By default events are received in the thread of the registry.
+        \sa eventQueueStatistics()
+     */
+    void setEventReceiverThread(bool enabled, int capacity = 4096);
+    /*!
+        Returns whether events are received on a thread of their own.
+        \sa setEventReceiverThread()
+     */
+    bool isEventReceiverThreadEnabled() const;
+    /*!
+        Returns the counters of the event queue, all zero while
+        events are received in the thread of the registry.
+     */
+    EventQueueStatistics eventQueueStatistics() const;
+    /*!
+        Sets the counters of the event queue back to zero.
+     */
+    void resetEventQueueStatistics();
+
 Q_SIGNALS:
 
     /*!
@@ -180,6 +746,25 @@ Q_SIGNALS:
     */
     void screenReaderEnabledChanged(bool enabled);
 
+    /*!
+        Emitted when calls into \a service timed out too often and
+        further calls fail immediately.
+        \sa CallPolicy, serviceReadmitted()
+    */
+    void serviceQuarantined(const QString &service);
+    /*!
+        Emitted when the quarantined \a service answered again.
+        \sa serviceQuarantined()
+    */
+    void serviceReadmitted(const QString &service);
+
+    /*!
+        Emitted periodically with the current counters of the object cache
+        in \a statistics once an interval was set.
+        \sa setCacheStatisticsInterval()
+    */
+    void cacheStatisticsUpdated(const QAccessibleClient::Registry::CacheStatistics &statistics);
+
     /*!
         Emitted if an AccessibleObject \a object is created.
 
@@ -242,6 +827,27 @@ Q_SIGNALS:
     //void boundsChanged(const QAccessibleClient::AccessibleObject &object);
     //void linkSelected(const QAccessibleClient::AccessibleObject &object);
 
+    /*!
+        \brief Notifies about any event of the subscribed event listeners.
+
+        Emitted together with the specific signal of the \a event, like
+        windowCreated() or stateChanged(), but without creating an
+        AccessibleObject. Consumers interested in many kinds of events
+        can connect to this signal only. Events are not coalesced.
+        \sa accessibleEvents(), accessibleFromEvent()
+     */
+    void accessibleEvent(const QAccessibleClient::AccessibleEvent &event);
+
+    /*!
+        \brief Delivers the \a events that arrived since the last batch.
+
+        Like accessibleEvent() but batched: all events that arrive until
+        control returns to the event loop are emitted together, in the
+        order they arrived.
+        \sa accessibleEvent()
+     */
+    void accessibleEvents(const QList<QAccessibleClient::AccessibleEvent> &events);
+
     /*!
         \brief Notifies about a state change in an object.
 
@@ -250,6 +856,15 @@ Q_SIGNALS:
      */
     void stateChanged(const QAccessibleClient::AccessibleObject &object, const QString &state, bool active);
 
+    /*!
+        \brief Notifies about a state change in an object.
+
+        The same as stateChanged() for the states known as
+        AccessibleObject::State, emitted right after it. States the
+        library does not know only arrive through stateChanged().
+     */
+    void accessibleStateChanged(const QAccessibleClient::AccessibleObject &object, QAccessibleClient::AccessibleObject::State state, bool active);
+
     /*!
         \brief Notifies about a new AccessibleObject.
 
@@ -269,6 +884,24 @@ Q_SIGNALS:
      */
     void childRemoved(const QAccessibleClient::AccessibleObject &parent, int childIndex);
 
+    /*!
+        \brief Notifies that several children were added to \a parent.
+
+        Only emitted with event coalescing enabled, instead of childAdded()
+        when more than one child was added to \a parent within one window.
+        The added children lie between \a first and \a last, both included.
+        \sa Registry::setEventCoalescing()
+     */
+    void childrenAdded(const QAccessibleClient::AccessibleObject &parent, int first, int last);
+
+    /*!
+        \brief Notifies that several children were removed from \a parent.
+
+        The counterpart of childrenAdded() for childRemoved().
+        \sa Registry::setEventCoalescing()
+     */
+    void childrenRemoved(const QAccessibleClient::AccessibleObject &parent, int first, int last);
+
     /*!
       \brief Notifies that the \a object's visible data changed.
      */
@@ -368,7 +1001,7 @@ private:
     friend class RegistryPrivate;
     friend class RegistryPrivateCacheApi;
 
-    enum CacheType { NoCache, WeakCache};
+    enum CacheType { NoCache, WeakCache, StrongLruCache };
     QACCESSIBILITYCLIENT_NO_EXPORT CacheType cacheType() const;
     QACCESSIBILITYCLIENT_NO_EXPORT void setCacheType(CacheType type);
     QACCESSIBILITYCLIENT_NO_EXPORT AccessibleObject clientCacheObject(const QString &id) const;
@@ -377,6 +1010,7 @@ private:
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Registry::EventListeners)
+Q_DECLARE_OPERATORS_FOR_FLAGS(Registry::QueryFields)
 
 }
 
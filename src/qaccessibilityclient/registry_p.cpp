@@ -5,15 +5,27 @@
 */
 
 #include "registry_p.h"
+#include "crawler_p.h"
 #include "registry.h"
+#include "eventnames_p.h"
 #include "qaccessibilityclient_debug.h"
+#include "qaccessibilityclient_calls_debug.h"
 
 #include <QDBusMessage>
 #include <QDBusArgument>
 #include <QDBusReply>
 #include <QDBusPendingCall>
+#include <QDBusPendingCallWatcher>
+#include <QDBusServiceWatcher>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QMetaEnum>
+#include <QMetaMethod>
+#include <QThread>
+#include <QTimer>
 #include <QDBusArgument>
 #include <QDBusMetaType>
+#include <QPromise>
 
 #include <QDBusMessage>
 #include <QStringList>
@@ -23,6 +35,11 @@
 
 #include <QString>
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
 // interface names from at-spi2-core/atspi/atspi-misc-private.h
 #define ATSPI_DBUS_NAME_REGISTRY "org.a11y.atspi.Registry"
 #define ATSPI_DBUS_PATH_REGISTRY "/org/a11y/atspi/registry"
@@ -65,10 +82,27 @@
 
 #define QSPI_REGISTRY_NAME "org.a11y.atspi.Registry"
 
+// error of calls that were not sent because the service is quarantined
+#define QSPI_ERROR_QUARANTINED "org.kde.qaccessibilityclient.Error.Quarantined"
+
 //#define ATSPI_DEBUG
 
 using namespace QAccessibleClient;
 
+namespace {
+
+template<typename T>
+QFuture<T> readyFuture(const T &value)
+{
+    QPromise<T> promise;
+    promise.start();
+    promise.addResult(value);
+    promise.finish();
+    return promise.future();
+}
+
+}
+
 QString RegistryPrivate::ACCESSIBLE_OBJECT_SCHEME_STRING = QLatin1String("accessibleobject");
 
 RegistryPrivate::RegistryPrivate(Registry *qq)
@@ -78,13 +112,28 @@ RegistryPrivate::RegistryPrivate(Registry *qq)
     qDBusRegisterMetaType<QVector<quint32> >();
 
     connect(&conn, SIGNAL(connectionFetched()), this, SLOT(connectionFetched()));
-    connect(&m_actionMapper, SIGNAL(mappedString(QString)), this, SLOT(actionTriggered(QString)));
+    connect(&m_statisticsTimer, SIGNAL(timeout()), this, SLOT(slotCacheStatisticsTimeout()));
+    m_coalescingTimer.setSingleShot(true);
+    connect(&m_coalescingTimer, SIGNAL(timeout()), this, SLOT(slotCoalescingTimeout()));
+    m_eventBatchTimer.setSingleShot(true);
+    connect(&m_eventBatchTimer, SIGNAL(timeout()), this, SLOT(slotEventBatchTimeout()));
     init();
 }
 
 RegistryPrivate::~RegistryPrivate()
 {
-    delete m_cache;
+    // Pending asynchronous calls hold AccessibleObjects that need the cache when they go away.
+    qDeleteAll(findChildren<QDBusPendingCallWatcher*>(Qt::FindDirectChildrenOnly));
+    if (m_eventThread) {
+        m_eventThread->quit();
+        m_eventThread->wait();
+        delete m_eventThread;
+        delete m_eventReceiver;
+    }
+    m_mirroredApplications.clear();
+    m_coalescedIndex.clear();
+    m_coalescedEvents.clear();
+    delete std::exchange(m_cache, nullptr);
 }
 
 void RegistryPrivate::init()
@@ -172,7 +221,8 @@ AccessibleObject RegistryPrivate::fromUrl(const QUrl &url) const
 
 void RegistryPrivate::connectionFetched()
 {
-    Q_ASSERT(conn.status() == DBusConnection::Connected);
+    // ConnectionError means we fell back to the session bus, calls are still answered there
+    Q_ASSERT(conn.status() != DBusConnection::Disconnected);
 
     QDBusConnection session = QDBusConnection::sessionBus();
     if (session.isConnected()) {
@@ -181,10 +231,103 @@ void RegistryPrivate::connectionFetched()
             qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << Q_FUNC_INFO << "Failed to connect with signal org.a11y.Status.PropertiesChanged on org.a11y.Bus";
     }
 
+    // unique names of applications are never reused, forget their objects once they left the bus
+    bool watched = conn.connection().connect(QLatin1String("org.freedesktop.DBus"), QLatin1String("/org/freedesktop/DBus"), QLatin1String("org.freedesktop.DBus"),
+                                             QLatin1String("NameOwnerChanged"), this, SLOT(slotNameOwnerChanged(QString,QString,QString)));
+    if (!watched)
+        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << Q_FUNC_INFO << "Failed to connect with signal NameOwnerChanged on the accessibility bus";
+
     if (m_pendingSubscriptions > 0) {
         subscribeEventListeners(m_pendingSubscriptions);
         m_pendingSubscriptions = {};
     }
+
+    QMutexLocker lock(&m_callMutex);
+    const QList<QueuedCall> queuedCalls = std::exchange(m_queuedCalls, {});
+    lock.unlock();
+    for (const QueuedCall &call : queuedCalls) {
+        sendAsyncCall(call.message, call.timeout, call.promise);
+    }
+}
+
+namespace {
+
+// The events announced with org.a11y.atspi.Registry.RegisterEvent, toolkits may skip the others.
+// Detailed events can be narrowed down by appending the detail, like object:state-changed:focused.
+struct RegistryEvent
+{
+    Registry::EventListeners listeners;
+    const char *name;
+    bool detailed;
+};
+
+const RegistryEvent registryEvents[] = {
+    { Registry::Window, "window:", false },
+    { Registry::ChildrenChanged, "object:children-changed", true },
+    { Registry::VisibleDataChanged, "object:visibledata-changed", false },
+    { Registry::SelectionChanged, "object:selection-changed", false },
+    { Registry::ModelChanged, "object:model-changed", false },
+    { Registry::Focus, "focus:", false },
+    // we need state-changed-focus for focus events
+    { Registry::StateChanged | Registry::Focus, "object:state-changed", true },
+    { Registry::TextChanged, "object:text-changed", true },
+    { Registry::TextCaretMoved, "object:text-caret-moved", false },
+    { Registry::TextSelectionChanged, "object:text-selection-changed", false },
+    { Registry::PropertyChanged, "object:property-change", true },
+};
+
+// Events handled per run of slotDrainEvents(), a flood of events must not starve the event loop.
+constexpr int EventDrainBatch = 256;
+
+// The listeners whose events carry their detail as first argument.
+constexpr Registry::EventListeners DetailedListeners(Registry::StateChanged | Registry::ChildrenChanged | Registry::TextChanged | Registry::PropertyChanged);
+
+// The single listeners in \a listeners, AllEventListeners has bits no listener uses.
+QList<Registry::EventListener> singleListeners(Registry::EventListeners listeners)
+{
+    QList<Registry::EventListener> result;
+    const QMetaEnum listenerEnum = QMetaEnum::fromType<Registry::EventListener>();
+    for (int i = 0; i < listenerEnum.keyCount(); ++i) {
+        const Registry::EventListener listener = Registry::EventListener(listenerEnum.value(i));
+        if (qPopulationCount(quint32(listener)) == 1 && listeners.testFlag(listener))
+            result.append(listener);
+    }
+    return result;
+}
+
+}
+
+const QList<RegistryPrivate::EventConnection> &RegistryPrivate::eventConnections()
+{
+    static const QList<EventConnection> connections = {
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Create", SLOT(slotWindowCreate(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowCreate },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Destroy", SLOT(slotWindowDestroy(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowDestroy },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Close", SLOT(slotWindowClose(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowClose },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Reparent", SLOT(slotWindowReparent(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowReparent },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Minimize", SLOT(slotWindowMinimize(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowMinimize },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Maximize", SLOT(slotWindowMaximize(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowMaximize },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Restore", SLOT(slotWindowRestore(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowRestore },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Activate", SLOT(slotWindowActivate(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowActivate },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Deactivate", SLOT(slotWindowDeactivate(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowDeactivate },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "DesktopCreate", SLOT(slotWindowDesktopCreate(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowDesktopCreate },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "DesktopDestroy", SLOT(slotWindowDesktopDestroy(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowDesktopDestroy },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Raise", SLOT(slotWindowRaise(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowRaise },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Lower", SLOT(slotWindowLower(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowLower },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Move", SLOT(slotWindowMove(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowMove },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Resize", SLOT(slotWindowResize(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowResize },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Shade", SLOT(slotWindowShade(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowShade },
+        { Registry::Window, "org.a11y.atspi.Event.Window", "Unshade", SLOT(slotWindowUnshade(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotWindowUnshade },
+        { Registry::ChildrenChanged, "org.a11y.atspi.Event.Object", "ChildrenChanged", SLOT(slotChildrenChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotChildrenChanged },
+        { Registry::VisibleDataChanged, "org.a11y.atspi.Event.Object", "VisibleDataChanged", SLOT(slotVisibleDataChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotVisibleDataChanged },
+        { Registry::SelectionChanged, "org.a11y.atspi.Event.Object", "SelectionChanged", SLOT(slotSelectionChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotSelectionChanged },
+        { Registry::ModelChanged, "org.a11y.atspi.Event.Object", "ModelChanged", SLOT(slotModelChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotModelChanged },
+        { Registry::StateChanged | Registry::Focus, "org.a11y.atspi.Event.Object", "StateChanged", SLOT(slotStateChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotStateChanged },
+        { Registry::TextChanged, "org.a11y.atspi.Event.Object", "TextChanged", SLOT(slotTextChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotTextChanged },
+        { Registry::TextCaretMoved, "org.a11y.atspi.Event.Object", "TextCaretMoved", SLOT(slotTextCaretMoved(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotTextCaretMoved },
+        { Registry::TextSelectionChanged, "org.a11y.atspi.Event.Object", "TextSelectionChanged", SLOT(slotTextSelectionChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotTextSelectionChanged },
+        { Registry::PropertyChanged, "org.a11y.atspi.Event.Object", "PropertyChange", SLOT(slotPropertyChange(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)), &RegistryPrivate::slotPropertyChange },
+    };
+    return connections;
 }
 
 void RegistryPrivate::subscribeEventListeners(const Registry::EventListeners &listeners)
@@ -194,205 +337,15 @@ void RegistryPrivate::subscribeEventListeners(const Registry::EventListeners &li
         return;
     }
 
-    Registry::EventListeners addedListeners = listeners & ~m_subscriptions;
-    Registry::EventListeners removedListeners = m_subscriptions & ~listeners;
-
-    QStringList newSubscriptions;
-    QStringList removedSubscriptions;
-
-    if (removedListeners.testFlag(Registry::Window)) {
-        removedSubscriptions << QLatin1String("window:");
-    } else if (addedListeners.testFlag(Registry::Window)) {
-        // subscribe all window events
-        newSubscriptions << QLatin1String("window:");
-
-        bool created = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Create"),
-                    this, SLOT(slotWindowCreate(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool destroyed = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Destroy"),
-                    this, SLOT(slotWindowDestroy(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-
-        bool closed = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Close"),
-                    this, SLOT(slotWindowClose(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool reparented = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Reparent"),
-                    this, SLOT(slotWindowReparent(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-
-        bool minimized = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Minimize"),
-                    this, SLOT(slotWindowMinimize(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool maximized = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Maximize"),
-                    this, SLOT(slotWindowMaximize(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool restored = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Restore"),
-                    this, SLOT(slotWindowRestore(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-
-        bool activated = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Activate"),
-                    this, SLOT(slotWindowActivate(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool deactivated = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Deactivate"),
-                    this, SLOT(slotWindowDeactivate(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-
-        bool desktopCreated = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("DesktopCreate"),
-                    this, SLOT(slotWindowDesktopCreate(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool desktopDestroyed = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("DesktopDestroy"),
-                    this, SLOT(slotWindowDesktopDestroy(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool raised = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Raise"),
-                    this, SLOT(slotWindowRaise(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool lowered = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Lower"),
-                    this, SLOT(slotWindowLower(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool moved = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Move"),
-                    this, SLOT(slotWindowMove(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool resized = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Resize"),
-                    this, SLOT(slotWindowResize(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool shaded = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Shade"),
-                    this, SLOT(slotWindowShade(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        bool unshaded = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Window"), QLatin1String("Unshade"),
-                    this, SLOT(slotWindowUnshade(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-
-        if (!created || !destroyed || !closed || !reparented || !minimized || !maximized || !restored || 
-            !activated || !deactivated || !desktopCreated || !desktopDestroyed ||
-            !raised || !lowered || !moved || !resized || !shaded || !unshaded
-        ) {
-            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to Window event(s)."
-                       << "created:" << created << "destroyed:" << destroyed
-                       << "closed:" << closed << "reparented:" << reparented
-                       << "minimized:" << minimized << "maximized:" << maximized << "restored:" << restored
-                       << "activated:" << activated << "deactivated:" << deactivated
-                       << "desktopCreated:" << desktopCreated << "desktopDestroyed:" << desktopDestroyed
-                       << "raised:" << raised << "lowered:" << lowered
-                       << "moved:" << moved << "resized:" << resized
-                       << "shaded:" << shaded << "unshaded:" << unshaded
-                       ;
-        }
-    }
-
-    if (removedListeners.testFlag(Registry::ChildrenChanged)) {
-        removedSubscriptions << QLatin1String("object:children-changed");
-    } else if (addedListeners.testFlag(Registry::ChildrenChanged)) {
-        newSubscriptions << QLatin1String("object:children-changed");
-        bool success = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Object"), QLatin1String("ChildrenChanged"),
-                    this, SLOT(slotChildrenChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        if (!success) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility ChildrenChanged events.";
-    }
-
-    if (removedListeners.testFlag(Registry::VisibleDataChanged)) {
-        removedSubscriptions << QLatin1String("object:visibledata-changed");
-    } else if (addedListeners.testFlag(Registry::VisibleDataChanged)) {
-        newSubscriptions << QLatin1String("object:visibledata-changed");
-        bool success = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Object"), QLatin1String("VisibleDataChanged"),
-                    this, SLOT(slotVisibleDataChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        if (!success) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility VisibleDataChanged events.";
-    }
-
-    if (removedListeners.testFlag(Registry::SelectionChanged)) {
-        removedSubscriptions << QLatin1String("object:selection-changed");
-    } else if (addedListeners.testFlag(Registry::SelectionChanged)) {
-        newSubscriptions << QLatin1String("object:selection-changed");
-        bool success = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Object"), QLatin1String("SelectionChanged"),
-                    this, SLOT(slotSelectionChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        if (!success) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility SelectionChanged events.";
-    }
-
-
-    if (removedListeners.testFlag(Registry::ModelChanged)) {
-        removedSubscriptions << QLatin1String("object:model-changed");
-    } else if (addedListeners.testFlag(Registry::ModelChanged)) {
-        newSubscriptions << QLatin1String("object:model-changed");
-        bool success = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Object"), QLatin1String("ModelChanged"),
-                    this, SLOT(slotModelChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        if (!success) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility ModelChanged events.";
-    }
-
-    // we need state-changed-focus for focus events
-    if ((removedListeners.testFlag(Registry::StateChanged) || removedListeners.testFlag(Registry::Focus))
-            && (!(addedListeners.testFlag(Registry::StateChanged) || addedListeners.testFlag(Registry::Focus)))) {
-        removedSubscriptions << QLatin1String("object:state-changed");
-    } else if (addedListeners.testFlag(Registry::StateChanged) || addedListeners.testFlag(Registry::Focus)) {
-        if (listeners.testFlag(Registry::Focus)) newSubscriptions << QLatin1String("focus:");
-        newSubscriptions << QLatin1String("object:state-changed");
-        bool success = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Object"), QLatin1String("StateChanged"),
-                    this, SLOT(slotStateChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        if (!success) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility Focus events.";
-    }
-
-    if (removedListeners.testFlag(Registry::TextChanged)) {
-        removedSubscriptions << QLatin1String("object:text-changed");
-    } else if (addedListeners.testFlag(Registry::TextChanged)) {
-        newSubscriptions << QLatin1String("object:text-changed");
-        bool success = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Object"), QLatin1String("TextChanged"),
-                    this, SLOT(slotTextChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        if (!success) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility TextChanged events.";
-    }
-
-    if (removedListeners.testFlag(Registry::TextCaretMoved)) {
-        removedSubscriptions << QLatin1String("object:text-caret-moved");
-    } else if (addedListeners.testFlag(Registry::TextCaretMoved)) {
-        newSubscriptions << QLatin1String("object:text-caret-moved");
-        bool success = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Object"), QLatin1String("TextCaretMoved"),
-                    this, SLOT(slotTextCaretMoved(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        if (!success) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility TextCaretMoved events.";
-    }
-
-    if (removedListeners.testFlag(Registry::TextSelectionChanged)) {
-        removedSubscriptions << QLatin1String("object:text-selection-changed");
-    } else if (addedListeners.testFlag(Registry::TextSelectionChanged)) {
-        newSubscriptions << QLatin1String("object:text-selection-changed");
-        bool success = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Object"), QLatin1String("TextSelectionChanged"),
-                    this, SLOT(slotTextSelectionChanged(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        if (!success) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility TextSelectionChanged events.";
-    }
-
-    if (removedListeners.testFlag(Registry::PropertyChanged)) {
-        removedSubscriptions << QLatin1String("object:property-change");
-    } else if (addedListeners.testFlag(Registry::PropertyChanged )) {
-        newSubscriptions << QLatin1String("object:property-change");
-        bool success = conn.connection().connect(
-                    QString(), QLatin1String(""), QLatin1String("org.a11y.atspi.Event.Object"), QLatin1String("PropertyChange"),
-                    this, SLOT(slotPropertyChange(QString,int,int,QDBusVariant,QAccessibleClient::QSpiObjectReference)));
-        if (!success) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility PropertyChange events.";
-    }
-
-    for (const QString &subscription : std::as_const(newSubscriptions)) {
-        QDBusMessage m = QDBusMessage::createMethodCall(QLatin1String("org.a11y.atspi.Registry"),
-                                                        QLatin1String("/org/a11y/atspi/registry"),
-                                                        QLatin1String("org.a11y.atspi.Registry"), QLatin1String("RegisterEvent"));
-        m.setArguments(QVariantList() << subscription);
-
-        QDBusPendingCall async = conn.connection().asyncCall(m);
-        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(async, this);
-        QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)), this, SLOT(slotSubscribeEventListenerFinished(QDBusPendingCallWatcher*)));
-    }
+    const Registry::EventListeners removedListeners = m_subscriptions & ~listeners;
 
-    for (const QString &subscription : std::as_const(removedSubscriptions)) {
-        QDBusMessage m = QDBusMessage::createMethodCall(QLatin1String("org.a11y.atspi.Registry"),
-                                                        QLatin1String("/org/a11y/atspi/registry"),
-                                                        QLatin1String("org.a11y.atspi.Registry"), QLatin1String("DeregisterEvent"));
-        m.setArguments(QVariantList() << subscription);
-        conn.connection().asyncCall(m);
-    }
+    // cached values are only trusted while the events invalidating them arrive
+    if (m_cache && (removedListeners & (Registry::PropertyChanged | Registry::ChildrenChanged)))
+        clearCachedProperties();
 
     m_subscriptions = listeners;
+    updateCachedValues();
+    updateEventConnections();
 
 // accerciser
 //     (u':1.7', u'Object:StateChanged:'),
@@ -436,6 +389,268 @@ Registry::EventListeners RegistryPrivate::eventListeners() const
     return m_subscriptions | m_pendingSubscriptions;
 }
 
+void RegistryPrivate::setEventScope(const QList<AccessibleObject> &applications, Registry::EventListeners listeners)
+{
+    const QList<Registry::EventListener> scoped = singleListeners(listeners);
+    for (const Registry::EventListener listener : scoped) {
+        if (applications.isEmpty())
+            m_eventScopes.remove(listener);
+        else
+            m_eventScopes.insert(listener, applications);
+    }
+    if (!conn.isFetchingConnection())
+        updateEventConnections();
+}
+
+QList<AccessibleObject> RegistryPrivate::eventScope(Registry::EventListener listener) const
+{
+    return m_eventScopes.value(listener);
+}
+
+bool RegistryPrivate::subscribeEventDetails(Registry::EventListener listener, const QStringList &details)
+{
+    if (!DetailedListeners.testFlag(listener)) {
+        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Events of" << listener << "cannot be limited to details.";
+        return false;
+    }
+    if (details.isEmpty())
+        m_eventDetails.remove(listener);
+    else
+        m_eventDetails.insert(listener, details);
+
+    // with only some of the events arriving the cached values cannot be trusted any longer
+    if (m_cache && !details.isEmpty() && (listener == Registry::PropertyChanged || listener == Registry::ChildrenChanged))
+        clearCachedProperties();
+    updateCachedValues();
+
+    if (!conn.isFetchingConnection())
+        updateEventConnections();
+    return true;
+}
+
+QStringList RegistryPrivate::subscribedEventDetails(Registry::EventListener listener) const
+{
+    return m_eventDetails.value(listener);
+}
+
+QStringList RegistryPrivate::eventDetails(Registry::EventListeners listeners) const
+{
+    QStringList details;
+    const QList<Registry::EventListener> subscribed = singleListeners(listeners & m_subscriptions);
+    for (const Registry::EventListener listener : subscribed) {
+        QStringList listenerDetails = m_eventDetails.value(listener);
+        // focus events are state changes of focused, defunct objects are always needed to keep the cache right
+        if (listener == Registry::Focus)
+            listenerDetails = QStringList() << EventNames::stateName(AccessibleObject::FocusedState);
+        else if (listenerDetails.isEmpty() || !DetailedListeners.testFlag(listener))
+            return QStringList();
+        if (listener == Registry::Focus || listener == Registry::StateChanged)
+            listenerDetails.append(EventNames::stateName(AccessibleObject::DefunctState));
+        for (const QString &detail : std::as_const(listenerDetails)) {
+            if (!details.contains(detail))
+                details.append(detail);
+        }
+    }
+    return details;
+}
+
+QStringList RegistryPrivate::eventScopeServices(Registry::EventListeners listeners) const
+{
+    QStringList services;
+    const QList<Registry::EventListener> scoped = singleListeners(listeners);
+    for (const Registry::EventListener listener : scoped) {
+        const auto it = m_eventScopes.constFind(listener);
+        // an empty service matches every sender
+        if (it == m_eventScopes.constEnd())
+            return QStringList(QString());
+        for (const AccessibleObject &application : it.value()) {
+            const QString service = application.d ? application.d->service() : QString();
+            if (!service.isEmpty() && !services.contains(service))
+                services.append(service);
+        }
+    }
+    return services;
+}
+
+bool RegistryPrivate::inEventScope(Registry::EventListener listener) const
+{
+    const auto it = m_sharedSlotScopes.constFind(listener);
+    return it == m_sharedSlotScopes.constEnd() || it->contains(eventService());
+}
+
+void RegistryPrivate::updateEventConnections()
+{
+    QStringList registered;
+    for (const RegistryEvent &event : registryEvents) {
+        if (!(m_subscriptions & event.listeners))
+            continue;
+        const QStringList details = event.detailed ? eventDetails(event.listeners) : QStringList();
+        if (details.isEmpty())
+            registered.append(QLatin1String(event.name));
+        for (const QString &detail : details)
+            registered.append(QLatin1String(event.name) + QLatin1Char(':') + detail);
+    }
+    for (const QString &event : std::as_const(registered)) {
+        if (m_registeredEvents.contains(event))
+            continue;
+        QDBusMessage m = QDBusMessage::createMethodCall(QLatin1String("org.a11y.atspi.Registry"),
+                                                        QLatin1String("/org/a11y/atspi/registry"),
+                                                        QLatin1String("org.a11y.atspi.Registry"), QLatin1String("RegisterEvent"));
+        m.setArguments(QVariantList() << event);
+        QDBusPendingCall async = conn.connection().asyncCall(m);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(async, this);
+        QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)), this, SLOT(slotSubscribeEventListenerFinished(QDBusPendingCallWatcher*)));
+    }
+    for (const QString &event : std::as_const(m_registeredEvents)) {
+        if (registered.contains(event))
+            continue;
+        QDBusMessage m = QDBusMessage::createMethodCall(QLatin1String("org.a11y.atspi.Registry"),
+                                                        QLatin1String("/org/a11y/atspi/registry"),
+                                                        QLatin1String("org.a11y.atspi.Registry"), QLatin1String("DeregisterEvent"));
+        m.setArguments(QVariantList() << event);
+        conn.connection().asyncCall(m);
+    }
+    m_registeredEvents = registered;
+
+    // one match rule per sender and detail, empty ones match everything
+    m_sharedSlotScopes.clear();
+    const QList<EventConnection> &connections = eventConnections();
+    for (int i = 0; i < connections.size(); ++i) {
+        const EventConnection &connection = connections.at(i);
+        QList<EventMatch> wanted;
+        if (m_subscriptions & connection.listeners) {
+            QStringList details = eventDetails(connection.listeners);
+            if (details.isEmpty())
+                details.append(QString());
+            const QStringList services = eventScopeServices(connection.listeners & m_subscriptions);
+            for (const QString &service : services) {
+                for (const QString &detail : std::as_const(details))
+                    wanted.append(EventMatch(service, detail));
+            }
+            // listeners sharing the slot with a wider scope filter the senders themselves
+            const QList<Registry::EventListener> subscribed = singleListeners(connection.listeners & m_subscriptions);
+            if (subscribed.size() > 1) {
+                for (const Registry::EventListener listener : subscribed) {
+                    const QStringList scope = eventScopeServices(listener);
+                    if (scope != services && !scope.contains(QString()))
+                        m_sharedSlotScopes.insert(listener, scope);
+                }
+            }
+        }
+
+        QObject *receiver = m_eventReceiver ? static_cast<QObject *>(m_eventReceiver) : this;
+        const char *slot = m_eventReceiver ? SLOT(receive(QDBusMessage)) : connection.slot;
+        QList<EventMatch> &connected = m_eventConnections[i];
+        for (const EventMatch &match : std::as_const(connected)) {
+            if (!wanted.contains(match))
+                conn.connection().disconnect(match.first, QLatin1String(""), QLatin1String(connection.interface), QLatin1String(connection.member),
+                                             match.second.isEmpty() ? QStringList() : QStringList(match.second), QString(),
+                                             receiver, slot);
+        }
+        for (const EventMatch &match : std::as_const(wanted)) {
+            if (connected.contains(match))
+                continue;
+            if (!conn.connection().connect(match.first, QLatin1String(""), QLatin1String(connection.interface), QLatin1String(connection.member),
+                                           match.second.isEmpty() ? QStringList() : QStringList(match.second), QString(),
+                                           receiver, slot))
+                qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to accessibility" << connection.member << "events" << match;
+        }
+        connected = wanted;
+    }
+}
+
+void RegistryPrivate::disconnectEvents()
+{
+    QObject *receiver = m_eventReceiver ? static_cast<QObject *>(m_eventReceiver) : this;
+    const QList<EventConnection> &connections = eventConnections();
+    for (auto it = m_eventConnections.cbegin(); it != m_eventConnections.cend(); ++it) {
+        const EventConnection &connection = connections.at(it.key());
+        const char *slot = m_eventReceiver ? SLOT(receive(QDBusMessage)) : connection.slot;
+        for (const EventMatch &match : it.value())
+            conn.connection().disconnect(match.first, QLatin1String(""), QLatin1String(connection.interface), QLatin1String(connection.member),
+                                         match.second.isEmpty() ? QStringList() : QStringList(match.second), QString(),
+                                         receiver, slot);
+    }
+    m_eventConnections.clear();
+}
+
+void RegistryPrivate::setEventReceiverThread(bool enabled, int capacity)
+{
+    if (enabled == bool(m_eventReceiver) && (!enabled || capacity == m_eventReceiver->capacity()))
+        return;
+
+    // the match rules are moved over to the new receiver, events still queued are handled first
+    if (!conn.isFetchingConnection())
+        disconnectEvents();
+    if (m_eventReceiver) {
+        m_eventThread->quit();
+        m_eventThread->wait();
+        slotDrainEvents();
+        delete std::exchange(m_eventReceiver, nullptr);
+        delete std::exchange(m_eventThread, nullptr);
+    }
+
+    if (enabled) {
+        QHash<std::pair<QString, QString>, int> connections;
+        const QList<EventConnection> &table = eventConnections();
+        for (int i = 0; i < table.size(); ++i)
+            connections.insert(std::make_pair(QLatin1String(table.at(i).interface), QLatin1String(table.at(i).member)), i);
+        m_eventReceiver = new EventReceiver(connections, capacity);
+        m_eventThread = new QThread;
+        m_eventThread->setObjectName(QLatin1String("QAccessibilityClient events"));
+        m_eventReceiver->moveToThread(m_eventThread);
+        connect(m_eventReceiver, SIGNAL(eventsAvailable()), this, SLOT(slotDrainEvents()));
+        m_eventThread->start();
+    }
+    m_eventsDelivered = 0;
+
+    if (!conn.isFetchingConnection())
+        updateEventConnections();
+}
+
+void RegistryPrivate::slotDrainEvents()
+{
+    if (!m_eventReceiver)
+        return;
+
+    // events lost to a full queue may have made cached values stale
+    if (m_eventReceiver->takeOverflow() && m_cache)
+        clearCachedProperties();
+
+    m_eventReceiver->resetNotification();
+    const QList<EventConnection> &connections = eventConnections();
+    EventReceiver::EventRecord record;
+    for (int drained = 0; drained < EventDrainBatch; ++drained) {
+        if (!m_eventReceiver->pop(record))
+            return;
+        ++m_eventsDelivered;
+        m_currentEvent = &record;
+        (this->*connections.at(record.connection).handler)(record.detail, record.detail1, record.detail2,
+                                                           QDBusVariant(record.any), QSpiObjectReference());
+        m_currentEvent = nullptr;
+        // a receiver may have turned the thread off
+        if (!m_eventReceiver)
+            return;
+    }
+    // the rest follows after the other events of the loop had their turn
+    if (m_eventReceiver->pending() > 0)
+        QMetaObject::invokeMethod(this, &RegistryPrivate::slotDrainEvents, Qt::QueuedConnection);
+}
+
+Registry::EventQueueStatistics RegistryPrivate::eventQueueStatistics() const
+{
+    Registry::EventQueueStatistics statistics;
+    if (!m_eventReceiver)
+        return statistics;
+    statistics.capacity = m_eventReceiver->capacity();
+    statistics.pending = m_eventReceiver->pending();
+    statistics.highWaterMark = m_eventReceiver->highWaterMark();
+    statistics.received = m_eventReceiver->received();
+    statistics.delivered = m_eventsDelivered;
+    statistics.dropped = m_eventReceiver->dropped();
+    return statistics;
+}
+
 void RegistryPrivate::slotSubscribeEventListenerFinished(QDBusPendingCallWatcher *call)
 {
     if (call->isError()) {
@@ -466,14 +681,35 @@ void RegistryPrivate::a11yConnectionChanged(const QString &interface,const QVari
 
 AccessibleObject RegistryPrivate::parentAccessible(const AccessibleObject &object) const
 {
-    QVariant parent = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("Parent"));
+    if (m_cache) {
+        const std::optional<QSpiObjectReference> parent = m_cache->parent(object);
+        if (parent)
+            return parentFromReference(object, *parent);
+    }
+
+    QVariant parent = getProperty(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("Parent"));
+    return parentFromProperty(object, parent);
+}
+
+AccessibleObject RegistryPrivate::parentFromProperty(const AccessibleObject &object, const QVariant &parent) const
+{
     if (!parent.isValid())
         return AccessibleObject();
-    const QDBusArgument arg = parent.value<QDBusArgument>();
     QSpiObjectReference ref;
-    arg >> ref;
+    if (parent.metaType() == QMetaType::fromType<QSpiObjectReference>()) {
+        ref = parent.value<QSpiObjectReference>();
+    } else {
+        const QDBusArgument arg = parent.value<QDBusArgument>();
+        arg >> ref;
+    }
+    if (cachesProperties())
+        m_cache->setParent(object, ref);
+    return parentFromReference(object, ref);
+}
 
-    if (ref.path.path() == object.d->path) {
+AccessibleObject RegistryPrivate::parentFromReference(const AccessibleObject &object, const QSpiObjectReference &ref) const
+{
+    if (ref.path.path() == object.d->path()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "WARNING: Accessible claims to be its own parent: " << object;
         return AccessibleObject();
     }
@@ -486,18 +722,26 @@ AccessibleObject RegistryPrivate::parentAccessible(const AccessibleObject &objec
 
 int RegistryPrivate::childCount(const AccessibleObject &object) const
 {
-    QVariant childCount = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("ChildCount"));
+    if (m_cache) {
+        const std::optional<int> childCount = m_cache->childCount(object);
+        if (childCount)
+            return *childCount;
+    }
+
+    QVariant childCount = getProperty(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("ChildCount"));
+    if (childCount.isValid() && cachesChildren())
+        m_cache->setChildCount(object, childCount.toInt());
     return childCount.toInt();
 }
 
 int RegistryPrivate::indexInParent(const AccessibleObject &object) const
 {
     QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetIndexInParent"));
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetIndexInParent"));
 
-    QDBusReply<int> reply = conn.connection().call(message);
+    QDBusReply<int> reply = call(message);
     if (!reply.isValid()) {
-        QDBusReply<uint> reply2 = conn.connection().call(message);
+        QDBusReply<uint> reply2 = call(message);
         if (reply2.isValid()) {
             qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Found old api returning uint in GetIndexInParent." << reply.error().message();
             return static_cast<int>(reply.value());
@@ -510,13 +754,19 @@ int RegistryPrivate::indexInParent(const AccessibleObject &object) const
 
 AccessibleObject RegistryPrivate::child(const AccessibleObject &object, int index) const
 {
+    if (m_cache) {
+        const std::optional<QSpiObjectReferenceList> children = m_cache->children(object);
+        if (children && index >= 0 && index < children->size())
+            return accessibleFromReference(children->at(index));
+    }
+
     QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetChildAtIndex"));
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetChildAtIndex"));
     QVariantList args;
     args << index;
     message.setArguments(args);
 
-    QDBusReply<QSpiObjectReference> reply = conn.connection().call(message);
+    QDBusReply<QSpiObjectReference> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access child." << reply.error().message();
         return AccessibleObject();
@@ -527,118 +777,730 @@ AccessibleObject RegistryPrivate::child(const AccessibleObject &object, int inde
 
 QList<AccessibleObject> RegistryPrivate::children(const AccessibleObject &object) const
 {
-    QList<AccessibleObject> accs;
+    if (m_cache) {
+        const std::optional<QSpiObjectReferenceList> children = m_cache->children(object);
+        if (children)
+            return accessiblesFromReferences(*children);
+    }
 
     QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetChildren"));
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetChildren"));
+
+    const QDBusMessage reply = call(message);
+    if (cachesChildren() && reply.type() == QDBusMessage::ReplyMessage) {
+        const QDBusReply<QSpiObjectReferenceList> children(reply);
+        if (children.isValid())
+            m_cache->setChildren(object, children.value());
+    }
+    return accessiblesFromReply(reply);
+}
 
-    QDBusReply<QSpiObjectReferenceList> reply = conn.connection().call(message, QDBus::Block, 500);
+QList<AccessibleObject> RegistryPrivate::accessiblesFromReply(const QDBusMessage &message) const
+{
+    QList<AccessibleObject> accs;
+
+    const QDBusReply<QSpiObjectReferenceList> reply(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access children." << reply.error().message();
         return accs;
     }
 
-    const QSpiObjectReferenceList children = reply.value();
-    for (const QSpiObjectReference &child : children) {
-        accs.append(AccessibleObject(const_cast<RegistryPrivate*>(this), child.service, child.path.path()));
-    }
+    return accessiblesFromReferences(reply.value());
+}
 
+QList<AccessibleObject> RegistryPrivate::accessiblesFromReferences(const QSpiObjectReferenceList &references) const
+{
+    QList<AccessibleObject> accs;
+    accs.reserve(references.size());
+    for (const QSpiObjectReference &reference : references) {
+        accs.append(AccessibleObject(const_cast<RegistryPrivate*>(this), reference.service, reference.path.path()));
+    }
     return accs;
 }
 
-QList<AccessibleObject> RegistryPrivate::topLevelAccessibles() const
+QList<AccessibleObject> RegistryPrivate::snapshotApplication(const AccessibleObject &application)
 {
-    QString service = QLatin1String("org.a11y.atspi.Registry");
-    QString path = QLatin1String("/org/a11y/atspi/accessible/root");
-    return children(AccessibleObject(const_cast<RegistryPrivate*>(this), service, path));
+    QList<AccessibleObject> objects;
+    if (!application.isValid())
+        return objects;
+
+    QDBusMessage message = QDBusMessage::createMethodCall (
+                application.d->service(), QLatin1String("/org/a11y/atspi/cache"), QLatin1String(ATSPI_DBUS_INTERFACE_CACHE), QLatin1String("GetItems"));
+
+    const QDBusMessage reply = call(message);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access cache items." << reply.errorMessage();
+        return objects;
+    }
+
+    QSpiAccessibleCacheArray items;
+    const QDBusArgument arg = reply.arguments().at(0).value<QDBusArgument>();
+    arg >> items;
+
+    // values of mirrored applications stay valid without the events, see mirrorApplication()
+    const bool mirrored = m_mirroredApplications.contains(application.d->service());
+
+    // Newer providers do not list the children but send the index in parent
+    // and the child count, the lists are rebuilt from that further down.
+    QHash<QString, QMap<int, QSpiObjectReference> > indexedChildren;
+    QHash<QString, int> childCounts;
+
+    objects.reserve(items.size());
+    for (QSpiAccessibleCacheItem &item : items) {
+        if (item.path.service.isEmpty())
+            item.path.service = application.d->service();
+        const AccessibleObject object = accessibleFromReference(item.path);
+        objects.append(object);
+        if (!m_cache)
+            continue;
+
+        cacheItem(object, item, mirrored);
+        if (item.childCount >= 0) {
+            childCounts.insert(object.id(), item.childCount);
+            if (item.indexInParent >= 0) {
+                const QString parentId = item.parent.path.path() + item.parent.service;
+                indexedChildren[parentId].insert(item.indexInParent, item.path);
+            }
+        }
+    }
+
+    // Only trust the rebuilt lists where every child was part of the reply.
+    for (const AccessibleObject &object : std::as_const(objects)) {
+        const auto count = childCounts.constFind(object.id());
+        if (count == childCounts.constEnd())
+            continue;
+        const QMap<int, QSpiObjectReference> children = indexedChildren.value(object.id());
+        if (children.size() == count.value() && (mirrored || cachesChildren()))
+            m_cache->setChildren(object, children.values());
+    }
+
+    return objects;
 }
 
-QString RegistryPrivate::accessibleId(const AccessibleObject &object) const
+void RegistryPrivate::cacheItem(const AccessibleObject &object, const QSpiAccessibleCacheItem &item, bool mirrored)
 {
-    if (!object.isValid())
-        return QString();
-    return getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("AccessibleId")).toString();
+    AccessibleObject::Interfaces interfaces = AccessibleObject::NoInterface;
+    for (const QString &interface : item.supportedInterfaces) {
+        interfaces |= interfaceHash.value(interface);
+    }
+    m_cache->setInterfaces(object, interfaces);
+
+    if (item.state.size() >= 2) {
+        const quint32 low = item.state.at(0);
+        const quint32 high = item.state.at(1);
+        m_cache->setState(object, low + (static_cast<quint64>(high) << 32));
+    }
+
+    if (mirrored || cachesProperties()) {
+        m_cache->setName(object, item.name);
+        m_cache->setDescription(object, item.description);
+        m_cache->setRole(object, atspiRoleToRole(static_cast<AtspiRole>(item.role)));
+        m_cache->setParent(object, item.parent);
+    }
+    if (item.childCount < 0 && (mirrored || cachesChildren()))
+        m_cache->setChildren(object, item.children);
 }
 
-QString RegistryPrivate::name(const AccessibleObject &object) const
+bool RegistryPrivate::mirrorApplication(const AccessibleObject &application)
 {
-    if (!object.isValid())
-        return QString();
-    return getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("Name")).toString();
+    if (!m_cache || !application.isValid())
+        return false;
+
+    const QString service = application.d->service();
+    if (m_mirroredApplications.contains(service))
+        return true;
+
+    // Connect first so no change gets lost between the snapshot and the subscription.
+    QDBusConnection connection = conn.connection();
+    bool added = connection.connect(
+                service, QLatin1String("/org/a11y/atspi/cache"), QLatin1String(ATSPI_DBUS_INTERFACE_CACHE), QLatin1String("AddAccessible"),
+                this, SLOT(slotCacheAddAccessible(QDBusMessage)));
+    bool removed = connection.connect(
+                service, QLatin1String("/org/a11y/atspi/cache"), QLatin1String(ATSPI_DBUS_INTERFACE_CACHE), QLatin1String("RemoveAccessible"),
+                this, SLOT(slotCacheRemoveAccessible(QDBusMessage)));
+    if (!added || !removed) {
+        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not subscribe to cache changes of" << service << "added:" << added << "removed:" << removed;
+        stopMirroring(service);
+        return false;
+    }
+
+    QSet<AccessibleObject> &objects = m_mirroredApplications[service];
+    const QList<AccessibleObject> snapshot = snapshotApplication(application);
+    for (const AccessibleObject &object : snapshot) {
+        objects.insert(object);
+    }
+
+    if (!m_mirrorWatcher) {
+        m_mirrorWatcher = new QDBusServiceWatcher(this);
+        m_mirrorWatcher->setConnection(connection);
+        m_mirrorWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+        connect(m_mirrorWatcher, SIGNAL(serviceUnregistered(QString)), this, SLOT(slotMirroredServiceUnregistered(QString)));
+    }
+    m_mirrorWatcher->addWatchedService(service);
+    return true;
 }
 
-QString RegistryPrivate::description(const AccessibleObject &object) const
+void RegistryPrivate::stopMirroring(const AccessibleObject &application)
 {
-    if (!object.isValid())
-        return QString();
-    return getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("Description")).toString();
+    if (application.isValid())
+        stopMirroring(application.d->service());
 }
 
-AccessibleObject::Role RegistryPrivate::role(const AccessibleObject &object) const
+void RegistryPrivate::stopMirroring(const QString &service)
 {
-    if (!object.isValid())
-        return AccessibleObject::NoRole;
+    QDBusConnection connection = conn.connection();
+    connection.disconnect(
+                service, QLatin1String("/org/a11y/atspi/cache"), QLatin1String(ATSPI_DBUS_INTERFACE_CACHE), QLatin1String("AddAccessible"),
+                this, SLOT(slotCacheAddAccessible(QDBusMessage)));
+    connection.disconnect(
+                service, QLatin1String("/org/a11y/atspi/cache"), QLatin1String(ATSPI_DBUS_INTERFACE_CACHE), QLatin1String("RemoveAccessible"),
+                this, SLOT(slotCacheRemoveAccessible(QDBusMessage)));
+    if (m_mirrorWatcher)
+        m_mirrorWatcher->removeWatchedService(service);
+    m_mirroredApplications.remove(service);
+}
 
-    QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetRole"));
+bool RegistryPrivate::isMirrored(const AccessibleObject &application) const
+{
+    return application.isValid() && m_mirroredApplications.contains(application.d->service());
+}
 
-    QDBusReply<uint> reply = conn.connection().call(message);
-    if (!reply.isValid()) {
-        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access role." << reply.error().message();
-        return AccessibleObject::NoRole;
+void RegistryPrivate::slotCacheAddAccessible(const QDBusMessage &message)
+{
+    const auto mirror = m_mirroredApplications.find(message.service());
+    if (mirror == m_mirroredApplications.end() || !m_cache || message.arguments().isEmpty())
+        return;
+
+    QSpiAccessibleCacheItem item;
+    const QDBusArgument arg = message.arguments().at(0).value<QDBusArgument>();
+    arg >> item;
+    if (item.path.service.isEmpty())
+        item.path.service = message.service();
+
+    const AccessibleObject object = accessibleFromReference(item.path);
+    const bool known = mirror->contains(object);
+    mirror->insert(object);
+    cacheItem(object, item, true);
+
+    // Keep the child list of the parent in step, it is only touched if already known.
+    const AccessibleObject parent = accessibleFromReference(item.parent);
+    if (parent.isValid() && mirror->contains(parent)) {
+        std::optional<QSpiObjectReferenceList> siblings = m_cache->children(parent);
+        if (siblings) {
+            siblings->removeOne(item.path);
+            if (item.indexInParent >= 0 && item.indexInParent <= siblings->size())
+                siblings->insert(item.indexInParent, item.path);
+            else
+                siblings->append(item.path);
+            m_cache->setChildren(parent, *siblings);
+        }
     }
-    return atspiRoleToRole(static_cast<AtspiRole>(reply.value()));
+
+    if (!known)
+        Q_EMIT q->added(object);
 }
 
-AccessibleObject::Role RegistryPrivate::atspiRoleToRole(AtspiRole role)
+void RegistryPrivate::slotCacheRemoveAccessible(const QDBusMessage &message)
 {
-    switch (role) {
-    case ATSPI_ROLE_INVALID: return AccessibleObject::NoRole;
-//    case ATSPI_ROLE_ACCELERATOR_LABEL: return AccessibleObject::;
-//    case ATSPI_ROLE_ALERT: return AccessibleObject::;
-//    case ATSPI_ROLE_ANIMATION: return AccessibleObject::;
-//    case ATSPI_ROLE_ARROW: return AccessibleObject::;
-//    case ATSPI_ROLE_CALENDAR: return AccessibleObject::;
-//    case ATSPI_ROLE_CANVAS: return AccessibleObject::;
-    case ATSPI_ROLE_CHECK_BOX: return AccessibleObject::CheckBox;
-    case ATSPI_ROLE_CHECK_MENU_ITEM: return AccessibleObject::CheckableMenuItem;
-//    case ATSPI_ROLE_COLOR_CHOOSER: return AccessibleObject::;
-    case ATSPI_ROLE_COLUMN_HEADER: return AccessibleObject::ColumnHeader;
-    case ATSPI_ROLE_COMBO_BOX: return AccessibleObject::ComboBox;
-//    case ATSPI_ROLE_DATE_EDITOR: return AccessibleObject::;
-//    case ATSPI_ROLE_DESKTOP_ICON: return AccessibleObject::;
-    case ATSPI_ROLE_DESKTOP_FRAME: return AccessibleObject::DesktopFrame;
-//    case ATSPI_ROLE_DIAL: return AccessibleObject::;
-    case ATSPI_ROLE_DIALOG: return AccessibleObject::Dialog;
-//    case ATSPI_ROLE_DIRECTORY_PANE: return AccessibleObject::;
-//    case ATSPI_ROLE_DRAWING_AREA: return AccessibleObject::;
-//    case ATSPI_ROLE_FILE_CHOOSER: return AccessibleObject::;
-    case ATSPI_ROLE_FILLER: return AccessibleObject::Filler;
-//    case ATSPI_ROLE_FOCUS_TRAVERSABLE: return AccessibleObject::;
-//    case ATSPI_ROLE_FONT_CHOOSER: return AccessibleObject::;
-    case ATSPI_ROLE_FRAME: return AccessibleObject::Frame;
-//    case ATSPI_ROLE_GLASS_PANE: return AccessibleObject::;
-//    case ATSPI_ROLE_HTML_CONTAINER: return AccessibleObject::;
-    case ATSPI_ROLE_ICON: return AccessibleObject::Icon;
-//    case ATSPI_ROLE_IMAGE: return AccessibleObject::;
-//    case ATSPI_ROLE_INTERNAL_FRAME: return AccessibleObject::;
-    case ATSPI_ROLE_LABEL: return AccessibleObject::Label;
-//    case ATSPI_ROLE_LAYERED_PANE: return AccessibleObject::;
-    case ATSPI_ROLE_LIST: return AccessibleObject::ListView;
-    case ATSPI_ROLE_LIST_ITEM: return AccessibleObject::ListItem;
-    case ATSPI_ROLE_MENU: return AccessibleObject::Menu;
-    case ATSPI_ROLE_MENU_BAR: return AccessibleObject::MenuBar;
-    case ATSPI_ROLE_MENU_ITEM: return AccessibleObject::MenuItem;
-//    case ATSPI_ROLE_OPTION_PANE: return AccessibleObject::;
-    case ATSPI_ROLE_PAGE_TAB: return AccessibleObject::Tab;
-    case ATSPI_ROLE_PAGE_TAB_LIST: return AccessibleObject::TabContainer;
-//    case ATSPI_ROLE_PANEL: return AccessibleObject::;
-    case ATSPI_ROLE_PASSWORD_TEXT: return AccessibleObject::PasswordText;
-    case ATSPI_ROLE_POPUP_MENU: return AccessibleObject::PopupMenu;
-    case ATSPI_ROLE_PROGRESS_BAR: return AccessibleObject::ProgressBar;
-    case ATSPI_ROLE_PUSH_BUTTON: return AccessibleObject::Button;
-    case ATSPI_ROLE_RADIO_BUTTON: return AccessibleObject::RadioButton;
-    case ATSPI_ROLE_RADIO_MENU_ITEM: return AccessibleObject::RadioMenuItem;
+    const auto mirror = m_mirroredApplications.find(message.service());
+    if (mirror == m_mirroredApplications.end() || !m_cache || message.arguments().isEmpty())
+        return;
+
+    QSpiObjectReference reference;
+    const QDBusArgument arg = message.arguments().at(0).value<QDBusArgument>();
+    arg >> reference;
+    if (reference.service.isEmpty())
+        reference.service = message.service();
+
+    const AccessibleObject object = accessibleFromReference(reference);
+    const std::optional<QSpiObjectReference> parentReference = m_cache->parent(object);
+    if (parentReference) {
+        const AccessibleObject parent = accessibleFromReference(*parentReference);
+        std::optional<QSpiObjectReferenceList> siblings = m_cache->children(parent);
+        if (siblings && siblings->removeOne(reference))
+            m_cache->setChildren(parent, *siblings);
+    }
+
+    mirror->remove(object);
+    removeAccessibleObject(object);
+}
+
+void RegistryPrivate::slotNameOwnerChanged(const QString &name, const QString &oldOwner, const QString &newOwner)
+{
+    Q_UNUSED(oldOwner)
+    if (newOwner.isEmpty())
+        m_identities.removeService(name);
+}
+
+void RegistryPrivate::slotMirroredServiceUnregistered(const QString &service)
+{
+    m_mirroredApplications.remove(service);
+    if (m_mirrorWatcher)
+        m_mirrorWatcher->removeWatchedService(service);
+}
+
+Registry::QueryResult RegistryPrivate::query(const QList<AccessibleObject> &objects, Registry::QueryFields fields) const
+{
+    Registry::QueryResult result;
+    result.objects = objects;
+    result.fields = fields;
+
+    const int count = objects.size();
+    if (fields.testFlag(Registry::QueryName))
+        result.names = QList<QString>(count);
+    if (fields.testFlag(Registry::QueryDescription))
+        result.descriptions = QList<QString>(count);
+    if (fields.testFlag(Registry::QueryRole))
+        result.roles = QList<AccessibleObject::Role>(count, AccessibleObject::NoRole);
+    if (fields.testFlag(Registry::QueryChildCount))
+        result.childCounts = QList<int>(count, 0);
+    if (fields.testFlag(Registry::QueryState))
+        result.states = QList<quint64>(count, 0);
+    if (fields.testFlag(Registry::QueryInterfaces))
+        result.interfaces = QList<AccessibleObject::Interfaces>(count, AccessibleObject::NoInterface);
+    if (fields.testFlag(Registry::QueryBoundingRect))
+        result.boundingRects = QList<QRect>(count);
+
+    struct PendingQuery {
+        Registry::QueryField field;
+        int index;
+        QDBusMessage message;
+        // when the call was sent, the latency of each call counts from its own send
+        qint64 sent;
+        QDBusPendingCall call;
+    };
+    std::vector<PendingQuery> pending;
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    auto send = [&](Registry::QueryField field, int index, const QString &interface, const QString &method, const QVariantList &args) {
+        const AccessibleObject &object = objects.at(index);
+        QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), interface, method);
+        message.setArguments(args);
+        pending.push_back(PendingQuery{field, index, message, elapsed.nsecsElapsed(), pendingCall(message)});
+    };
+    const QString accessibleInterface = QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE);
+    const QString propertiesInterface = QLatin1String("org.freedesktop.DBus.Properties");
+
+    // first send everything that is not known yet ...
+    for (int i = 0; i < count; ++i) {
+        const AccessibleObject &object = objects.at(i);
+        if (!object.isValid())
+            continue;
+
+        if (fields.testFlag(Registry::QueryName)) {
+            std::optional<QString> name = m_cache ? m_cache->name(object) : std::nullopt;
+            const QVariant prefetched = prefetchedProperty(object, accessibleInterface, QLatin1String("Name"));
+            if (name)
+                result.names[i] = *name;
+            else if (prefetched.isValid())
+                result.names[i] = prefetched.toString();
+            else
+                send(Registry::QueryName, i, propertiesInterface, QLatin1String("Get"), QVariantList() << accessibleInterface << QLatin1String("Name"));
+        }
+        if (fields.testFlag(Registry::QueryDescription)) {
+            std::optional<QString> description = m_cache ? m_cache->description(object) : std::nullopt;
+            const QVariant prefetched = prefetchedProperty(object, accessibleInterface, QLatin1String("Description"));
+            if (description)
+                result.descriptions[i] = *description;
+            else if (prefetched.isValid())
+                result.descriptions[i] = prefetched.toString();
+            else
+                send(Registry::QueryDescription, i, propertiesInterface, QLatin1String("Get"), QVariantList() << accessibleInterface << QLatin1String("Description"));
+        }
+        if (fields.testFlag(Registry::QueryRole)) {
+            std::optional<AccessibleObject::Role> role = m_cache ? m_cache->role(object) : std::nullopt;
+            if (role)
+                result.roles[i] = *role;
+            else
+                send(Registry::QueryRole, i, accessibleInterface, QLatin1String("GetRole"), QVariantList());
+        }
+        if (fields.testFlag(Registry::QueryChildCount)) {
+            std::optional<int> childCount = m_cache ? m_cache->childCount(object) : std::nullopt;
+            const QVariant prefetched = prefetchedProperty(object, accessibleInterface, QLatin1String("ChildCount"));
+            if (childCount)
+                result.childCounts[i] = *childCount;
+            else if (prefetched.isValid())
+                result.childCounts[i] = prefetched.toInt();
+            else
+                send(Registry::QueryChildCount, i, propertiesInterface, QLatin1String("Get"), QVariantList() << accessibleInterface << QLatin1String("ChildCount"));
+        }
+        if (fields.testFlag(Registry::QueryState)) {
+            const quint64 state = m_cache ? m_cache->state(object) : ObjectCache::StateNotFound;
+            if (state != ObjectCache::StateNotFound)
+                result.states[i] = state;
+            else
+                send(Registry::QueryState, i, accessibleInterface, QLatin1String("GetState"), QVariantList());
+        }
+        if (fields.testFlag(Registry::QueryInterfaces)) {
+            const AccessibleObject::Interfaces interfaces = m_cache ? m_cache->interfaces(object) : AccessibleObject::Interfaces(AccessibleObject::InvalidInterface);
+            if (!(interfaces & AccessibleObject::InvalidInterface))
+                result.interfaces[i] = interfaces;
+            else
+                send(Registry::QueryInterfaces, i, accessibleInterface, QLatin1String("GetInterfaces"), QVariantList());
+        }
+        if (fields.testFlag(Registry::QueryBoundingRect)) {
+            send(Registry::QueryBoundingRect, i, QLatin1String(ATSPI_DBUS_INTERFACE_COMPONENT), QLatin1String("GetExtents"),
+                 QVariantList() << quint32(ATSPI_COORD_TYPE_SCREEN));
+        }
+    }
+
+    // ... then collect the replies, most of them arrived while we were still sending
+    int failed = 0;
+    for (PendingQuery &request : pending) {
+        request.call.waitForFinished();
+        const QDBusMessage reply = request.call.reply();
+        recordCallResult(request.message, reply, (elapsed.nsecsElapsed() - request.sent) / 1000);
+        if (reply.type() != QDBusMessage::ReplyMessage) {
+            ++failed;
+            continue;
+        }
+        const AccessibleObject &object = objects.at(request.index);
+
+        switch (request.field) {
+        case Registry::QueryName: {
+            const QString name = propertyFromReply(reply).toString();
+            result.names[request.index] = name;
+            if (cachesProperties())
+                m_cache->setName(object, name);
+            break;
+        }
+        case Registry::QueryDescription: {
+            const QString description = propertyFromReply(reply).toString();
+            result.descriptions[request.index] = description;
+            if (cachesProperties())
+                m_cache->setDescription(object, description);
+            break;
+        }
+        case Registry::QueryRole: {
+            const QDBusReply<uint> role(reply);
+            if (!role.isValid())
+                break;
+            result.roles[request.index] = atspiRoleToRole(static_cast<AtspiRole>(role.value()));
+            if (cachesProperties())
+                m_cache->setRole(object, result.roles.at(request.index));
+            break;
+        }
+        case Registry::QueryChildCount: {
+            const int childCount = propertyFromReply(reply).toInt();
+            result.childCounts[request.index] = childCount;
+            if (cachesChildren())
+                m_cache->setChildCount(object, childCount);
+            break;
+        }
+        case Registry::QueryState: {
+            const QDBusReply<QVector<quint32> > state(reply);
+            if (!state.isValid() || state.value().size() < 2)
+                break;
+            const quint32 low = state.value().at(0);
+            const quint32 high = state.value().at(1);
+            result.states[request.index] = low + (static_cast<quint64>(high) << 32);
+            if (m_cache)
+                m_cache->setState(object, result.states.at(request.index));
+            break;
+        }
+        case Registry::QueryInterfaces: {
+            const QDBusReply<QStringList> names(reply);
+            if (!names.isValid())
+                break;
+            AccessibleObject::Interfaces interfaces = AccessibleObject::NoInterface;
+            const auto values{names.value()};
+            for (const QString &interface : values)
+                interfaces |= interfaceHash.value(interface);
+            result.interfaces[request.index] = interfaces;
+            if (m_cache)
+                m_cache->setInterfaces(object, interfaces);
+            break;
+        }
+        case Registry::QueryBoundingRect: {
+            const QDBusReply<QRect> rect(reply);
+            if (rect.isValid())
+                result.boundingRects[request.index] = rect.value();
+            break;
+        }
+        }
+    }
+
+    if (failed)
+        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Query failed for" << failed << "of" << pending.size() << "requests.";
+
+    return result;
+}
+
+QList<AccessibleObject> RegistryPrivate::findMatches(const AccessibleObject &object, const QList<AccessibleObject::Role> &roles,
+                                                     const QList<AccessibleObject::State> &states, AccessibleObject::Interfaces interfaces,
+                                                     const QMap<QString, QString> &attributes, int depth, int limit) const
+{
+    QList<AccessibleObject> matches;
+    if (!object.isValid() || depth == 0)
+        return matches;
+
+    if ((depth == -1 || depth == 1) && supportedInterfaces(object).testFlag(AccessibleObject::CollectionInterface)) {
+        if (collectionMatches(object, roles, states, interfaces, attributes, depth, limit, &matches))
+            return matches;
+    }
+
+    quint64 stateBits = 0;
+    for (AccessibleObject::State state : states)
+        stateBits |= quint64(1) << state;
+    walkMatches(object, roles, stateBits, interfaces, attributes, depth, limit, &matches);
+    return matches;
+}
+
+bool RegistryPrivate::collectionMatches(const AccessibleObject &object, const QList<AccessibleObject::Role> &roles,
+                                        const QList<AccessibleObject::State> &states, AccessibleObject::Interfaces interfaces,
+                                        const QMap<QString, QString> &attributes, int depth, int limit, QList<AccessibleObject> *matches) const
+{
+    // the rule is a struct (aiia{ss}iaiiasib), the sets are bit arrays of 32 bit words
+    QList<int> stateSet(2, 0);
+    for (AccessibleObject::State state : states)
+        stateSet[state / 32] |= int(1u << (state % 32));
+
+    QList<int> roleSet((ATSPI_ROLE_LAST_DEFINED + 31) / 32, 0);
+    if (!roles.isEmpty()) {
+        // several at-spi roles can map to the same Role
+        for (int role = 0; role < ATSPI_ROLE_LAST_DEFINED; ++role) {
+            if (roles.contains(atspiRoleToRole(static_cast<AtspiRole>(role))))
+                roleSet[role / 32] |= int(1u << (role % 32));
+        }
+    }
+
+    QStringList interfaceNames;
+    for (auto it = interfaceHash.constBegin(); it != interfaceHash.constEnd(); ++it) {
+        if (interfaces.testFlag(it.value()))
+            interfaceNames << it.key();
+    }
+
+    QDBusArgument rule;
+    rule.beginStructure();
+    rule << stateSet << int(ATSPI_Collection_MATCH_ALL);
+    rule << attributes << int(ATSPI_Collection_MATCH_ALL);
+    rule << roleSet << int(ATSPI_Collection_MATCH_ANY);
+    rule << interfaceNames << int(ATSPI_Collection_MATCH_ALL);
+    rule << false;
+    rule.endStructure();
+
+    QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String(ATSPI_DBUS_INTERFACE_COLLECTION), QLatin1String("GetMatches"));
+    message.setArguments(QVariantList() << QVariant::fromValue(rule) << quint32(ATSPI_Collection_SORT_ORDER_CANONICAL)
+                         << limit << (depth == -1));
+
+    const QDBusMessage reply = call(message);
+    if (reply.type() != QDBusMessage::ReplyMessage) {
+        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Collection.GetMatches failed, walking the tree instead." << reply.errorMessage();
+        return false;
+    }
+    *matches = accessiblesFromReply(reply);
+    return true;
+}
+
+void RegistryPrivate::walkMatches(const AccessibleObject &object, const QList<AccessibleObject::Role> &roles,
+                                  quint64 states, AccessibleObject::Interfaces interfaces,
+                                  const QMap<QString, QString> &attributes, int depth, int limit, QList<AccessibleObject> *matches) const
+{
+    const QList<AccessibleObject> candidates = children(object);
+    if (candidates.isEmpty())
+        return;
+
+    Registry::QueryFields fields;
+    if (!roles.isEmpty())
+        fields |= Registry::QueryRole;
+    if (states)
+        fields |= Registry::QueryState;
+    if (interfaces)
+        fields |= Registry::QueryInterfaces;
+    if (depth != 1)
+        fields |= Registry::QueryChildCount;
+    const Registry::QueryResult result = query(candidates, fields);
+
+    for (int i = 0; i < candidates.size(); ++i) {
+        const AccessibleObject &candidate = candidates.at(i);
+        bool match = (roles.isEmpty() || roles.contains(result.roles.at(i)))
+                && (!states || (result.states.at(i) & states) == states)
+                && (!interfaces || (result.interfaces.at(i) & interfaces) == interfaces);
+        if (match && !attributes.isEmpty()) {
+            const QMap<QString, QString> candidateAttributes = this->attributes(candidate);
+            for (auto it = attributes.constBegin(); match && it != attributes.constEnd(); ++it)
+                match = candidateAttributes.value(it.key()) == it.value();
+        }
+        if (match) {
+            matches->append(candidate);
+            if (limit > 0 && matches->size() >= limit)
+                return;
+        }
+        if (depth != 1 && result.childCounts.at(i) > 0) {
+            walkMatches(candidate, roles, states, interfaces, attributes, depth == -1 ? -1 : depth - 1, limit, matches);
+            if (limit > 0 && matches->size() >= limit)
+                return;
+        }
+    }
+}
+
+QMap<QString, QString> RegistryPrivate::attributes(const AccessibleObject &object) const
+{
+    QMap<QString, QString> attributes;
+    QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE), QLatin1String("GetAttributes"));
+
+    const QDBusMessage reply = call(message);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access attributes." << reply.errorMessage();
+        return attributes;
+    }
+    const QDBusArgument arg = reply.arguments().at(0).value<QDBusArgument>();
+    arg >> attributes;
+    return attributes;
+}
+
+QList<AccessibleObject> RegistryPrivate::topLevelAccessibles() const
+{
+    QString service = QLatin1String("org.a11y.atspi.Registry");
+    QString path = QLatin1String("/org/a11y/atspi/accessible/root");
+    return children(AccessibleObject(const_cast<RegistryPrivate*>(this), service, path));
+}
+
+QString RegistryPrivate::accessibleId(const AccessibleObject &object) const
+{
+    if (!object.isValid())
+        return QString();
+    return getProperty(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("AccessibleId")).toString();
+}
+
+QString RegistryPrivate::name(const AccessibleObject &object) const
+{
+    if (!object.isValid())
+        return QString();
+    if (m_cache) {
+        const std::optional<QString> name = m_cache->name(object);
+        if (name)
+            return *name;
+    }
+    const QVariant name = getProperty(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("Name"));
+    if (name.isValid() && cachesProperties())
+        m_cache->setName(object, name.toString());
+    return name.toString();
+}
+
+QString RegistryPrivate::description(const AccessibleObject &object) const
+{
+    if (!object.isValid())
+        return QString();
+    if (m_cache) {
+        const std::optional<QString> description = m_cache->description(object);
+        if (description)
+            return *description;
+    }
+    const QVariant description = getProperty(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("Description"));
+    if (description.isValid() && cachesProperties())
+        m_cache->setDescription(object, description.toString());
+    return description.toString();
+}
+
+AccessibleObject::Role RegistryPrivate::role(const AccessibleObject &object) const
+{
+    if (!object.isValid())
+        return AccessibleObject::NoRole;
+    if (m_cache) {
+        const std::optional<AccessibleObject::Role> role = m_cache->role(object);
+        if (role)
+            return *role;
+    }
+
+    QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetRole"));
+
+    QDBusReply<uint> reply = call(message);
+    if (!reply.isValid()) {
+        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access role." << reply.error().message();
+        return AccessibleObject::NoRole;
+    }
+    const AccessibleObject::Role role = atspiRoleToRole(static_cast<AtspiRole>(reply.value()));
+    if (cachesProperties())
+        m_cache->setRole(object, role);
+    return role;
+}
+
+void RegistryPrivate::clearCachedProperties()
+{
+    // mirrored applications are kept in sync by their cache signals, not by the events
+    QSet<quint32> mirrored;
+    for (auto it = m_mirroredApplications.cbegin(); it != m_mirroredApplications.cend(); ++it) {
+        if (const std::optional<quint32> key = m_identities.findService(it.key()))
+            mirrored.insert(*key);
+    }
+    m_cache->clearProperties(mirrored);
+}
+
+void RegistryPrivate::updateCachedValues()
+{
+    // without the events there is nothing that would tell us the value got stale
+    int cached = 0;
+    if (m_cache && m_subscriptions.testFlag(Registry::PropertyChanged) && !m_eventDetails.contains(Registry::PropertyChanged))
+        cached |= CachedProperties;
+    if (m_cache && m_subscriptions.testFlag(Registry::ChildrenChanged) && !m_eventDetails.contains(Registry::ChildrenChanged))
+        cached |= CachedChildren;
+    m_cachedValues.storeRelease(cached);
+}
+
+bool RegistryPrivate::cachesProperties() const
+{
+    return m_cachedValues.loadAcquire() & CachedProperties;
+}
+
+bool RegistryPrivate::cachesChildren() const
+{
+    return m_cachedValues.loadAcquire() & CachedChildren;
+}
+
+AccessibleObject::Role RegistryPrivate::atspiRoleToRole(AtspiRole role)
+{
+    switch (role) {
+    case ATSPI_ROLE_INVALID: return AccessibleObject::NoRole;
+//    case ATSPI_ROLE_ACCELERATOR_LABEL: return AccessibleObject::;
+//    case ATSPI_ROLE_ALERT: return AccessibleObject::;
+//    case ATSPI_ROLE_ANIMATION: return AccessibleObject::;
+//    case ATSPI_ROLE_ARROW: return AccessibleObject::;
+//    case ATSPI_ROLE_CALENDAR: return AccessibleObject::;
+//    case ATSPI_ROLE_CANVAS: return AccessibleObject::;
+    case ATSPI_ROLE_CHECK_BOX: return AccessibleObject::CheckBox;
+    case ATSPI_ROLE_CHECK_MENU_ITEM: return AccessibleObject::CheckableMenuItem;
+//    case ATSPI_ROLE_COLOR_CHOOSER: return AccessibleObject::;
+    case ATSPI_ROLE_COLUMN_HEADER: return AccessibleObject::ColumnHeader;
+    case ATSPI_ROLE_COMBO_BOX: return AccessibleObject::ComboBox;
+//    case ATSPI_ROLE_DATE_EDITOR: return AccessibleObject::;
+//    case ATSPI_ROLE_DESKTOP_ICON: return AccessibleObject::;
+    case ATSPI_ROLE_DESKTOP_FRAME: return AccessibleObject::DesktopFrame;
+//    case ATSPI_ROLE_DIAL: return AccessibleObject::;
+    case ATSPI_ROLE_DIALOG: return AccessibleObject::Dialog;
+//    case ATSPI_ROLE_DIRECTORY_PANE: return AccessibleObject::;
+//    case ATSPI_ROLE_DRAWING_AREA: return AccessibleObject::;
+//    case ATSPI_ROLE_FILE_CHOOSER: return AccessibleObject::;
+    case ATSPI_ROLE_FILLER: return AccessibleObject::Filler;
+//    case ATSPI_ROLE_FOCUS_TRAVERSABLE: return AccessibleObject::;
+//    case ATSPI_ROLE_FONT_CHOOSER: return AccessibleObject::;
+    case ATSPI_ROLE_FRAME: return AccessibleObject::Frame;
+//    case ATSPI_ROLE_GLASS_PANE: return AccessibleObject::;
+//    case ATSPI_ROLE_HTML_CONTAINER: return AccessibleObject::;
+    case ATSPI_ROLE_ICON: return AccessibleObject::Icon;
+//    case ATSPI_ROLE_IMAGE: return AccessibleObject::;
+//    case ATSPI_ROLE_INTERNAL_FRAME: return AccessibleObject::;
+    case ATSPI_ROLE_LABEL: return AccessibleObject::Label;
+//    case ATSPI_ROLE_LAYERED_PANE: return AccessibleObject::;
+    case ATSPI_ROLE_LIST: return AccessibleObject::ListView;
+    case ATSPI_ROLE_LIST_ITEM: return AccessibleObject::ListItem;
+    case ATSPI_ROLE_MENU: return AccessibleObject::Menu;
+    case ATSPI_ROLE_MENU_BAR: return AccessibleObject::MenuBar;
+    case ATSPI_ROLE_MENU_ITEM: return AccessibleObject::MenuItem;
+//    case ATSPI_ROLE_OPTION_PANE: return AccessibleObject::;
+    case ATSPI_ROLE_PAGE_TAB: return AccessibleObject::Tab;
+    case ATSPI_ROLE_PAGE_TAB_LIST: return AccessibleObject::TabContainer;
+//    case ATSPI_ROLE_PANEL: return AccessibleObject::;
+    case ATSPI_ROLE_PASSWORD_TEXT: return AccessibleObject::PasswordText;
+    case ATSPI_ROLE_POPUP_MENU: return AccessibleObject::PopupMenu;
+    case ATSPI_ROLE_PROGRESS_BAR: return AccessibleObject::ProgressBar;
+    case ATSPI_ROLE_PUSH_BUTTON: return AccessibleObject::Button;
+    case ATSPI_ROLE_RADIO_BUTTON: return AccessibleObject::RadioButton;
+    case ATSPI_ROLE_RADIO_MENU_ITEM: return AccessibleObject::RadioMenuItem;
 //    case ATSPI_ROLE_ROOT_PANE: return AccessibleObject::;
     case ATSPI_ROLE_ROW_HEADER: return AccessibleObject::RowHeader;
     case ATSPI_ROLE_SCROLL_BAR: return AccessibleObject::ScrollBar;
@@ -704,9 +1566,9 @@ AccessibleObject::Role RegistryPrivate::atspiRoleToRole(AtspiRole role)
 QString RegistryPrivate::roleName(const AccessibleObject &object) const
 {
     QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetRoleName"));
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetRoleName"));
 
-    QDBusReply<QString> reply = conn.connection().call(message);
+    QDBusReply<QString> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access roleName." << reply.error().message();
         return QString();
@@ -717,9 +1579,9 @@ QString RegistryPrivate::roleName(const AccessibleObject &object) const
 QString RegistryPrivate::localizedRoleName(const AccessibleObject &object) const
 {
     QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetLocalizedRoleName"));
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetLocalizedRoleName"));
 
-    QDBusReply<QString> reply = conn.connection().call(message);
+    QDBusReply<QString> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access localizedRoleName." << reply.error().message();\
         return QString();
@@ -736,9 +1598,9 @@ quint64 RegistryPrivate::state(const AccessibleObject &object) const
     }
 
     QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetState"));
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetState"));
 
-    QDBusReply<QVector<quint32> > reply = conn.connection().call(message);
+    QDBusReply<QVector<quint32> > reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access state." << reply.error().message();
         return 0;
@@ -761,8 +1623,8 @@ quint64 RegistryPrivate::state(const AccessibleObject &object) const
 int RegistryPrivate::layer(const AccessibleObject &object) const
 {
     QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetLayer"));
-    QDBusReply<uint> reply = conn.connection().call(message);
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetLayer"));
+    QDBusReply<uint> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access layer." << reply.error().message();
         return 1;
@@ -773,8 +1635,8 @@ int RegistryPrivate::layer(const AccessibleObject &object) const
 int RegistryPrivate::mdiZOrder(const AccessibleObject &object) const
 {
     QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetMDIZOrder"));
-    QDBusReply<short> reply = conn.connection().call(message);
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetMDIZOrder"));
+    QDBusReply<short> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access mdiZOrder." << reply.error().message();
         return 0;
@@ -785,8 +1647,8 @@ int RegistryPrivate::mdiZOrder(const AccessibleObject &object) const
 double RegistryPrivate::alpha(const AccessibleObject &object) const
 {
     QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetAlpha"));
-    QDBusReply<double> reply = conn.connection().call(message);
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetAlpha"));
+    QDBusReply<double> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access alpha." << reply.error().message();
         return 1.0;
@@ -797,13 +1659,13 @@ double RegistryPrivate::alpha(const AccessibleObject &object) const
 QRect RegistryPrivate::boundingRect(const AccessibleObject &object) const
 {
     QDBusMessage message = QDBusMessage::createMethodCall(
-            object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetExtents") );
+            object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetExtents") );
     QVariantList args;
     quint32 coords = ATSPI_COORD_TYPE_SCREEN;
     args << coords;
     message.setArguments(args);
 
-    QDBusReply< QRect > reply = conn.connection().call(message);
+    QDBusReply< QRect > reply = call(message);
     if(!reply.isValid()){
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get extents." << reply.error().message();
         return QRect();
@@ -815,7 +1677,7 @@ QRect RegistryPrivate::boundingRect(const AccessibleObject &object) const
 QRect RegistryPrivate::characterRect(const AccessibleObject &object, int offset) const
 {
     QDBusMessage message = QDBusMessage::createMethodCall(
-            object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"),
+            object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"),
                     QLatin1String("GetCharacterExtents"));
 
     QVariantList args;
@@ -825,10 +1687,10 @@ QRect RegistryPrivate::characterRect(const AccessibleObject &object, int offset)
     message.setArguments(args);
 
 
-    QDBusReply< QRect > reply = conn.connection().call(message);
+    QDBusReply< QRect > reply = call(message);
     if(!reply.isValid()){
         if (reply.error().type() == QDBusError::InvalidSignature) {
-            QDBusMessage reply2 = conn.connection().call(message);
+            QDBusMessage reply2 = call(message);
             if (reply2.signature() != QLatin1String("iiii")) {
                 qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get Character Extents. " << reply.error().message();
                 return QRect();
@@ -851,10 +1713,10 @@ AccessibleObject::Interfaces RegistryPrivate::supportedInterfaces(const Accessib
     }
 
     QDBusMessage message = QDBusMessage::createMethodCall(
-            object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"),
+            object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"),
                     QLatin1String("GetInterfaces"));
 
-    QDBusReply<QStringList > reply = conn.connection().call(message);
+    QDBusReply<QStringList > reply = call(message);
     if(!reply.isValid()){
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get Interfaces. " << reply.error().message();
         return AccessibleObject::NoInterface;
@@ -875,14 +1737,14 @@ AccessibleObject::Interfaces RegistryPrivate::supportedInterfaces(const Accessib
 
 int RegistryPrivate::caretOffset(const AccessibleObject &object) const
 {
-    QVariant offset= getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("CaretOffset"));
+    QVariant offset= getProperty(object, QLatin1String("org.a11y.atspi.Text"), QLatin1String("CaretOffset"));
     if (offset.isNull()) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get caret offset";
     return offset.toInt();
 }
 
 int RegistryPrivate::characterCount(const AccessibleObject &object) const
 {
-    QVariant count = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("CharacterCount"));
+    QVariant count = getProperty(object, QLatin1String("org.a11y.atspi.Text"), QLatin1String("CharacterCount"));
     if (count.isNull()) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get character count";
     return count.toInt();
 }
@@ -890,17 +1752,17 @@ int RegistryPrivate::characterCount(const AccessibleObject &object) const
 QList< QPair<int,int> > RegistryPrivate::textSelections(const AccessibleObject &object) const
 {
     QList< QPair<int,int> > result;
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetNSelections"));
-    QDBusReply<int> reply = conn.connection().call(message);
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetNSelections"));
+    QDBusReply<int> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access GetNSelections." << reply.error().message();
         return result;
     }
     int count = reply.value();
     for(int i = 0; i < count; ++i) {
-        QDBusMessage m = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetSelection"));
+        QDBusMessage m = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetSelection"));
         m.setArguments(QVariantList() << i);
-        m = conn.connection().call(m);
+        m = call(m);
         QList<QVariant> args = m.arguments();
         if (args.count() < 2) {
             qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Invalid number of arguments. Expected=2 Actual=" << args.count();
@@ -917,8 +1779,8 @@ QList< QPair<int,int> > RegistryPrivate::textSelections(const AccessibleObject &
 
 void RegistryPrivate::setTextSelections(const AccessibleObject &object, const QList< QPair<int,int> > &selections)
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetNSelections"));
-    QDBusReply<int> reply = conn.connection().call(message);
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetNSelections"));
+    QDBusReply<int> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access GetNSelections." << reply.error().message();
         return;
@@ -928,9 +1790,9 @@ void RegistryPrivate::setTextSelections(const AccessibleObject &object, const QL
     for(int i = 0; i < setSel; ++i) {
         Q_ASSERT(i < selections.count());
         QPair<int,int> p = selections[i];
-        QDBusMessage m = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("SetSelection"));
+        QDBusMessage m = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("SetSelection"));
         m.setArguments(QVariantList() << i << p.first << p.second);
-        QDBusReply<bool> r = conn.connection().call(m);
+        QDBusReply<bool> r = call(m);
         if (!r.isValid()) {
             qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Failed call text.SetSelection." << r.error().message();
             continue;
@@ -938,9 +1800,9 @@ void RegistryPrivate::setTextSelections(const AccessibleObject &object, const QL
     }
     int removeSel = qMax(0, count - selections.count());
     for(int i = 0, k = selections.count(); i < removeSel; ++i, ++k) {
-        QDBusMessage m = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("RemoveSelection"));
+        QDBusMessage m = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("RemoveSelection"));
         m.setArguments(QVariantList() << k);
-        QDBusReply<bool> r = conn.connection().call(m);
+        QDBusReply<bool> r = call(m);
         if (!r.isValid()) {
             qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Failed call text.RemoveSelection." << r.error().message();
             continue;
@@ -950,9 +1812,9 @@ void RegistryPrivate::setTextSelections(const AccessibleObject &object, const QL
     for(int i = 0, k = count; i < addSel; ++i, ++k) {
         Q_ASSERT(k < selections.count());
         QPair<int,int> p = selections[k];
-        QDBusMessage m = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("AddSelection"));
+        QDBusMessage m = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("AddSelection"));
         m.setArguments(QVariantList() << p.first << p.second);
-        QDBusReply<bool> r = conn.connection().call(m);
+        QDBusReply<bool> r = call(m);
         if (!r.isValid()) {
             qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Failed call text.AddSelection." << r.error().message();
             continue;
@@ -962,9 +1824,9 @@ void RegistryPrivate::setTextSelections(const AccessibleObject &object, const QL
 
 QString RegistryPrivate::text(const AccessibleObject &object, int startOffset, int endOffset) const
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetText"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetText"));
     message.setArguments(QVariantList() << startOffset << endOffset);
-    QDBusReply<QString> reply = conn.connection().call(message);
+    QDBusReply<QString> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access text." << reply.error().message();
         return QString();
@@ -974,9 +1836,9 @@ QString RegistryPrivate::text(const AccessibleObject &object, int startOffset, i
 
 QString RegistryPrivate::textWithBoundary(const AccessibleObject &object, int offset, AccessibleObject::TextBoundary boundary, int *startOffset, int *endOffset) const
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetTextAtOffset"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetTextAtOffset"));
     message.setArguments(QVariantList() << offset << static_cast<AtspiTextBoundaryType>(boundary));
-    QDBusMessage reply = conn.connection().call(message);
+    QDBusMessage reply = call(message);
     if (reply.type() != QDBusMessage::ReplyMessage || reply.signature() != QLatin1String("sii")) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access text." << reply.errorMessage();
         if (startOffset)
@@ -994,9 +1856,9 @@ QString RegistryPrivate::textWithBoundary(const AccessibleObject &object, int of
 
 bool RegistryPrivate::setText(const AccessibleObject &object, const QString &text)
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("SetTextContents"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("SetTextContents"));
     message.setArguments(QVariantList() << text);
-    QDBusReply<bool> reply = conn.connection().call(message);
+    QDBusReply<bool> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not set text." << reply.error().message();
         return false;
@@ -1006,9 +1868,9 @@ bool RegistryPrivate::setText(const AccessibleObject &object, const QString &tex
 
 bool RegistryPrivate::insertText(const AccessibleObject &object, const QString &text, int position, int length)
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("InsertText"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("InsertText"));
     message.setArguments(QVariantList() << position << text << length);
-    QDBusReply<bool> reply = conn.connection().call(message);
+    QDBusReply<bool> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not insert text." << reply.error().message();
         return false;
@@ -1018,17 +1880,17 @@ bool RegistryPrivate::insertText(const AccessibleObject &object, const QString &
 
 bool RegistryPrivate::copyText(const AccessibleObject &object, int startPos, int endPos)
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("CopyText"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("CopyText"));
     message.setArguments(QVariantList() << startPos << endPos);
-    conn.connection().call(message);
+    call(message);
     return true;
 }
 
 bool RegistryPrivate::cutText(const AccessibleObject &object, int startPos, int endPos)
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("CutText"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("CutText"));
     message.setArguments(QVariantList() << startPos << endPos);
-    QDBusReply<bool> reply = conn.connection().call(message);
+    QDBusReply<bool> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not cut text." << reply.error().message();
         return false;
@@ -1038,9 +1900,9 @@ bool RegistryPrivate::cutText(const AccessibleObject &object, int startPos, int
 
 bool RegistryPrivate::deleteText(const AccessibleObject &object, int startPos, int endPos)
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("DeleteText"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("DeleteText"));
     message.setArguments(QVariantList() << startPos << endPos);
-    QDBusReply<bool> reply = conn.connection().call(message);
+    QDBusReply<bool> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not delete text." << reply.error().message();
         return false;
@@ -1050,9 +1912,9 @@ bool RegistryPrivate::deleteText(const AccessibleObject &object, int startPos, i
 
 bool RegistryPrivate::pasteText(const AccessibleObject &object, int position)
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("PasteText"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.EditableText"), QLatin1String("PasteText"));
     message.setArguments(QVariantList() << position);
-    QDBusReply<bool> reply = conn.connection().call(message);
+    QDBusReply<bool> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not paste text." << reply.error().message();
         return false;
@@ -1063,8 +1925,8 @@ bool RegistryPrivate::pasteText(const AccessibleObject &object, int position)
 AccessibleObject RegistryPrivate::application(const AccessibleObject &object) const
 {
     QDBusMessage message = QDBusMessage::createMethodCall(
-            object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetApplication"));
-    QDBusReply<QSpiObjectReference> reply = conn.connection().call(message);
+            object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetApplication"));
+    QDBusReply<QSpiObjectReference> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access application." << reply.error().message();
         return AccessibleObject();
@@ -1075,35 +1937,35 @@ AccessibleObject RegistryPrivate::application(const AccessibleObject &object) co
 
 QString RegistryPrivate::appToolkitName(const AccessibleObject &object) const
 {
-    const QVariant v = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Application"), QLatin1String("ToolkitName"));
+    const QVariant v = getProperty(object, QLatin1String("org.a11y.atspi.Application"), QLatin1String("ToolkitName"));
     return v.toString();
 }
 
 QString RegistryPrivate::appVersion(const AccessibleObject &object) const
 {
-    const QVariant v = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Application"), QLatin1String("Version"));
+    const QVariant v = getProperty(object, QLatin1String("org.a11y.atspi.Application"), QLatin1String("Version"));
     return v.toString();
 }
 
 int RegistryPrivate::appId(const AccessibleObject &object) const
 {
-    const QVariant v = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Application"), QLatin1String("Id"));
+    const QVariant v = getProperty(object, QLatin1String("org.a11y.atspi.Application"), QLatin1String("Id"));
     return v.toInt();
 }
 
 QString RegistryPrivate::appLocale(const AccessibleObject &object, uint lctype) const
 {
     // some apps misbehave and claim to be the service, but on :1.0 we have the atspi service which doesn't reply anything sensible here
-    if (object.d->service == QLatin1String(":1.0"))
+    if (object.d->service() == QLatin1String(":1.0"))
         return QString();
 
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Application"), QLatin1String("GetLocale"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Application"), QLatin1String("GetLocale"));
 
     QVariantList args;
     args.append(lctype);
     message.setArguments(args);
 
-    QDBusReply<QString> reply = conn.connection().call(message, QDBus::Block, 500);
+    QDBusReply<QString> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access appLocale." << reply.error().message();
         return QString();
@@ -1113,8 +1975,8 @@ QString RegistryPrivate::appLocale(const AccessibleObject &object, uint lctype)
 
 QString RegistryPrivate::appBusAddress(const AccessibleObject &object) const
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Application"), QLatin1String("GetApplicationBusAddress"));
-    QDBusReply<QString> reply = conn.connection().call(message);
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Application"), QLatin1String("GetApplicationBusAddress"));
+    QDBusReply<QString> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << Q_FUNC_INFO << "Could not access application bus address. Error: " << reply.error().message() << " in response to: " << message;
         return QString();
@@ -1124,38 +1986,38 @@ QString RegistryPrivate::appBusAddress(const AccessibleObject &object) const
 
 double RegistryPrivate::minimumValue(const AccessibleObject &object) const
 {
-    const QVariant v = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Value"), QLatin1String("MinimumValue"));
+    const QVariant v = getProperty(object, QLatin1String("org.a11y.atspi.Value"), QLatin1String("MinimumValue"));
     return v.toDouble();
 }
 
 double RegistryPrivate::maximumValue(const AccessibleObject &object) const
 {
-    const QVariant v = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Value"), QLatin1String("MaximumValue"));
+    const QVariant v = getProperty(object, QLatin1String("org.a11y.atspi.Value"), QLatin1String("MaximumValue"));
     return v.toDouble();
 }
 
 double RegistryPrivate::minimumValueIncrement(const AccessibleObject &object) const
 {
-    const QVariant v = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Value"), QLatin1String("MinimumIncrement"));
+    const QVariant v = getProperty(object, QLatin1String("org.a11y.atspi.Value"), QLatin1String("MinimumIncrement"));
     return v.toDouble();
 }
 
 double RegistryPrivate::currentValue(const AccessibleObject &object) const
 {
-    const QVariant v = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Value"), QLatin1String("CurrentValue"));
+    const QVariant v = getProperty(object, QLatin1String("org.a11y.atspi.Value"), QLatin1String("CurrentValue"));
     return v.toDouble();
 }
 
 bool RegistryPrivate::setCurrentValue(const AccessibleObject &object, double value)
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Value"), QLatin1String("SetCurrentValue"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Value"), QLatin1String("SetCurrentValue"));
 
     QVariantList arguments;
     arguments << QLatin1String("org.a11y.atspi.Value") <<  QLatin1String("CurrentValue");
     arguments << QVariant::fromValue(QDBusVariant(value));
     message.setArguments(arguments);
 
-    QDBusReply<bool> reply = conn.connection().call(message);
+    QDBusReply<bool> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not set text." << reply.error().message();
         return false;
@@ -1166,10 +2028,11 @@ bool RegistryPrivate::setCurrentValue(const AccessibleObject &object, double val
 QList<AccessibleObject> RegistryPrivate::selection(const AccessibleObject &object) const
 {
     QList<AccessibleObject> result;
-    int count = getProperty(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Selection"), QLatin1String("CurrentValue")).toInt();
+    int count = getProperty(object, QLatin1String("org.a11y.atspi.Selection"), QLatin1String("NSelectedChildren")).toInt();
     for(int i = 0; i < count; ++i) {
-        QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Selection"), QLatin1String("GetSelectedChild"));
-        QDBusReply<QSpiObjectReference> reply = conn.connection().call(message);
+        QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Selection"), QLatin1String("GetSelectedChild"));
+        message.setArguments(QVariantList() << i);
+        QDBusReply<QSpiObjectReference> reply = call(message);
         if (!reply.isValid()) {
             qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access selection." << reply.error().message();
             return QList<AccessibleObject>();
@@ -1182,8 +2045,8 @@ QList<AccessibleObject> RegistryPrivate::selection(const AccessibleObject &objec
 
 QString RegistryPrivate::imageDescription(const AccessibleObject &object) const
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Image"), QLatin1String("ImageDescription"));
-    QDBusReply<QString> reply = conn.connection().call(message);
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Image"), QLatin1String("ImageDescription"));
+    QDBusReply<QString> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access imageDescription." << reply.error().message();
         return QString();
@@ -1193,8 +2056,8 @@ QString RegistryPrivate::imageDescription(const AccessibleObject &object) const
 
 QString RegistryPrivate::imageLocale(const AccessibleObject &object) const
 {
-    const QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Image"), QLatin1String("ImageLocale"));
-    const QDBusReply<QString> reply = conn.connection().call(message, QDBus::Block, 500);
+    const QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Image"), QLatin1String("ImageLocale"));
+    const QDBusReply<QString> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access imageLocale." << reply.error().message();
         return QString();
@@ -1204,12 +2067,12 @@ QString RegistryPrivate::imageLocale(const AccessibleObject &object) const
 
 QRect RegistryPrivate::imageRect(const AccessibleObject &object) const
 {
-    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Image"), QLatin1String("GetImageExtents"));
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Image"), QLatin1String("GetImageExtents"));
     QVariantList args;
     quint32 coords = ATSPI_COORD_TYPE_SCREEN;
     args << coords;
     message.setArguments(args);
-    QDBusReply<QRect> reply = conn.connection().call(message);
+    QDBusReply<QRect> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access imageRect." << reply.error().message();
         return QRect();
@@ -1220,9 +2083,14 @@ QRect RegistryPrivate::imageRect(const AccessibleObject &object) const
 QVector< QSharedPointer<QAction> > RegistryPrivate::actions(const AccessibleObject &object)
 {
     const QDBusMessage message = QDBusMessage::createMethodCall (
-                object.d->service, object.d->path, QLatin1String("org.a11y.atspi.Action"), QLatin1String("GetActions"));
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Action"), QLatin1String("GetActions"));
+
+    return actionsFromReply(object, call(message));
+}
 
-    const QDBusReply<QSpiActionArray> reply = conn.connection().call(message, QDBus::Block, 500);
+QVector< QSharedPointer<QAction> > RegistryPrivate::actionsFromReply(const AccessibleObject &object, const QDBusMessage &message)
+{
+    const QDBusReply<QSpiActionArray> reply(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access actions." << reply.error().message();
         return QVector< QSharedPointer<QAction> >();
@@ -1233,7 +2101,7 @@ QVector< QSharedPointer<QAction> > RegistryPrivate::actions(const AccessibleObje
     for(int i = 0, total = actionArray.count(); i < total; ++i) {
         const QSpiAction &a = actionArray[i];
         QAction *action = new QAction();
-        const QString id = QStringLiteral("%1;%2;%3").arg(object.d->service).arg(object.d->path).arg(i);
+        const QString id = QStringLiteral("%1;%2;%3").arg(object.d->service()).arg(object.d->path()).arg(i);
         action->setObjectName(id);
         action->setText(a.name);
         action->setWhatsThis(a.description);
@@ -1241,8 +2109,11 @@ QVector< QSharedPointer<QAction> > RegistryPrivate::actions(const AccessibleObje
             const QKeySequence shortcut(a.keyBinding);
             action->setShortcut(std::move(shortcut));
         }
-        m_actionMapper.setMapping(action, id);
-        connect(action, SIGNAL(triggered()), &m_actionMapper, SLOT(map()));
+        // the actions may be fetched on any thread, they belong to the one of the registry
+        action->moveToThread(thread());
+        connect(action, &QAction::triggered, this, [this, id]() {
+            actionTriggered(id);
+        });
         list.append(QSharedPointer<QAction>(action));
     }
     return list;
@@ -1263,7 +2134,7 @@ void RegistryPrivate::actionTriggered(const QString &action)
     args << index;
     message.setArguments(args);
 
-    QDBusReply<bool> reply = conn.connection().call(message, QDBus::Block, 500);
+    QDBusReply<bool> reply = call(message);
     if (!reply.isValid()) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not execute action=" << action << reply.error().message();
         return;
@@ -1276,6 +2147,138 @@ void RegistryPrivate::actionTriggered(const QString &action)
     }
 }
 
+void RegistryPrivate::slotCacheStatisticsTimeout()
+{
+    Q_EMIT q->cacheStatisticsUpdated(q->cacheStatistics());
+}
+
+void RegistryPrivate::slotCoalescingTimeout()
+{
+    flushCoalescedEvents(m_coalescing.maxEventsPerWindow);
+}
+
+bool RegistryPrivate::CoalescedEvent::merge(int index, bool isActive)
+{
+    switch (type) {
+    case ChildrenAdd:
+        // a child inserted within the range or right after it extends the range by one
+        if (index < first || index > last + 1)
+            return false;
+        ++last;
+        break;
+    case ChildrenRemove:
+        // the indexes are the ones before the removals, the range collapsed at first
+        if (index == first)
+            ++last;
+        else if (index == first - 1)
+            --first;
+        else
+            return false;
+        break;
+    default:
+        break;
+    }
+    active = isActive;
+    return true;
+}
+
+bool RegistryPrivate::coalesceEvent(CoalescedEvent::Type type, const AccessibleObject &object, const QString &state, int index, bool active)
+{
+    if (m_coalescing.window <= 0)
+        return false;
+
+    ++m_coalescingStatistics.received;
+    const ObjectHandle handle = object.d ? object.d->handle : 0;
+    if (type == CoalescedEvent::ChildrenAdd || type == CoalescedEvent::ChildrenRemove) {
+        // additions and removals of the same parent must not overtake each other
+        const CoalescedEvent::Type opposite = type == CoalescedEvent::ChildrenAdd ? CoalescedEvent::ChildrenRemove : CoalescedEvent::ChildrenAdd;
+        flushCoalescedEvent(CoalescingKey{ handle, opposite, QString() });
+    }
+
+    const CoalescingKey key = { handle, type, state };
+    const auto it = m_coalescedIndex.constFind(key);
+    if (it != m_coalescedIndex.constEnd()) {
+        if (it.value()->merge(index, active)) {
+            ++m_coalescingStatistics.merged;
+            return true;
+        }
+        flushCoalescedEvent(key);
+    }
+    // receivers of the flushed events may have turned the coalescing off
+    if (m_coalescing.window <= 0)
+        return false;
+
+    if (m_coalescing.maxPendingEvents > 0 && int(m_coalescedEvents.size()) >= m_coalescing.maxPendingEvents) {
+        ++m_coalescingStatistics.dropped;
+        return true;
+    }
+    m_coalescedEvents.push_back(CoalescedEvent{ type, object, state, index, index, active });
+    m_coalescedIndex.insert(key, std::prev(m_coalescedEvents.end()));
+    if (!m_coalescingTimer.isActive())
+        m_coalescingTimer.start(m_coalescing.window);
+    return true;
+}
+
+void RegistryPrivate::flushCoalescedEvent(const CoalescingKey &key)
+{
+    const auto it = m_coalescedIndex.find(key);
+    if (it == m_coalescedIndex.end())
+        return;
+    const CoalescedEvent event = std::move(*it.value());
+    m_coalescedEvents.erase(it.value());
+    m_coalescedIndex.erase(it);
+    ++m_coalescingStatistics.emitted;
+    emitCoalescedEvent(event);
+}
+
+void RegistryPrivate::flushCoalescedEvents(int limit)
+{
+    // Receivers may enable or disable the coalescing again, an event leaves the queue before it is emitted.
+    for (int emitted = 0; !m_coalescedEvents.empty() && (limit <= 0 || emitted < limit); ++emitted) {
+        const CoalescedEvent event = std::move(m_coalescedEvents.front());
+        m_coalescedIndex.remove(CoalescingKey{ event.object.d ? event.object.d->handle : 0, event.type, event.state });
+        m_coalescedEvents.pop_front();
+        ++m_coalescingStatistics.emitted;
+        emitCoalescedEvent(event);
+    }
+    if (!m_coalescedEvents.empty() && m_coalescing.window > 0 && !m_coalescingTimer.isActive())
+        m_coalescingTimer.start(m_coalescing.window);
+}
+
+void RegistryPrivate::emitCoalescedEvent(const CoalescedEvent &event)
+{
+    switch (event.type) {
+    case CoalescedEvent::StateChange: {
+        Q_EMIT q->stateChanged(event.object, event.state, event.active);
+        const int stateValue = EventNames::state(event.state);
+        if (stateValue)
+            Q_EMIT q->accessibleStateChanged(event.object, AccessibleObject::State(stateValue), event.active);
+        break;
+    }
+    case CoalescedEvent::ChildrenAdd:
+        if (event.first == event.last)
+            Q_EMIT q->childAdded(event.object, event.first);
+        else
+            Q_EMIT q->childrenAdded(event.object, event.first, event.last);
+        break;
+    case CoalescedEvent::ChildrenRemove:
+        if (event.first == event.last)
+            Q_EMIT q->childRemoved(event.object, event.first);
+        else
+            Q_EMIT q->childrenRemoved(event.object, event.first, event.last);
+        break;
+    case CoalescedEvent::VisibleDataChange:
+        Q_EMIT q->visibleDataChanged(event.object);
+        break;
+    case CoalescedEvent::SelectionChange:
+        Q_EMIT q->selectionChanged(event.object);
+        break;
+    case CoalescedEvent::ModelChange:
+        Q_EMIT q->modelChanged(event.object);
+        break;
+    }
+}
+
 QVariant RegistryPrivate::getProperty(const QString &service, const QString &path, const QString &interface, const QString &name) const
 {
     QVariantList args;
@@ -1286,112 +2289,1215 @@ QVariant RegistryPrivate::getProperty(const QString &service, const QString &pat
                 service, path, QLatin1String("org.freedesktop.DBus.Properties"), QLatin1String("Get"));
 
     message.setArguments(args);
-    const QDBusMessage reply = conn.connection().call(message, QDBus::Block, 500);
-    if (reply.arguments().isEmpty())
-        return QVariant();
-
-    const QDBusVariant v = reply.arguments().at(0).value<QDBusVariant>();
-    return v.variant();
+    const QDBusMessage reply = call(message);
+    return propertyFromReply(reply);
 }
 
-AccessibleObject RegistryPrivate::accessibleFromPath(const QString &service, const QString &path) const
+QVariant RegistryPrivate::getProperty(const AccessibleObject &object, const QString &interface, const QString &name) const
 {
-    return AccessibleObject(const_cast<RegistryPrivate*>(this), service, path);
+    const QVariant prefetched = prefetchedProperty(object, interface, name);
+    if (prefetched.isValid())
+        return prefetched;
+    return getProperty(object.d->service(), object.d->path(), interface, name);
 }
 
-AccessibleObject RegistryPrivate::accessibleFromReference(const QSpiObjectReference &reference) const
+QVariant RegistryPrivate::prefetchedProperty(const AccessibleObject &object, const QString &interface, const QString &name)
 {
-    return accessibleFromPath(reference.service, reference.path.path());
+    QMutexLocker lock(&object.d->mutex);
+    const auto properties = object.d->prefetchedProperties.constFind(interface);
+    if (properties == object.d->prefetchedProperties.constEnd())
+        return QVariant();
+    return properties->value(name);
 }
 
-AccessibleObject RegistryPrivate::accessibleFromContext() const
+void RegistryPrivate::prefetch(const AccessibleObject &object, AccessibleObject::Interfaces interfaces)
 {
-    return accessibleFromPath(QDBusContext::message().service(), QDBusContext::message().path());
+    if (!object.isValid())
+        return;
+
+    static const QList<QPair<AccessibleObject::Interface, const char *> > prefetchable = {
+        { AccessibleObject::AccessibleInterface, ATSPI_DBUS_INTERFACE_ACCESSIBLE },
+        { AccessibleObject::ValueInterface, ATSPI_DBUS_INTERFACE_VALUE },
+        { AccessibleObject::TextInterface, ATSPI_DBUS_INTERFACE_TEXT },
+        { AccessibleObject::ApplicationInterface, ATSPI_DBUS_INTERFACE_APPLICATION },
+    };
+
+    // send all requests first so the replies come in while we wait for the first one
+    struct PendingPrefetch {
+        QString interface;
+        QDBusMessage message;
+        qint64 sent;
+        QDBusPendingCall call;
+    };
+    QList<PendingPrefetch> calls;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    for (const auto &entry : prefetchable) {
+        if (!interfaces.testFlag(entry.first))
+            continue;
+        const QString interface = QLatin1String(entry.second);
+        QDBusMessage message = QDBusMessage::createMethodCall (
+                    object.d->service(), object.d->path(), QLatin1String("org.freedesktop.DBus.Properties"), QLatin1String("GetAll"));
+        message.setArguments(QVariantList() << interface);
+        calls.append(PendingPrefetch{interface, message, elapsed.nsecsElapsed(), pendingCall(message)});
+    }
+
+    for (PendingPrefetch &request : calls) {
+        request.call.waitForFinished();
+        recordCallResult(request.message, request.call.reply(), (elapsed.nsecsElapsed() - request.sent) / 1000);
+        const QDBusReply<QVariantMap> reply(request.call.reply());
+        if (!reply.isValid()) {
+            // not every object implements every interface, nothing to warn about
+            QMutexLocker lock(&object.d->mutex);
+            object.d->prefetchedProperties.remove(request.interface);
+            continue;
+        }
+        QVariantMap properties = reply.value();
+        // demarshalling a QDBusArgument consumes it, store the parent in a form that can be read repeatedly
+        const auto parent = properties.find(QLatin1String("Parent"));
+        if (parent != properties.end() && parent->metaType() == QMetaType::fromType<QDBusArgument>()) {
+            QSpiObjectReference ref;
+            parent->value<QDBusArgument>() >> ref;
+            *parent = QVariant::fromValue(ref);
+        }
+        QMutexLocker lock(&object.d->mutex);
+        object.d->prefetchedProperties.insert(request.interface, properties);
+        if (!object.d->prefetched) {
+            object.d->prefetched = true;
+            QMutexLocker prefetchedLock(&m_prefetchedMutex);
+            m_prefetchedObjects.insert(object.d->handle, object.d.toWeakRef());
+        }
+    }
 }
 
-void RegistryPrivate::slotWindowCreate(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &)
+void RegistryPrivate::forgetPrefetched(ObjectHandle handle, const QString &interface, const QString &name)
 {
-    Q_EMIT q->windowCreated(accessibleFromContext());
+    // without a cache several objects may stand for the handle, each has its own values
+    QList<QSharedPointer<AccessibleObjectPrivate> > objects;
+    {
+        QMutexLocker lock(&m_prefetchedMutex);
+        for (auto it = m_prefetchedObjects.constFind(handle); it != m_prefetchedObjects.constEnd() && it.key() == handle; ++it) {
+            if (const QSharedPointer<AccessibleObjectPrivate> object = it.value().toStrongRef())
+                objects.append(object);
+        }
+    }
+    for (const QSharedPointer<AccessibleObjectPrivate> &object : std::as_const(objects)) {
+        QMutexLocker lock(&object->mutex);
+        if (name.isEmpty()) {
+            object->prefetchedProperties.remove(interface);
+            continue;
+        }
+        const auto properties = object->prefetchedProperties.find(interface);
+        if (properties != object->prefetchedProperties.end())
+            properties->remove(name);
+    }
 }
 
-void RegistryPrivate::slotWindowDestroy(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+void RegistryPrivate::removePrefetchedObject(ObjectHandle handle)
 {
-    Q_EMIT q->windowDestroyed(accessibleFromContext());
+    QMutexLocker lock(&m_prefetchedMutex);
+    for (auto it = m_prefetchedObjects.find(handle); it != m_prefetchedObjects.end() && it.key() == handle;) {
+        if (it.value().isNull())
+            it = m_prefetchedObjects.erase(it);
+        else
+            ++it;
+    }
 }
 
-void RegistryPrivate::slotWindowClose(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+QVariant RegistryPrivate::propertyFromReply(const QDBusMessage &reply)
 {
-    Q_EMIT q->windowClosed(accessibleFromContext());
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty())
+        return QVariant();
+
+    const QDBusVariant v = reply.arguments().at(0).value<QDBusVariant>();
+    return v.variant();
 }
 
-void RegistryPrivate::slotWindowReparent(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+QFuture<QDBusMessage> RegistryPrivate::asyncCall(const QDBusMessage &message, int timeout) const
 {
-    Q_EMIT q->windowReparented(accessibleFromContext());
+    auto promise = std::make_shared<QPromise<QDBusMessage> >();
+    QFuture<QDBusMessage> future = promise->future();
+    promise->start();
+
+    if (QThread::currentThread() != thread()) {
+        // the watchers of the replies live in the thread of the registry, send the call from there
+        QMetaObject::invokeMethod(const_cast<RegistryPrivate*>(this), [this, message, timeout, promise]() {
+            startAsyncCall(message, timeout, promise);
+        }, Qt::QueuedConnection);
+        return future;
+    }
+
+    startAsyncCall(message, timeout, promise);
+    return future;
 }
 
-void RegistryPrivate::slotWindowMinimize(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+void RegistryPrivate::startAsyncCall(const QDBusMessage &message, int timeout, const std::shared_ptr<QPromise<QDBusMessage> > &promise) const
 {
-    Q_EMIT q->windowMinimized(accessibleFromContext());
+    if (conn.isFetchingConnection()) {
+        // asking for the connection now would block until the a11y bus address is known,
+        // connectionFetched() sends the queued calls instead
+        QMutexLocker lock(&m_callMutex);
+        m_queuedCalls.append(QueuedCall{message, timeout, promise});
+        return;
+    }
+
+    sendAsyncCall(message, timeout, promise);
 }
 
-void RegistryPrivate::slotWindowMaximize(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+void RegistryPrivate::sendAsyncCall(const QDBusMessage &message, int timeout, const std::shared_ptr<QPromise<QDBusMessage> > &promise) const
 {
-    Q_EMIT q->windowMaximized(accessibleFromContext());
+    const QString service = message.service();
+    if (!admitCall(service)) {
+        promise->addResult(message.createErrorReply(QLatin1String(QSPI_ERROR_QUARANTINED), QLatin1String("Service does not respond")));
+        promise->finish();
+        return;
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QDBusPendingCall async = conn.connection().asyncCall(message, callTimeout(message, timeout));
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(async, const_cast<RegistryPrivate*>(this));
+    connect(watcher, &QDBusPendingCallWatcher::finished, watcher, [this, message, promise, elapsed](QDBusPendingCallWatcher *call) {
+        const QDBusMessage reply = call->reply();
+        recordCallResult(message, reply, elapsed.nsecsElapsed() / 1000);
+        promise->addResult(reply);
+        promise->finish();
+        call->deleteLater();
+    });
 }
 
-void RegistryPrivate::slotWindowRestore(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+QDBusMessage RegistryPrivate::call(const QDBusMessage &message, int timeout) const
 {
-    Q_EMIT q->windowRestored(accessibleFromContext());
+    if (!admitCall(message.service()))
+        return message.createErrorReply(QLatin1String(QSPI_ERROR_QUARANTINED), QLatin1String("Service does not respond"));
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    const QDBusMessage reply = conn.connection().call(message, QDBus::Block, callTimeout(message, timeout));
+    recordCallResult(message, reply, elapsed.nsecsElapsed() / 1000);
+    return reply;
 }
 
-void RegistryPrivate::slotWindowActivate(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+QDBusPendingCall RegistryPrivate::pendingCall(const QDBusMessage &message, int timeout) const
 {
-    Q_EMIT q->windowActivated(accessibleFromContext());
+    // the caller reports the reply through recordCallResult() once it waited for it
+    if (!admitCall(message.service()))
+        return QDBusPendingCall::fromCompletedCall(message.createErrorReply(QLatin1String(QSPI_ERROR_QUARANTINED), QLatin1String("Service does not respond")));
+    return conn.connection().asyncCall(message, callTimeout(message, timeout));
 }
 
-void RegistryPrivate::slotWindowDeactivate(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+int RegistryPrivate::callTimeout(const QDBusMessage &message, int timeout) const
 {
-    Q_EMIT q->windowDeactivated(accessibleFromContext());
+    if (timeout >= 0)
+        return timeout;
+
+    QString interface = message.interface();
+    QString method;
+    if (interface == QLatin1String("org.freedesktop.DBus.Properties") && !message.arguments().isEmpty())
+        interface = message.arguments().at(0).toString();
+    else
+        method = interface + QLatin1Char('.') + message.member();
+    QMutexLocker lock(&m_callMutex);
+    // an entry for the method wins over the one for its interface
+    const auto it = method.isEmpty() ? m_callPolicy.interfaceTimeouts.constEnd() : m_callPolicy.interfaceTimeouts.constFind(method);
+    if (it != m_callPolicy.interfaceTimeouts.constEnd())
+        return it.value();
+    return m_callPolicy.interfaceTimeouts.value(interface, m_callPolicy.defaultTimeout);
+}
+
+bool RegistryPrivate::admitCall(const QString &service) const
+{
+    QMutexLocker lock(&m_callMutex);
+    const auto health = m_serviceHealth.constFind(service);
+    return health == m_serviceHealth.constEnd() || !health->quarantined;
+}
+
+static bool isTimeout(const QDBusMessage &reply)
+{
+    const QString error = reply.errorName();
+    return error == QDBusError::errorString(QDBusError::NoReply)
+            || error == QDBusError::errorString(QDBusError::Timeout)
+            || error == QDBusError::errorString(QDBusError::TimedOut);
+}
+
+static bool isServiceGone(const QDBusMessage &reply)
+{
+    const QString error = reply.errorName();
+    return error == QDBusError::errorString(QDBusError::ServiceUnknown)
+            || error == QDBusError::errorString(QDBusError::Disconnected);
+}
+
+QString RegistryPrivate::callKey(const QDBusMessage &message)
+{
+    // property access is told apart by the property, Get and Set carry it as second argument
+    const QString member = message.member();
+    const QVariantList arguments = message.arguments();
+    if (message.interface() == QLatin1String("org.freedesktop.DBus.Properties")) {
+        if (member == QLatin1String("GetAll") && !arguments.isEmpty())
+            return QLatin1String("Properties.GetAll:") + arguments.at(0).toString();
+        if (arguments.size() >= 2)
+            return QLatin1String("Properties.") + member + QLatin1Char(':') + arguments.at(1).toString();
+    }
+    return message.interface() + QLatin1Char('.') + member;
+}
+
+static void addCall(Registry::CallStatistics &statistics, bool error, qint64 latency)
+{
+    ++statistics.calls;
+    if (error)
+        ++statistics.errors;
+    statistics.totalLatency += latency;
+    statistics.maxLatency = qMax(statistics.maxLatency, latency);
+
+    int bucket = 0;
+    while (bucket < Registry::CallStatistics::HistogramBuckets - 1 && (latency >> (bucket + 1)) > 0)
+        ++bucket;
+    if (statistics.histogram.isEmpty())
+        statistics.histogram.resize(Registry::CallStatistics::HistogramBuckets);
+    ++statistics.histogram[bucket];
+}
+
+void RegistryPrivate::recordCallResult(const QDBusMessage &message, const QDBusMessage &reply, qint64 latency) const
+{
+    const QString service = message.service();
+    if (reply.type() == QDBusMessage::ErrorMessage && reply.errorName() == QLatin1String(QSPI_ERROR_QUARANTINED))
+        return;
+
+    const bool error = reply.type() == QDBusMessage::ErrorMessage;
+    const QString key = callKey(message);
+    QMutexLocker lock(&m_callMutex);
+    Registry::CallStatistics &method = m_methodStatistics[key];
+    method.key = key;
+    addCall(method, error, latency);
+    Registry::CallStatistics &destination = m_serviceStatistics[service];
+    destination.key = service;
+    addCall(destination, error, latency);
+
+    if (error && isServiceGone(reply)) {
+        m_serviceHealth.remove(service);
+        return;
+    }
+
+    Registry::ServiceHealth &health = m_serviceHealth[service];
+    health.service = service;
+    ++health.calls;
+    health.lastLatency = int(latency / 1000);
+    // exponential moving average, recent calls matter more than the ones from an hour ago
+    health.averageLatency = health.calls == 1 ? health.lastLatency : (health.averageLatency * 7 + health.lastLatency) / 8;
+
+    if (reply.type() != QDBusMessage::ErrorMessage) {
+        health.consecutiveTimeouts = 0;
+        return;
+    }
+    ++health.errors;
+    if (!isTimeout(reply)) {
+        // the service answered, even if with an error
+        health.consecutiveTimeouts = 0;
+        return;
+    }
+
+    ++health.timeouts;
+    ++health.consecutiveTimeouts;
+    if (health.quarantined || m_callPolicy.failureThreshold <= 0 || health.consecutiveTimeouts < m_callPolicy.failureThreshold)
+        return;
+
+    qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Service" << service << "timed out" << health.consecutiveTimeouts << "times in a row, quarantined";
+    health.quarantined = true;
+    const int interval = m_callPolicy.quarantineInterval;
+    lock.unlock();
+    // the call may have been made on another thread, the timer and the signal belong to the registry
+    QTimer::singleShot(interval, this, [this, service]() {
+        probeService(service);
+    });
+    QMetaObject::invokeMethod(const_cast<RegistryPrivate*>(this), [this, service]() {
+        Q_EMIT q->serviceQuarantined(service);
+    }, Qt::QueuedConnection);
+}
+
+void RegistryPrivate::probeService(const QString &service) const
+{
+    {
+        QMutexLocker lock(&m_callMutex);
+        const auto health = m_serviceHealth.constFind(service);
+        if (health == m_serviceHealth.constEnd() || !health->quarantined)
+            return;
+    }
+
+    // Peer.Ping is answered by the D-Bus thread of Qt applications even when their
+    // user interface hangs, ask the accessibility code of the application instead
+    QDBusMessage message = QDBusMessage::createMethodCall(
+                service, QLatin1String(QSPI_OBJECT_PATH_ROOT), QLatin1String("org.freedesktop.DBus.Properties"), QLatin1String("Get"));
+    message.setArguments(QVariantList() << QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE) << QLatin1String("ChildCount"));
+
+    QDBusPendingCall async = conn.connection().asyncCall(message, callTimeout(message));
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(async, const_cast<RegistryPrivate*>(this));
+    connect(watcher, &QDBusPendingCallWatcher::finished, watcher, [this, service](QDBusPendingCallWatcher *call) {
+        call->deleteLater();
+        const QDBusMessage reply = call->reply();
+        QMutexLocker lock(&m_callMutex);
+        const auto health = m_serviceHealth.find(service);
+        if (health == m_serviceHealth.end())
+            return;
+        if (isServiceGone(reply)) {
+            m_serviceHealth.erase(health);
+            return;
+        }
+        if (reply.type() == QDBusMessage::ErrorMessage && isTimeout(reply)) {
+            QTimer::singleShot(m_callPolicy.quarantineInterval, this, [this, service]() {
+                probeService(service);
+            });
+            return;
+        }
+        health->quarantined = false;
+        health->consecutiveTimeouts = 0;
+        lock.unlock();
+        Q_EMIT q->serviceReadmitted(service);
+    });
+}
+
+QList<Registry::ServiceHealth> RegistryPrivate::serviceHealth() const
+{
+    QMutexLocker lock(&m_callMutex);
+    return m_serviceHealth.values();
+}
+
+void RegistryPrivate::dumpCallStatistics() const
+{
+    auto dump = [](const char *title, const QHash<QString, Registry::CallStatistics> &table) {
+        QList<Registry::CallStatistics> entries = table.values();
+        // where most of the time went first
+        std::sort(entries.begin(), entries.end(), [](const Registry::CallStatistics &a, const Registry::CallStatistics &b) {
+            return a.totalLatency > b.totalLatency;
+        });
+        qCInfo(LIBQACCESSIBILITYCLIENT_CALLS_LOG) << title;
+        for (const Registry::CallStatistics &entry : std::as_const(entries)) {
+            qCInfo(LIBQACCESSIBILITYCLIENT_CALLS_LOG).nospace() << "  " << entry.key
+                << ": calls=" << entry.calls << " errors=" << entry.errors
+                << " total=" << entry.totalLatency / 1000 << "ms avg=" << entry.averageLatency() << "us max=" << entry.maxLatency << "us"
+                << " histogram=" << entry.histogram;
+        }
+    };
+    QMutexLocker lock(&m_callMutex);
+    const QHash<QString, Registry::CallStatistics> methodStatistics = m_methodStatistics;
+    const QHash<QString, Registry::CallStatistics> serviceStatistics = m_serviceStatistics;
+    lock.unlock();
+    dump("D-Bus calls by method:", methodStatistics);
+    dump("D-Bus calls by service:", serviceStatistics);
+}
+
+QFuture<QVariant> RegistryPrivate::getPropertyAsync(const AccessibleObject &object, const QString &interface, const QString &name) const
+{
+    const QVariant prefetched = prefetchedProperty(object, interface, name);
+    if (prefetched.isValid())
+        return readyFuture(prefetched);
+
+    QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.freedesktop.DBus.Properties"), QLatin1String("Get"));
+    message.setArguments(QVariantList() << interface << name);
+
+    return asyncCall(message).then([](const QDBusMessage &reply) {
+        return propertyFromReply(reply);
+    });
+}
+
+QFuture<QString> RegistryPrivate::accessibleIdAsync(const AccessibleObject &object) const
+{
+    if (!object.isValid())
+        return readyFuture(QString());
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("AccessibleId")).then([](const QVariant &id) {
+        return id.toString();
+    });
+}
+
+QFuture<QString> RegistryPrivate::nameAsync(const AccessibleObject &object) const
+{
+    if (!object.isValid())
+        return readyFuture(QString());
+    if (m_cache) {
+        const std::optional<QString> name = m_cache->name(object);
+        if (name)
+            return readyFuture(*name);
+    }
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("Name")).then([self, object](const QVariant &name) {
+        if (name.isValid() && self->cachesProperties())
+            self->m_cache->setName(object, name.toString());
+        return name.toString();
+    });
+}
+
+QFuture<QString> RegistryPrivate::descriptionAsync(const AccessibleObject &object) const
+{
+    if (!object.isValid())
+        return readyFuture(QString());
+    if (m_cache) {
+        const std::optional<QString> description = m_cache->description(object);
+        if (description)
+            return readyFuture(*description);
+    }
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("Description")).then([self, object](const QVariant &description) {
+        if (description.isValid() && self->cachesProperties())
+            self->m_cache->setDescription(object, description.toString());
+        return description.toString();
+    });
+}
+
+QFuture<AccessibleObject::Role> RegistryPrivate::roleAsync(const AccessibleObject &object) const
+{
+    if (!object.isValid())
+        return readyFuture(AccessibleObject::NoRole);
+    if (m_cache) {
+        const std::optional<AccessibleObject::Role> role = m_cache->role(object);
+        if (role)
+            return readyFuture(*role);
+    }
+
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetRole"));
+
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return asyncCall(message).then([self, object](const QDBusMessage &message) {
+        const QDBusReply<uint> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access role." << reply.error().message();
+            return AccessibleObject::NoRole;
+        }
+        const AccessibleObject::Role role = atspiRoleToRole(static_cast<AtspiRole>(reply.value()));
+        if (self->cachesProperties())
+            self->m_cache->setRole(object, role);
+        return role;
+    });
+}
+
+QFuture<QString> RegistryPrivate::roleNameAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetRoleName"));
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QString> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access roleName." << reply.error().message();
+            return QString();
+        }
+        return reply.value();
+    });
+}
+
+QFuture<QString> RegistryPrivate::localizedRoleNameAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetLocalizedRoleName"));
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QString> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access localizedRoleName." << reply.error().message();
+            return QString();
+        }
+        return reply.value();
+    });
+}
+
+QFuture<QRect> RegistryPrivate::boundingRectAsync(const AccessibleObject &object) const
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(
+            object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetExtents") );
+    quint32 coords = ATSPI_COORD_TYPE_SCREEN;
+    message.setArguments(QVariantList() << coords);
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QRect> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get extents." << reply.error().message();
+            return QRect();
+        }
+        return reply.value();
+    });
+}
+
+QFuture<AccessibleObject::Interfaces> RegistryPrivate::supportedInterfacesAsync(const AccessibleObject &object) const
+{
+    if (m_cache) {
+        AccessibleObject::Interfaces interfaces = m_cache->interfaces(object);
+        if (!(interfaces & AccessibleObject::InvalidInterface))
+            return readyFuture(interfaces);
+    }
+
+    const QDBusMessage message = QDBusMessage::createMethodCall(
+            object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"),
+                    QLatin1String("GetInterfaces"));
+
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return asyncCall(message).then([self, object](const QDBusMessage &message) {
+        AccessibleObject::Interfaces interfaces = AccessibleObject::NoInterface;
+        const QDBusReply<QStringList> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get Interfaces. " << reply.error().message();
+            return interfaces;
+        }
+
+        const auto values{reply.value()};
+        for (const QString &interface : values) {
+            interfaces |= self->interfaceHash.value(interface);
+        }
+
+        if (self->m_cache) {
+            self->m_cache->setInterfaces(object, interfaces);
+        }
+        return interfaces;
+    });
+}
+
+QFuture<int> RegistryPrivate::caretOffsetAsync(const AccessibleObject &object) const
+{
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Text"), QLatin1String("CaretOffset")).then([](const QVariant &offset) {
+        if (offset.isNull()) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get caret offset";
+        return offset.toInt();
+    });
+}
+
+QFuture<int> RegistryPrivate::characterCountAsync(const AccessibleObject &object) const
+{
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Text"), QLatin1String("CharacterCount")).then([](const QVariant &count) {
+        if (count.isNull()) qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get character count";
+        return count.toInt();
+    });
+}
+
+QFuture<QString> RegistryPrivate::textAsync(const AccessibleObject &object, int startOffset, int endOffset) const
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetText"));
+    message.setArguments(QVariantList() << startOffset << endOffset);
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QString> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access text." << reply.error().message();
+            return QString();
+        }
+        return reply.value();
+    });
+}
+
+QFuture<AccessibleObject> RegistryPrivate::applicationAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall(
+            object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetApplication"));
+
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return asyncCall(message).then([self](const QDBusMessage &message) {
+        const QDBusReply<QSpiObjectReference> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access application." << reply.error().message();
+            return AccessibleObject();
+        }
+        return self->accessibleFromReference(reply.value());
+    });
+}
+
+QFuture<double> RegistryPrivate::currentValueAsync(const AccessibleObject &object) const
+{
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Value"), QLatin1String("CurrentValue")).then([](const QVariant &value) {
+        return value.toDouble();
+    });
+}
+
+QFuture<double> RegistryPrivate::minimumValueAsync(const AccessibleObject &object) const
+{
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Value"), QLatin1String("MinimumValue")).then([](const QVariant &value) {
+        return value.toDouble();
+    });
+}
+
+QFuture<double> RegistryPrivate::maximumValueAsync(const AccessibleObject &object) const
+{
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Value"), QLatin1String("MaximumValue")).then([](const QVariant &value) {
+        return value.toDouble();
+    });
+}
+
+QFuture<double> RegistryPrivate::minimumValueIncrementAsync(const AccessibleObject &object) const
+{
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Value"), QLatin1String("MinimumIncrement")).then([](const QVariant &value) {
+        return value.toDouble();
+    });
+}
+
+QFuture<int> RegistryPrivate::layerAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetLayer"));
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<uint> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access layer." << reply.error().message();
+            return 1;
+        }
+        return int(reply.value());
+    });
+}
+
+QFuture<int> RegistryPrivate::mdiZOrderAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetMDIZOrder"));
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<short> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access mdiZOrder." << reply.error().message();
+            return 0;
+        }
+        return int(reply.value());
+    });
+}
+
+QFuture<double> RegistryPrivate::alphaAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Component"), QLatin1String("GetAlpha"));
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<double> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access alpha." << reply.error().message();
+            return 1.0;
+        }
+        return reply.value();
+    });
+}
+
+QFuture<QRect> RegistryPrivate::characterRectAsync(const AccessibleObject &object, int offset) const
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(
+            object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"),
+                    QLatin1String("GetCharacterExtents"));
+    quint32 coords = ATSPI_COORD_TYPE_SCREEN;
+    message.setArguments(QVariantList() << offset << coords);
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QRect> reply(message);
+        if (reply.isValid())
+            return reply.value();
+        // some implementations reply with four integers instead of a rectangle
+        if (message.signature() == QLatin1String("iiii")) {
+            const QList<QVariant> args = message.arguments();
+            return QRect(args.at(0).toInt(), args.at(1).toInt(), args.at(2).toInt(), args.at(3).toInt());
+        }
+        qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not get Character Extents. " << reply.error().message();
+        return QRect();
+    });
+}
+
+QFuture<QList< QPair<int,int> > > RegistryPrivate::textSelectionsAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetNSelections"));
+
+    // the selections are asked for all at once once their number is known
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return asyncCall(message).then([self, object](const QDBusMessage &message) {
+        QList<QFuture<QDBusMessage> > calls;
+        const QDBusReply<int> reply(message);
+        if (!reply.isValid())
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access GetNSelections." << reply.error().message();
+        for (int i = 0; reply.isValid() && i < reply.value(); ++i) {
+            QDBusMessage m = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetSelection"));
+            m.setArguments(QVariantList() << i);
+            calls.append(self->asyncCall(m));
+        }
+        return QtFuture::whenAll(calls.begin(), calls.end()).then([](const QList<QFuture<QDBusMessage> > &replies) {
+            QList< QPair<int,int> > result;
+            for (const QFuture<QDBusMessage> &reply : replies) {
+                const QList<QVariant> args = reply.result().arguments();
+                if (args.count() < 2) {
+                    qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Invalid number of arguments. Expected=2 Actual=" << args.count();
+                    continue;
+                }
+                int startOffset = args[0].toInt();
+                int endOffset = args[1].toInt();
+                if (startOffset > endOffset)
+                    qSwap(startOffset, endOffset);
+                result.append(qMakePair(startOffset, endOffset));
+            }
+            return result;
+        });
+    }).unwrap();
+}
+
+QFuture<AccessibleObject::TextRange> RegistryPrivate::textWithBoundaryAsync(const AccessibleObject &object, int offset, AccessibleObject::TextBoundary boundary) const
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Text"), QLatin1String("GetTextAtOffset"));
+    message.setArguments(QVariantList() << offset << static_cast<AtspiTextBoundaryType>(boundary));
+
+    return asyncCall(message).then([](const QDBusMessage &reply) {
+        AccessibleObject::TextRange range;
+        if (reply.type() != QDBusMessage::ReplyMessage || reply.signature() != QLatin1String("sii")) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access text." << reply.errorMessage();
+            return range;
+        }
+        range.text = reply.arguments().at(0).toString();
+        range.startOffset = reply.arguments().at(1).toInt();
+        range.endOffset = reply.arguments().at(2).toInt();
+        return range;
+    });
+}
+
+QFuture<QString> RegistryPrivate::appToolkitNameAsync(const AccessibleObject &object) const
+{
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Application"), QLatin1String("ToolkitName")).then([](const QVariant &value) {
+        return value.toString();
+    });
+}
+
+QFuture<QString> RegistryPrivate::appVersionAsync(const AccessibleObject &object) const
+{
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Application"), QLatin1String("Version")).then([](const QVariant &value) {
+        return value.toString();
+    });
+}
+
+QFuture<int> RegistryPrivate::appIdAsync(const AccessibleObject &object) const
+{
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Application"), QLatin1String("Id")).then([](const QVariant &value) {
+        return value.toInt();
+    });
+}
+
+QFuture<QString> RegistryPrivate::appLocaleAsync(const AccessibleObject &object, uint lctype) const
+{
+    // see appLocale(), the atspi service on :1.0 does not reply anything sensible
+    if (object.d->service() == QLatin1String(":1.0"))
+        return readyFuture(QString());
+
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Application"), QLatin1String("GetLocale"));
+    message.setArguments(QVariantList() << lctype);
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QString> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access appLocale." << reply.error().message();
+            return QString();
+        }
+        return reply.value();
+    });
+}
+
+QFuture<QString> RegistryPrivate::appBusAddressAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Application"), QLatin1String("GetApplicationBusAddress"));
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QString> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access application bus address." << reply.error().message();
+            return QString();
+        }
+        return reply.value();
+    });
+}
+
+QFuture<QList<AccessibleObject> > RegistryPrivate::selectionAsync(const AccessibleObject &object) const
+{
+    // the selected children are asked for all at once once their number is known
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Selection"), QLatin1String("NSelectedChildren")).then([self, object](const QVariant &count) {
+        QList<QFuture<QDBusMessage> > calls;
+        for (int i = 0; i < count.toInt(); ++i) {
+            QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Selection"), QLatin1String("GetSelectedChild"));
+            message.setArguments(QVariantList() << i);
+            calls.append(self->asyncCall(message));
+        }
+        return QtFuture::whenAll(calls.begin(), calls.end()).then([self](const QList<QFuture<QDBusMessage> > &replies) {
+            QList<AccessibleObject> result;
+            for (const QFuture<QDBusMessage> &message : replies) {
+                const QDBusReply<QSpiObjectReference> reply(message.result());
+                if (!reply.isValid()) {
+                    qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access selection." << reply.error().message();
+                    return QList<AccessibleObject>();
+                }
+                result.append(self->accessibleFromReference(reply.value()));
+            }
+            return result;
+        });
+    }).unwrap();
+}
+
+QFuture<QString> RegistryPrivate::imageDescriptionAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Image"), QLatin1String("ImageDescription"));
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QString> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access imageDescription." << reply.error().message();
+            return QString();
+        }
+        return reply.value();
+    });
+}
+
+QFuture<QString> RegistryPrivate::imageLocaleAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Image"), QLatin1String("ImageLocale"));
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QString> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access imageLocale." << reply.error().message();
+            return QString();
+        }
+        return reply.value();
+    });
+}
+
+QFuture<QRect> RegistryPrivate::imageRectAsync(const AccessibleObject &object) const
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Image"), QLatin1String("GetImageExtents"));
+    quint32 coords = ATSPI_COORD_TYPE_SCREEN;
+    message.setArguments(QVariantList() << coords);
+
+    return asyncCall(message).then([](const QDBusMessage &message) {
+        const QDBusReply<QRect> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access imageRect." << reply.error().message();
+            return QRect();
+        }
+        return reply.value();
+    });
+}
+
+QFuture<QList<AccessibleObject> > RegistryPrivate::topLevelAccessiblesAsync() const
+{
+    QString service = QLatin1String("org.a11y.atspi.Registry");
+    QString path = QLatin1String("/org/a11y/atspi/accessible/root");
+    return childrenAsync(AccessibleObject(const_cast<RegistryPrivate*>(this), service, path));
+}
+
+QFuture<AccessibleObject> RegistryPrivate::parentAccessibleAsync(const AccessibleObject &object) const
+{
+    if (m_cache) {
+        const std::optional<QSpiObjectReference> parent = m_cache->parent(object);
+        if (parent)
+            return readyFuture(parentFromReference(object, *parent));
+    }
+
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("Parent")).then([self, object](const QVariant &parent) {
+        return self->parentFromProperty(object, parent);
+    });
+}
+
+QFuture<int> RegistryPrivate::childCountAsync(const AccessibleObject &object) const
+{
+    if (m_cache) {
+        const std::optional<int> childCount = m_cache->childCount(object);
+        if (childCount)
+            return readyFuture(*childCount);
+    }
+
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return getPropertyAsync(object, QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("ChildCount")).then([self, object](const QVariant &childCount) {
+        if (childCount.isValid() && self->cachesChildren())
+            self->m_cache->setChildCount(object, childCount.toInt());
+        return childCount.toInt();
+    });
+}
+
+QFuture<int> RegistryPrivate::indexInParentAsync(const AccessibleObject &object) const
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetIndexInParent"));
+
+    return asyncCall(message).then([](const QDBusMessage &reply) {
+        // older implementations reply with an uint, toInt() takes care of both
+        if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access index in parent." << reply.errorMessage();
+            return -1;
+        }
+        return reply.arguments().at(0).toInt();
+    });
+}
+
+QFuture<AccessibleObject> RegistryPrivate::childAsync(const AccessibleObject &object, int index) const
+{
+    QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetChildAtIndex"));
+    message.setArguments(QVariantList() << index);
+
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return asyncCall(message).then([self](const QDBusMessage &message) {
+        const QDBusReply<QSpiObjectReference> reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access child." << reply.error().message();
+            return AccessibleObject();
+        }
+        return self->accessibleFromReference(reply.value());
+    });
+}
+
+QFuture<QList<AccessibleObject> > RegistryPrivate::childrenAsync(const AccessibleObject &object) const
+{
+    if (m_cache) {
+        const std::optional<QSpiObjectReferenceList> children = m_cache->children(object);
+        if (children)
+            return readyFuture(accessiblesFromReferences(*children));
+    }
+
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetChildren"));
+
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return asyncCall(message).then([self, object](const QDBusMessage &reply) {
+        if (self->cachesChildren() && reply.type() == QDBusMessage::ReplyMessage) {
+            const QDBusReply<QSpiObjectReferenceList> children(reply);
+            if (children.isValid())
+                self->m_cache->setChildren(object, children.value());
+        }
+        return self->accessiblesFromReply(reply);
+    });
+}
+
+QFuture<quint64> RegistryPrivate::stateAsync(const AccessibleObject &object) const
+{
+    if (!object.isValid())
+        return readyFuture(quint64(0));
+    if (m_cache) {
+        const quint64 cachedValue = m_cache->state(object);
+        if (cachedValue != QAccessibleClient::ObjectCache::StateNotFound)
+            return readyFuture(cachedValue);
+    }
+
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Accessible"), QLatin1String("GetState"));
+
+    RegistryPrivate *self = const_cast<RegistryPrivate*>(this);
+    return asyncCall(message).then([self, object](const QDBusMessage &message) {
+        const QDBusReply<QVector<quint32> > reply(message);
+        if (!reply.isValid()) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Could not access state." << reply.error().message();
+            return quint64(0);
+        }
+        if (reply.value().size() < 2) {
+            qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Did not receive expected reply.";
+            return quint64(0);
+        }
+        const quint64 state = reply.value().at(0) + (static_cast<quint64>(reply.value().at(1)) << 32);
+        if (self->m_cache)
+            self->m_cache->setState(object, state);
+        return state;
+    });
+}
+
+QFuture<QVector< QSharedPointer<QAction> > > RegistryPrivate::actionsAsync(const AccessibleObject &object)
+{
+    if (!object.isValid())
+        return readyFuture(QVector< QSharedPointer<QAction> >());
+    {
+        QMutexLocker lock(&object.d->mutex);
+        if (object.d->actionsFetched)
+            return readyFuture(object.d->actions);
+    }
+
+    const QDBusMessage message = QDBusMessage::createMethodCall (
+                object.d->service(), object.d->path(), QLatin1String("org.a11y.atspi.Action"), QLatin1String("GetActions"));
+
+    return asyncCall(message).then([this, object](const QDBusMessage &reply) {
+        return object.d->publishActions(actionsFromReply(object, reply));
+    });
+}
+
+QFuture<int> RegistryPrivate::crawl(const Registry::CrawlOptions &options, const std::function<void(const Registry::CrawledObject &)> &visitor)
+{
+    Crawler *crawler = new Crawler(this, options, visitor);
+    const QFuture<int> future = crawler->future();
+    // the crawler runs in the thread of the registry, it starts once the caller got hold of the future
+    if (QThread::currentThread() == thread())
+        crawler->setParent(this);
+    else
+        crawler->moveToThread(thread());
+    QMetaObject::invokeMethod(crawler, &Crawler::start, Qt::QueuedConnection);
+    return future;
+}
+
+QString RegistryPrivate::serviceOf(const AccessibleObject &object)
+{
+    return object.d->service();
+}
+
+ObjectHandle RegistryPrivate::handleOf(const AccessibleObject &object)
+{
+    return object.d->handle;
+}
+
+AccessibleObject RegistryPrivate::accessibleFromPath(const QString &service, const QString &path) const
+{
+    return AccessibleObject(const_cast<RegistryPrivate*>(this), service, path);
+}
+
+AccessibleObject RegistryPrivate::accessibleFromHandle(ObjectHandle handle) const
+{
+    RegistryPrivate *registryPrivate = const_cast<RegistryPrivate*>(this);
+    if (!m_cache)
+        return AccessibleObject(QSharedPointer<AccessibleObjectPrivate>(new AccessibleObjectPrivate(registryPrivate, handle)));
+    QSharedPointer<AccessibleObjectPrivate> object = m_cache->get(handle);
+    if (!object)
+        object = m_cache->add(handle, QSharedPointer<AccessibleObjectPrivate>(new AccessibleObjectPrivate(registryPrivate, handle)));
+    return AccessibleObject(object);
+}
+
+AccessibleObject RegistryPrivate::cachedAccessible(ObjectHandle handle) const
+{
+    return m_cache ? AccessibleObject(m_cache->get(handle)) : AccessibleObject();
+}
+
+AccessibleObject RegistryPrivate::accessibleFromReference(const QSpiObjectReference &reference) const
+{
+    return accessibleFromPath(reference.service, reference.path.path());
+}
+
+QString RegistryPrivate::eventService() const
+{
+    return m_currentEvent ? m_currentEvent->service : QDBusContext::message().service();
+}
+
+QString RegistryPrivate::eventPath() const
+{
+    return m_currentEvent ? m_currentEvent->path : QDBusContext::message().path();
+}
+
+ObjectHandle RegistryPrivate::eventHandle() const
+{
+    return m_identities.handle(eventService(), eventPath());
+}
+
+template<typename... Signals>
+bool RegistryPrivate::isConnected(Signals... signals) const
+{
+    return (q->isSignalConnected(QMetaMethod::fromSignal(signals)) || ...);
+}
+
+void RegistryPrivate::dispatchEvent(AccessibleEvent::Type type, ObjectHandle handle, int detail1, int detail2, const QVariant &payload)
+{
+    static const QMetaMethod eventSignal = QMetaMethod::fromSignal(&Registry::accessibleEvent);
+    static const QMetaMethod eventsSignal = QMetaMethod::fromSignal(&Registry::accessibleEvents);
+    const bool single = q->isSignalConnected(eventSignal);
+    const bool batched = q->isSignalConnected(eventsSignal);
+    if (!single && !batched)
+        return;
+
+    const AccessibleEvent event(type, handle, detail1, detail2, payload,
+                                m_currentEvent ? m_currentEvent->timestamp : QDeadlineTimer::current().deadlineNSecs());
+    if (single)
+        Q_EMIT q->accessibleEvent(event);
+    if (batched) {
+        if (m_eventBatch.isEmpty())
+            m_eventBatchTimer.start(0);
+        m_eventBatch.append(event);
+    }
+}
+
+void RegistryPrivate::slotEventBatchTimeout()
+{
+    if (!m_eventBatch.isEmpty())
+        Q_EMIT q->accessibleEvents(std::exchange(m_eventBatch, QList<AccessibleEvent>()));
+}
+
+// Window events only carry the object, it is not even created when nobody listens.
+template<typename Signal>
+void RegistryPrivate::emitWindowEvent(AccessibleEvent::Type type, Signal signal)
+{
+    const ObjectHandle handle = eventHandle();
+    dispatchEvent(type, handle);
+    if (isConnected(signal))
+        Q_EMIT (q->*signal)(accessibleFromHandle(handle));
+}
+
+void RegistryPrivate::slotWindowCreate(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &)
+{
+    emitWindowEvent(AccessibleEvent::WindowCreated, &Registry::windowCreated);
+}
+
+void RegistryPrivate::slotWindowDestroy(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+{
+    emitWindowEvent(AccessibleEvent::WindowDestroyed, &Registry::windowDestroyed);
+}
+
+void RegistryPrivate::slotWindowClose(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+{
+    emitWindowEvent(AccessibleEvent::WindowClosed, &Registry::windowClosed);
+}
+
+void RegistryPrivate::slotWindowReparent(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+{
+    emitWindowEvent(AccessibleEvent::WindowReparented, &Registry::windowReparented);
+}
+
+void RegistryPrivate::slotWindowMinimize(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+{
+    emitWindowEvent(AccessibleEvent::WindowMinimized, &Registry::windowMinimized);
+}
+
+void RegistryPrivate::slotWindowMaximize(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+{
+    emitWindowEvent(AccessibleEvent::WindowMaximized, &Registry::windowMaximized);
+}
+
+void RegistryPrivate::slotWindowRestore(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+{
+    emitWindowEvent(AccessibleEvent::WindowRestored, &Registry::windowRestored);
+}
+
+void RegistryPrivate::slotWindowActivate(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+{
+    emitWindowEvent(AccessibleEvent::WindowActivated, &Registry::windowActivated);
+}
+
+void RegistryPrivate::slotWindowDeactivate(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
+{
+    emitWindowEvent(AccessibleEvent::WindowDeactivated, &Registry::windowDeactivated);
 }
 
 void RegistryPrivate::slotWindowDesktopCreate(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->windowDesktopCreated(accessibleFromContext());
+    emitWindowEvent(AccessibleEvent::WindowDesktopCreated, &Registry::windowDesktopCreated);
 }
 
 void RegistryPrivate::slotWindowDesktopDestroy(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->windowDesktopDestroyed(accessibleFromContext());
+    emitWindowEvent(AccessibleEvent::WindowDesktopDestroyed, &Registry::windowDesktopDestroyed);
 }
 
 void RegistryPrivate::slotWindowRaise(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->windowRaised(accessibleFromContext());
+    emitWindowEvent(AccessibleEvent::WindowRaised, &Registry::windowRaised);
 }
 
 void RegistryPrivate::slotWindowLower(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->windowLowered(accessibleFromContext());
+    emitWindowEvent(AccessibleEvent::WindowLowered, &Registry::windowLowered);
 }
 
 void RegistryPrivate::slotWindowMove(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->windowMoved(accessibleFromContext());
+    emitWindowEvent(AccessibleEvent::WindowMoved, &Registry::windowMoved);
 }
 
 void RegistryPrivate::slotWindowResize(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->windowResized(accessibleFromContext());
+    emitWindowEvent(AccessibleEvent::WindowResized, &Registry::windowResized);
 }
 
 void RegistryPrivate::slotWindowShade(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->windowShaded(accessibleFromContext());
+    emitWindowEvent(AccessibleEvent::WindowShaded, &Registry::windowShaded);
 }
 
 void RegistryPrivate::slotWindowUnshade(const QString &state, int detail1, int detail2, const QDBusVariant &/*args*/, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->windowUnshaded(accessibleFromContext());
+    emitWindowEvent(AccessibleEvent::WindowUnshaded, &Registry::windowUnshaded);
 }
 
 void RegistryPrivate::slotPropertyChange(const QString &property, int detail1, int detail2, const QDBusVariant &args, const QSpiObjectReference &reference)
@@ -1399,10 +3505,40 @@ void RegistryPrivate::slotPropertyChange(const QString &property, int detail1, i
 #ifdef ATSPI_DEBUG
     qDebug() << Q_FUNC_INFO << property << detail1 << detail2 << args.variant() << reference.path.path();
 #endif
-    if (property == QLatin1String("accessible-name")) {
-        Q_EMIT q->accessibleNameChanged(accessibleFromContext());
-    } else if (property == QLatin1String("accessible-description")) {
-        Q_EMIT q->accessibleDescriptionChanged(accessibleFromContext());
+    const ObjectHandle handle = eventHandle();
+    // only an object somebody holds on to has cached values that can be stale
+    const AccessibleObject cached = cachedAccessible(handle);
+    switch (EventNames::detail(property)) {
+    case EventNames::AccessibleNameDetail:
+        if (cached.d)
+            m_cache->cleanName(cached);
+        forgetPrefetched(handle, QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE), QLatin1String("Name"));
+        dispatchEvent(AccessibleEvent::NameChanged, handle);
+        if (isConnected(&Registry::accessibleNameChanged))
+            Q_EMIT q->accessibleNameChanged(cached.d ? cached : accessibleFromHandle(handle));
+        break;
+    case EventNames::AccessibleDescriptionDetail:
+        if (cached.d)
+            m_cache->cleanDescription(cached);
+        forgetPrefetched(handle, QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE), QLatin1String("Description"));
+        dispatchEvent(AccessibleEvent::DescriptionChanged, handle);
+        if (isConnected(&Registry::accessibleDescriptionChanged))
+            Q_EMIT q->accessibleDescriptionChanged(cached.d ? cached : accessibleFromHandle(handle));
+        break;
+    case EventNames::AccessibleRoleDetail:
+        if (cached.d)
+            m_cache->cleanRole(cached);
+        break;
+    case EventNames::AccessibleParentDetail:
+        if (cached.d)
+            m_cache->cleanParent(cached);
+        forgetPrefetched(handle, QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE), QLatin1String("Parent"));
+        break;
+    case EventNames::AccessibleValueDetail:
+        forgetPrefetched(handle, QLatin1String(ATSPI_DBUS_INTERFACE_VALUE));
+        break;
+    default:
+        break;
     }
 }
 
@@ -1410,40 +3546,54 @@ void RegistryPrivate::slotStateChanged(const QString &state, int detail1, int de
 {
     //qDebug() << Q_FUNC_INFO << state << detail1 << detail2 << reference.service << reference.path.path() << QDBusContext::message();
 
-    if (state == QLatin1String("defunct") && (detail1 == 1)) {
+    const int stateValue = EventNames::state(state);
+    if (stateValue == AccessibleObject::DefunctState && (detail1 == 1)) {
         QSpiObjectReference removed;
-        removed.service = QDBusContext::message().service();
-        removed.path = QDBusObjectPath(QDBusContext::message().path());
+        removed.service = eventService();
+        removed.path = QDBusObjectPath(eventPath());
         removeAccessibleObject(removed);
         return;
     }
 
-    AccessibleObject accessible = accessibleFromContext();
-    if (m_cache) {
+    const ObjectHandle handle = eventHandle();
+    AccessibleObject accessible = cachedAccessible(handle);
+    if (accessible.d)
         m_cache->cleanState(accessible);
-    }
 
-    if (state == QLatin1String("focused") && (detail1 == 1) &&
-            (q->subscribedEventListeners().testFlag(Registry::Focus))) {
-        Q_EMIT q->focusChanged(accessible);
+    if (stateValue == AccessibleObject::FocusedState && (detail1 == 1) &&
+            (q->subscribedEventListeners().testFlag(Registry::Focus)) && inEventScope(Registry::Focus)) {
+        dispatchEvent(AccessibleEvent::FocusChanged, handle);
+        if (isConnected(&Registry::focusChanged)) {
+            if (!accessible.d)
+                accessible = accessibleFromHandle(handle);
+            Q_EMIT q->focusChanged(accessible);
+        }
     }
 
-    if (q->subscribedEventListeners().testFlag(Registry::StateChanged)) {
-        Q_EMIT q->stateChanged(accessible, state, detail1 == 1);
+    if (q->subscribedEventListeners().testFlag(Registry::StateChanged) && inEventScope(Registry::StateChanged)) {
+        dispatchEvent(AccessibleEvent::StateChanged, handle, detail1, stateValue, state);
+        if (isConnected(&Registry::stateChanged, &Registry::accessibleStateChanged)) {
+            if (!accessible.d)
+                accessible = accessibleFromHandle(handle);
+            if (!coalesceEvent(CoalescedEvent::StateChange, accessible, state, 0, detail1 == 1)) {
+                Q_EMIT q->stateChanged(accessible, state, detail1 == 1);
+                if (stateValue)
+                    Q_EMIT q->accessibleStateChanged(accessible, AccessibleObject::State(stateValue), detail1 == 1);
+            }
+        }
     }
 }
 
 // void RegistryPrivate::slotLinkSelected(const QString &/*state*/, int /*detail1*/, int /*detail2*/, const QDBusVariant &args, const QAccessibleClient::QSpiObjectReference &reference)
 // {
-//     Q_EMIT q->linkSelected(accessibleFromContext());
+//     Q_EMIT q->linkSelected(accessibleFromHandle(eventHandle()));
 // }
 
 bool RegistryPrivate::removeAccessibleObject(const QAccessibleClient::AccessibleObject &accessible)
 {
     Q_ASSERT(accessible.isValid());
     if (m_cache) {
-        const QString id = accessible.id();
-        if (m_cache->remove(id)) {
+        if (m_cache->remove(accessible.d->handle)) {
             Q_EMIT q->removed(accessible);
         }
     } else {
@@ -1467,58 +3617,118 @@ bool RegistryPrivate::removeAccessibleObject(const QAccessibleClient::QSpiObject
 void RegistryPrivate::slotChildrenChanged(const QString &state, int detail1, int detail2, const QDBusVariant &args, const QAccessibleClient::QSpiObjectReference &reference)
 {
 //    qDebug() << Q_FUNC_INFO << state << detail1 << detail2 << args.variant() << reference.path.path();
-    QAccessibleClient::AccessibleObject parentAccessible = accessibleFromContext();
-    if (!parentAccessible.isValid()) {
+    const ObjectHandle handle = eventHandle();
+    if (!m_identities.isValid(handle)) {
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << Q_FUNC_INFO << "Children change with invalid parent." << reference.path.path();
         return;
     }
+    AccessibleObject parentAccessible = cachedAccessible(handle);
+    if (parentAccessible.d)
+        m_cache->cleanChildren(parentAccessible);
+    forgetPrefetched(handle, QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE), QLatin1String("ChildCount"));
 
     const int index = detail1;
-    if (state == QLatin1String("add")) {
-        Q_EMIT q->childAdded(parentAccessible, index);
-    } else if (state == QLatin1String("remove")) {
-        Q_EMIT q->childRemoved(parentAccessible, index);
-    } else {
+    switch (EventNames::detail(state)) {
+    case EventNames::AddDetail:
+        dispatchEvent(AccessibleEvent::ChildAdded, handle, index);
+        if (!isConnected(&Registry::childAdded, &Registry::childrenAdded))
+            break;
+        if (!parentAccessible.d)
+            parentAccessible = accessibleFromHandle(handle);
+        if (!coalesceEvent(CoalescedEvent::ChildrenAdd, parentAccessible, QString(), index))
+            Q_EMIT q->childAdded(parentAccessible, index);
+        break;
+    case EventNames::RemoveDetail:
+        dispatchEvent(AccessibleEvent::ChildRemoved, handle, index);
+        if (!isConnected(&Registry::childRemoved, &Registry::childrenRemoved))
+            break;
+        if (!parentAccessible.d)
+            parentAccessible = accessibleFromHandle(handle);
+        if (!coalesceEvent(CoalescedEvent::ChildrenRemove, parentAccessible, QString(), index))
+            Q_EMIT q->childRemoved(parentAccessible, index);
+        break;
+    default:
         qCWarning(LIBQACCESSIBILITYCLIENT_LOG) << "Invalid state in ChildrenChanged." << state;
+        break;
     }
 }
 
 void RegistryPrivate::slotVisibleDataChanged(const QString &/*state*/, int /*detail1*/, int /*detail2*/, const QDBusVariant &args, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->visibleDataChanged(accessibleFromContext());
+    const ObjectHandle handle = eventHandle();
+    dispatchEvent(AccessibleEvent::VisibleDataChanged, handle);
+    if (!isConnected(&Registry::visibleDataChanged))
+        return;
+    const AccessibleObject accessible = accessibleFromHandle(handle);
+    if (!coalesceEvent(CoalescedEvent::VisibleDataChange, accessible))
+        Q_EMIT q->visibleDataChanged(accessible);
 }
 
 void RegistryPrivate::slotSelectionChanged(const QString &/*state*/, int /*detail1*/, int /*detail2*/, const QDBusVariant &args, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->selectionChanged(accessibleFromContext());
+    const ObjectHandle handle = eventHandle();
+    dispatchEvent(AccessibleEvent::SelectionChanged, handle);
+    if (!isConnected(&Registry::selectionChanged))
+        return;
+    const AccessibleObject accessible = accessibleFromHandle(handle);
+    if (!coalesceEvent(CoalescedEvent::SelectionChange, accessible))
+        Q_EMIT q->selectionChanged(accessible);
 }
 
 void RegistryPrivate::slotModelChanged(const QString &/*state*/, int /*detail1*/, int /*detail2*/, const QDBusVariant &args, const QAccessibleClient::QSpiObjectReference &reference)
 {
-    Q_EMIT q->modelChanged(accessibleFromContext());
+    const ObjectHandle handle = eventHandle();
+    dispatchEvent(AccessibleEvent::ModelChanged, handle);
+    if (!isConnected(&Registry::modelChanged))
+        return;
+    const AccessibleObject accessible = accessibleFromHandle(handle);
+    if (!coalesceEvent(CoalescedEvent::ModelChange, accessible))
+        Q_EMIT q->modelChanged(accessible);
 }
 
 void RegistryPrivate::slotTextCaretMoved(const QString &/*state*/, int detail1, int /*detail2*/, const QDBusVariant &/*args*/, const QSpiObjectReference &reference)
 {
-    Q_EMIT q->textCaretMoved(accessibleFromContext(), detail1);
+    const ObjectHandle handle = eventHandle();
+    const AccessibleObject cached = cachedAccessible(handle);
+    forgetPrefetched(handle, QLatin1String(ATSPI_DBUS_INTERFACE_TEXT), QLatin1String("CaretOffset"));
+    dispatchEvent(AccessibleEvent::TextCaretMoved, handle, detail1);
+    if (isConnected(&Registry::textCaretMoved))
+        Q_EMIT q->textCaretMoved(cached.d ? cached : accessibleFromHandle(handle), detail1);
 }
 
 void RegistryPrivate::slotTextSelectionChanged(const QString &/*state*/, int /*detail1*/, int /*detail2*/, const QDBusVariant &/*args*/, const QSpiObjectReference &reference)
 {
-    Q_EMIT q->textSelectionChanged(accessibleFromContext());
+    const ObjectHandle handle = eventHandle();
+    dispatchEvent(AccessibleEvent::TextSelectionChanged, handle);
+    if (isConnected(&Registry::textSelectionChanged))
+        Q_EMIT q->textSelectionChanged(accessibleFromHandle(handle));
 }
 
 void RegistryPrivate::slotTextChanged(const QString &change, int start, int end, const QDBusVariant &textVariant, const QSpiObjectReference &reference)
 {
-    const AccessibleObject object(accessibleFromContext());
+    const ObjectHandle handle = eventHandle();
+    const AccessibleObject cached = cachedAccessible(handle);
     const QString text = textVariant.variant().toString();
-
-    if (change == QLatin1String("insert")) {
-        Q_EMIT q->textInserted(object, text, start, end);
-    } else if (change == QLatin1String("remove")) {
-        Q_EMIT q->textRemoved(object, text, start, end);
-    } else {
-        Q_EMIT q->textChanged(object, text, start, end);
+    forgetPrefetched(handle, QLatin1String(ATSPI_DBUS_INTERFACE_TEXT));
+
+    switch (EventNames::detail(change)) {
+    case EventNames::InsertDetail:
+        dispatchEvent(AccessibleEvent::TextInserted, handle, start, end, text);
+        if (isConnected(&Registry::textInserted))
+            Q_EMIT q->textInserted(cached.d ? cached : accessibleFromHandle(handle), text, start, end);
+        break;
+    // AT-SPI calls it delete, remove is kept for the providers that followed this library
+    case EventNames::DeleteDetail:
+    case EventNames::RemoveDetail:
+        dispatchEvent(AccessibleEvent::TextRemoved, handle, start, end, text);
+        if (isConnected(&Registry::textRemoved))
+            Q_EMIT q->textRemoved(cached.d ? cached : accessibleFromHandle(handle), text, start, end);
+        break;
+    default:
+        dispatchEvent(AccessibleEvent::TextChanged, handle, start, end, text);
+        if (isConnected(&Registry::textChanged))
+            Q_EMIT q->textChanged(cached.d ? cached : accessibleFromHandle(handle), text, start, end);
+        break;
     }
 }
 
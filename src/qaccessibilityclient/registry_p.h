@@ -11,9 +11,20 @@
 
 #include <QObject>
 #include <QMap>
+#include <QMultiHash>
+#include <QSet>
+#include <QFuture>
 #include <QDBusContext>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
 #include <QSignalMapper>
 #include <QSharedPointer>
+#include <QTimer>
+#include <QPromise>
+#include <QMutex>
+
+#include <list>
+#include <memory>
 
 #include "atspi/dbusconnection.h"
 #include "qaccessibilityclient/registry.h"
@@ -21,8 +32,12 @@
 #include "qaccessibilityclient/accessibleobject_p.h"
 #include "atspi/qt-atspi.h"
 #include "cachestrategy_p.h"
+#include "eventreceiver_p.h"
+#include "identitytable_p.h"
 
 class QDBusPendingCallWatcher;
+class QDBusServiceWatcher;
+class QThread;
 
 namespace QAccessibleClient {
 
@@ -47,6 +62,12 @@ public:
 
     void subscribeEventListeners(const Registry::EventListeners & listeners);
     Registry::EventListeners eventListeners() const;
+    void setEventScope(const QList<AccessibleObject> &applications, Registry::EventListeners listeners);
+    QList<AccessibleObject> eventScope(Registry::EventListener listener) const;
+    void setEventReceiverThread(bool enabled, int capacity);
+    Registry::EventQueueStatistics eventQueueStatistics() const;
+    bool subscribeEventDetails(Registry::EventListener listener, const QStringList &details);
+    QStringList subscribedEventDetails(Registry::EventListener listener) const;
 
     QString accessibleId(const AccessibleObject &object) const;
     QString name(const AccessibleObject &object) const;
@@ -96,6 +117,7 @@ public:
     QRect imageRect(const AccessibleObject &object) const;
 
     QVector< QSharedPointer<QAction> > actions(const AccessibleObject &object);
+    QVector< QSharedPointer<QAction> > actionsFromReply(const AccessibleObject &object, const QDBusMessage &message);
 
     QList<AccessibleObject> topLevelAccessibles() const;
     AccessibleObject parentAccessible(const AccessibleObject &object) const;
@@ -105,12 +127,68 @@ public:
     AccessibleObject child(const AccessibleObject &object, int index) const;
     QList<AccessibleObject> children(const AccessibleObject &object) const;
 
+    void prefetch(const AccessibleObject &object, AccessibleObject::Interfaces interfaces);
+    Registry::QueryResult query(const QList<AccessibleObject> &objects, Registry::QueryFields fields) const;
+    QList<AccessibleObject> findMatches(const AccessibleObject &object, const QList<AccessibleObject::Role> &roles,
+                                        const QList<AccessibleObject::State> &states, AccessibleObject::Interfaces interfaces,
+                                        const QMap<QString, QString> &attributes, int depth, int limit) const;
+    QMap<QString, QString> attributes(const AccessibleObject &object) const;
+
+    QList<AccessibleObject> snapshotApplication(const AccessibleObject &application);
+    bool mirrorApplication(const AccessibleObject &application);
+    void stopMirroring(const AccessibleObject &application);
+    void stopMirroring(const QString &service);
+    bool isMirrored(const AccessibleObject &application) const;
+
+    QFuture<QString> accessibleIdAsync(const AccessibleObject &object) const;
+    QFuture<QString> nameAsync(const AccessibleObject &object) const;
+    QFuture<QString> descriptionAsync(const AccessibleObject &object) const;
+    QFuture<AccessibleObject::Role> roleAsync(const AccessibleObject &object) const;
+    QFuture<QString> roleNameAsync(const AccessibleObject &object) const;
+    QFuture<QString> localizedRoleNameAsync(const AccessibleObject &object) const;
+    QFuture<QRect> boundingRectAsync(const AccessibleObject &object) const;
+    QFuture<AccessibleObject::Interfaces> supportedInterfacesAsync(const AccessibleObject &object) const;
+    QFuture<int> caretOffsetAsync(const AccessibleObject &object) const;
+    QFuture<int> characterCountAsync(const AccessibleObject &object) const;
+    QFuture<QString> textAsync(const AccessibleObject &object, int startOffset = 0, int endOffset = -1) const;
+    QFuture<AccessibleObject> applicationAsync(const AccessibleObject &object) const;
+    QFuture<double> currentValueAsync(const AccessibleObject &object) const;
+    QFuture<double> minimumValueAsync(const AccessibleObject &object) const;
+    QFuture<double> maximumValueAsync(const AccessibleObject &object) const;
+    QFuture<double> minimumValueIncrementAsync(const AccessibleObject &object) const;
+    QFuture<int> layerAsync(const AccessibleObject &object) const;
+    QFuture<int> mdiZOrderAsync(const AccessibleObject &object) const;
+    QFuture<double> alphaAsync(const AccessibleObject &object) const;
+    QFuture<QRect> characterRectAsync(const AccessibleObject &object, int offset) const;
+    QFuture<QList< QPair<int,int> > > textSelectionsAsync(const AccessibleObject &object) const;
+    QFuture<AccessibleObject::TextRange> textWithBoundaryAsync(const AccessibleObject &object, int offset, AccessibleObject::TextBoundary boundary) const;
+    QFuture<QString> appToolkitNameAsync(const AccessibleObject &object) const;
+    QFuture<QString> appVersionAsync(const AccessibleObject &object) const;
+    QFuture<int> appIdAsync(const AccessibleObject &object) const;
+    QFuture<QString> appLocaleAsync(const AccessibleObject &object, uint lctype) const;
+    QFuture<QString> appBusAddressAsync(const AccessibleObject &object) const;
+    QFuture<QList<AccessibleObject> > selectionAsync(const AccessibleObject &object) const;
+    QFuture<QString> imageDescriptionAsync(const AccessibleObject &object) const;
+    QFuture<QString> imageLocaleAsync(const AccessibleObject &object) const;
+    QFuture<QRect> imageRectAsync(const AccessibleObject &object) const;
+    QFuture<quint64> stateAsync(const AccessibleObject &object) const;
+    QFuture<QVector< QSharedPointer<QAction> > > actionsAsync(const AccessibleObject &object);
+    QFuture<QList<AccessibleObject> > topLevelAccessiblesAsync() const;
+    QFuture<AccessibleObject> parentAccessibleAsync(const AccessibleObject &object) const;
+    QFuture<int> childCountAsync(const AccessibleObject &object) const;
+    QFuture<int> indexInParentAsync(const AccessibleObject &object) const;
+    QFuture<AccessibleObject> childAsync(const AccessibleObject &object, int index) const;
+    QFuture<QList<AccessibleObject> > childrenAsync(const AccessibleObject &object) const;
+
+    QFuture<int> crawl(const Registry::CrawlOptions &options, const std::function<void(const Registry::CrawledObject &)> &visitor);
+    static QString serviceOf(const AccessibleObject &object);
+    static ObjectHandle handleOf(const AccessibleObject &object);
+
     static QString ACCESSIBLE_OBJECT_SCHEME_STRING;
 
 private Q_SLOTS:
     AccessibleObject accessibleFromPath(const QString &service, const QString &path) const;
     AccessibleObject accessibleFromReference(const QSpiObjectReference &reference) const;
-    AccessibleObject accessibleFromContext() const;
 
     void connectionFetched();
     void slotSubscribeEventListenerFinished(QDBusPendingCallWatcher *call);
@@ -153,20 +231,192 @@ private Q_SLOTS:
     //void slotTextAttributesChanged(const QString &state, int detail1, int detail2, const QDBusVariant &args, const QAccessibleClient::QSpiObjectReference &reference);
     //void slotAttributesChanged(const QString &state, int detail1, int detail2, const QDBusVariant &args, const QAccessibleClient::QSpiObjectReference &reference);
 
+    void slotCacheAddAccessible(const QDBusMessage &message);
+    void slotCacheRemoveAccessible(const QDBusMessage &message);
+    void slotMirroredServiceUnregistered(const QString &service);
+    void slotNameOwnerChanged(const QString &name, const QString &oldOwner, const QString &newOwner);
+
     void actionTriggered(const QString &action);
+    void slotCacheStatisticsTimeout();
+    void slotCoalescingTimeout();
+    void slotEventBatchTimeout();
+    void slotDrainEvents();
 
 private:
     QVariant getProperty ( const QString &service, const QString &path, const QString &interface, const QString &name ) const;
+    QFuture<QDBusMessage> asyncCall(const QDBusMessage &message, int timeout = -1) const;
+    void startAsyncCall(const QDBusMessage &message, int timeout, const std::shared_ptr<QPromise<QDBusMessage> > &promise) const;
+    void sendAsyncCall(const QDBusMessage &message, int timeout, const std::shared_ptr<QPromise<QDBusMessage> > &promise) const;
+    QDBusMessage call(const QDBusMessage &message, int timeout = -1) const;
+    QDBusPendingCall pendingCall(const QDBusMessage &message, int timeout = -1) const;
+    int callTimeout(const QDBusMessage &message, int timeout = -1) const;
+    bool admitCall(const QString &service) const;
+    // latency in microseconds
+    void recordCallResult(const QDBusMessage &message, const QDBusMessage &reply, qint64 latency) const;
+    static QString callKey(const QDBusMessage &message);
+    void dumpCallStatistics() const;
+    void probeService(const QString &service) const;
+    QList<Registry::ServiceHealth> serviceHealth() const;
+    QVariant getProperty(const AccessibleObject &object, const QString &interface, const QString &name) const;
+    QFuture<QVariant> getPropertyAsync(const AccessibleObject &object, const QString &interface, const QString &name) const;
+    static QVariant prefetchedProperty(const AccessibleObject &object, const QString &interface, const QString &name);
+    // Drops prefetched values of the objects of \a handle, all of the interface if \a name is empty.
+    void forgetPrefetched(ObjectHandle handle, const QString &interface, const QString &name = QString());
+    // Removes the entries of destroyed objects of \a handle from the prefetched objects.
+    void removePrefetchedObject(ObjectHandle handle);
+    static QVariant propertyFromReply(const QDBusMessage &reply);
+    AccessibleObject parentFromProperty(const AccessibleObject &object, const QVariant &parent) const;
+    AccessibleObject parentFromReference(const AccessibleObject &object, const QSpiObjectReference &parent) const;
+    QList<AccessibleObject> accessiblesFromReply(const QDBusMessage &reply) const;
+    QList<AccessibleObject> accessiblesFromReferences(const QSpiObjectReferenceList &references) const;
+    void cacheItem(const AccessibleObject &object, const QSpiAccessibleCacheItem &item, bool mirrored);
     static AccessibleObject::Role atspiRoleToRole(AtspiRole role);
+    // Keeps cachesProperties() and cachesChildren() up to date, they are read from any thread.
+    void updateCachedValues();
+    // Forgets the cached properties when the events invalidating them stop, mirrored applications keep theirs.
+    void clearCachedProperties();
+    bool cachesProperties() const;
+    bool collectionMatches(const AccessibleObject &object, const QList<AccessibleObject::Role> &roles,
+                           const QList<AccessibleObject::State> &states, AccessibleObject::Interfaces interfaces,
+                           const QMap<QString, QString> &attributes, int depth, int limit, QList<AccessibleObject> *matches) const;
+    void walkMatches(const AccessibleObject &object, const QList<AccessibleObject::Role> &roles,
+                     quint64 states, AccessibleObject::Interfaces interfaces,
+                     const QMap<QString, QString> &attributes, int depth, int limit, QList<AccessibleObject> *matches) const;
+    bool cachesChildren() const;
+
+    // The senders whose events \a listeners receive, a single empty service for all of them.
+    QStringList eventScopeServices(Registry::EventListeners listeners) const;
+    // Whether the scope of \a listener takes the current event, its slot may be connected for more senders.
+    bool inEventScope(Registry::EventListener listener) const;
+    // The handlers of the AT-SPI events, one match rule is installed per D-Bus signal.
+    typedef void (RegistryPrivate::*EventHandler)(const QString &, int, int, const QDBusVariant &, const QSpiObjectReference &);
+    struct EventConnection {
+        Registry::EventListeners listeners;
+        const char *interface;
+        const char *member;
+        const char *slot;
+        EventHandler handler;
+    };
+    static const QList<EventConnection> &eventConnections();
+    void disconnectEvents();
+    // Sender and path of the event being handled, from the D-Bus message or the record of the receiver thread.
+    QString eventService() const;
+    QString eventPath() const;
+    ObjectHandle eventHandle() const;
+    // The object of \a handle, shared with the cache if there is one.
+    AccessibleObject accessibleFromHandle(ObjectHandle handle) const;
+    // The cached object of \a handle, an invalid one if there is no cache or it is not cached.
+    AccessibleObject cachedAccessible(ObjectHandle handle) const;
+    // Whether any of \a signals of the registry has a receiver, the objects of events nobody receives are not created.
+    template<typename... Signals>
+    bool isConnected(Signals... signals) const;
+
+    // The details the events of \a listeners are limited to, none if they are not.
+    QStringList eventDetails(Registry::EventListeners listeners) const;
+    // Registers the events with the registry daemon and adds and removes the match rules of
+    // the event slots to fit the subscriptions, their scope and details.
+    void updateEventConnections();
+    // Emits accessibleEvent() and queues the event for accessibleEvents(), \a handle is the one of the current event.
+    void dispatchEvent(AccessibleEvent::Type type, ObjectHandle handle, int detail1 = 0, int detail2 = 0, const QVariant &payload = QVariant());
+    template<typename Signal>
+    void emitWindowEvent(AccessibleEvent::Type type, Signal signal);
+
+    // An event held back by the coalescing, see Registry::EventCoalescing.
+    struct CoalescedEvent {
+        enum Type { StateChange, ChildrenAdd, ChildrenRemove, VisibleDataChange, SelectionChange, ModelChange };
+        Type type;
+        AccessibleObject object;
+        // the state for StateChange, the range of indexes for the children changes
+        QString state;
+        int first;
+        int last;
+        bool active;
+
+        // Takes over a later event of the same kind, false if its index does not continue the range.
+        bool merge(int index, bool isActive);
+    };
+    struct CoalescingKey {
+        ObjectHandle handle;
+        int type;
+        QString state;
+
+        friend bool operator==(const CoalescingKey &lhs, const CoalescingKey &rhs)
+        {
+            return lhs.handle == rhs.handle && lhs.type == rhs.type && lhs.state == rhs.state;
+        }
+        friend size_t qHash(const CoalescingKey &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.handle, key.type, key.state);
+        }
+    };
+    // Returns false if coalescing is disabled and the event needs to be emitted right away.
+    bool coalesceEvent(CoalescedEvent::Type type, const AccessibleObject &object,
+                       const QString &state = QString(), int index = 0, bool active = false);
+    void flushCoalescedEvents(int limit);
+    void flushCoalescedEvent(const CoalescingKey &key);
+    void emitCoalescedEvent(const CoalescedEvent &event);
 
     DBusConnection conn;
-    QSignalMapper m_actionMapper;
     Registry *const q;
     Registry::EventListeners m_subscriptions;
     Registry::EventListeners m_pendingSubscriptions;
+    // applications the events of a listener are limited to, missing listeners are not limited
+    QHash<Registry::EventListener, QList<AccessibleObject> > m_eventScopes;
+    // senders of the listeners whose slot is connected for more senders because another listener shares it
+    QHash<Registry::EventListener, QStringList> m_sharedSlotScopes;
+    // details the events of a listener are limited to, missing listeners are not limited
+    QHash<Registry::EventListener, QStringList> m_eventDetails;
+    // the events announced to the registry daemon
+    QStringList m_registeredEvents;
+    // sender and detail each event slot is connected for, by index into the table of event connections
+    typedef QPair<QString, QString> EventMatch;
+    QHash<int, QList<EventMatch> > m_eventConnections;
+    // asynchronous calls issued before the a11y bus connection was available
+    struct QueuedCall {
+        QDBusMessage message;
+        int timeout;
+        std::shared_ptr<QPromise<QDBusMessage> > promise;
+    };
+    mutable QList<QueuedCall> m_queuedCalls;
+    // guards the queued calls, the call policy and the statistics and health below,
+    // blocking calls may be made from any thread
+    mutable QMutex m_callMutex;
+    Registry::CallPolicy m_callPolicy;
+    // call statistics per service, a service is quarantined once it timed out failureThreshold times in a row
+    mutable QHash<QString, Registry::ServiceHealth> m_serviceHealth;
+    // timing of all calls, by interface and method and by destination
+    mutable QHash<QString, Registry::CallStatistics> m_methodStatistics;
+    mutable QHash<QString, Registry::CallStatistics> m_serviceStatistics;
     QHash<QString, AccessibleObject::Interface> interfaceHash;
     QSignalMapper m_eventMapper;
     ObjectCache *m_cache = nullptr;
+    enum CachedValue { CachedProperties = 0x1, CachedChildren = 0x2 };
+    QAtomicInt m_cachedValues = 0;
+    // objects holding prefetched values, found by the events that make them stale also without a cache
+    mutable QMutex m_prefetchedMutex;
+    QMultiHash<ObjectHandle, QWeakPointer<AccessibleObjectPrivate> > m_prefetchedObjects;
+    // limits of the StrongLruCache
+    int m_cacheMaxObjects = 10000;
+    qint64 m_cacheMaxBytes = 16 * 1024 * 1024;
+    QTimer m_statisticsTimer;
+    Registry::EventCoalescing m_coalescing;
+    Registry::EventCoalescingStatistics m_coalescingStatistics;
+    // held back events in the order they first arrived, the hash finds the one to merge into
+    std::list<CoalescedEvent> m_coalescedEvents;
+    QHash<CoalescingKey, std::list<CoalescedEvent>::iterator> m_coalescedIndex;
+    QTimer m_coalescingTimer;
+    // events waiting for the next accessibleEvents()
+    QList<AccessibleEvent> m_eventBatch;
+    QTimer m_eventBatchTimer;
+    // with Registry::setEventReceiverThread() the events arrive in m_eventReceiver on m_eventThread
+    QThread *m_eventThread = nullptr;
+    EventReceiver *m_eventReceiver = nullptr;
+    const EventReceiver::EventRecord *m_currentEvent = nullptr;
+    quint64 m_eventsDelivered = 0;
+    IdentityTable m_identities;
+    // Objects of mirrored applications, kept alive so their cache entries stay valid.
+    QHash<QString, QSet<AccessibleObject> > m_mirroredApplications;
+    QDBusServiceWatcher *m_mirrorWatcher = nullptr;
 //     typedef QMap<QString, QSharedPointer<AccessibleObjectPrivate> >::Iterator AccessibleObjectsHashIterator;
 //     typedef QMap<QString, QSharedPointer<AccessibleObjectPrivate> >::ConstIterator AccessibleObjectsHashConstIterator;
 //     QMap<QString, QSharedPointer<AccessibleObjectPrivate> > accessibleObjectsHash;
@@ -176,6 +426,7 @@ private:
     friend class Registry;
     friend class AccessibleObject;
     friend class AccessibleObjectPrivate;
+    friend class RegistryPrivateCacheApi;
 };
 
 }
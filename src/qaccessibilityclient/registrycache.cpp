@@ -4,6 +4,7 @@
 
 #include "registrycache_p.h"
 #include "registry.h"
+#include "registry_p.h"
 
 using namespace QAccessibleClient;
 
@@ -34,3 +35,37 @@ void RegistryPrivateCacheApi::clearClientCache()
 {
     m_registry->clearClientCache();
 }
+
+void RegistryPrivateCacheApi::setCacheLimits(int maxObjects, qint64 maxBytes)
+{
+    RegistryPrivate *d = m_registry->d;
+    d->m_cacheMaxObjects = maxObjects;
+    d->m_cacheMaxBytes = maxBytes;
+    if (CacheStrongLruStrategy *lru = dynamic_cast<CacheStrongLruStrategy*>(d->m_cache))
+        lru->setLimits(maxObjects, maxBytes);
+}
+
+quint64 RegistryPrivateCacheApi::cacheHits() const
+{
+    const CacheStrongLruStrategy *lru = dynamic_cast<CacheStrongLruStrategy*>(m_registry->d->m_cache);
+    return lru ? lru->hits() : 0;
+}
+
+quint64 RegistryPrivateCacheApi::cacheMisses() const
+{
+    const CacheStrongLruStrategy *lru = dynamic_cast<CacheStrongLruStrategy*>(m_registry->d->m_cache);
+    return lru ? lru->misses() : 0;
+}
+
+quint64 RegistryPrivateCacheApi::cacheEvictions() const
+{
+    const CacheStrongLruStrategy *lru = dynamic_cast<CacheStrongLruStrategy*>(m_registry->d->m_cache);
+    return lru ? lru->evictions() : 0;
+}
+
+int RegistryPrivateCacheApi::queuedCallCount() const
+{
+    const RegistryPrivate *d = m_registry->d;
+    QMutexLocker lock(&d->m_callMutex);
+    return int(d->m_queuedCalls.size());
+}
@@ -21,6 +21,7 @@ public:
     enum CacheType {
         NoCache, ///< Disable any caching.
         WeakCache, ///< Cache only objects in use and free them as long as no-one holds a reference to them any longer.
+        StrongLruCache, ///< Additionally keep the most recently used objects alive, up to the limits of setCacheLimits().
     };
 
     explicit RegistryPrivateCacheApi(Registry *registry);
@@ -32,6 +33,16 @@ public:
     QStringList clientCacheObjects() const;
     void clearClientCache();
 
+    // Limits of the StrongLruCache, 0 means unlimited. Defaults to 10000 objects and 16 MiB.
+    void setCacheLimits(int maxObjects, qint64 maxBytes);
+    // Lookups of the StrongLruCache that found an object, that did not and objects released because of the limits.
+    quint64 cacheHits() const;
+    quint64 cacheMisses() const;
+    quint64 cacheEvictions() const;
+
+    // Asynchronous calls waiting for the a11y bus connection.
+    int queuedCallCount() const;
+
 private:
     Registry *const m_registry;
 };
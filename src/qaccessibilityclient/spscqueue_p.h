@@ -0,0 +1,93 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef QACCESSIBILITYCLIENT_SPSCQUEUE_P_H
+#define QACCESSIBILITYCLIENT_SPSCQUEUE_P_H
+
+#include <QAtomicInteger>
+#include <QtGlobal>
+
+#include <utility>
+#include <vector>
+
+namespace QAccessibleClient {
+
+/*
+    A bounded ring buffer handing values from one thread to another.
+
+    Exactly one thread may push and exactly one thread may pop, then
+    neither needs a lock: the producer only writes the tail, the
+    consumer only the head, and each publishes its index with release
+    semantics after touching the slot. The capacity is rounded up to a
+    power of two, the indexes run freely and are masked on access.
+
+    push() fails instead of blocking when the buffer is full, the
+    caller decides whether to drop or retry.
+*/
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(int capacity)
+        : m_slots(roundedCapacity(capacity))
+        , m_mask(quint32(m_slots.size()) - 1)
+    {
+    }
+
+    Q_DISABLE_COPY(SpscQueue)
+
+    int capacity() const
+    {
+        return int(m_slots.size());
+    }
+
+    // Only for the producer.
+    bool push(T &&value)
+    {
+        const quint32 tail = m_tail.loadRelaxed();
+        if (tail - m_head.loadAcquire() > m_mask)
+            return false;
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.storeRelease(tail + 1);
+        return true;
+    }
+
+    // Only for the consumer.
+    bool pop(T &value)
+    {
+        const quint32 head = m_head.loadRelaxed();
+        if (head == m_tail.loadAcquire())
+            return false;
+        value = std::exchange(m_slots[head & m_mask], T());
+        m_head.storeRelease(head + 1);
+        return true;
+    }
+
+    // Exact on either side of the queue, a snapshot anywhere else.
+    int size() const
+    {
+        return int(m_tail.loadAcquire() - m_head.loadAcquire());
+    }
+
+private:
+    static std::size_t roundedCapacity(int capacity)
+    {
+        std::size_t size = 1;
+        while (size < std::size_t(qMax(capacity, 1)))
+            size <<= 1;
+        return size;
+    }
+
+    std::vector<T> m_slots;
+    const quint32 m_mask;
+    // on separate cache lines, each is written by one side only
+    alignas(64) QAtomicInteger<quint32> m_head = 0;
+    alignas(64) QAtomicInteger<quint32> m_tail = 0;
+};
+
+}
+
+#endif
@@ -11,17 +11,33 @@
 #include <QTextEdit>
 #include <QLabel>
 #include <QLineEdit>
+#include <QSlider>
 #include <QBoxLayout>
 #include <QAccessible>
 #include <QDebug>
 #include <QProcess>
 #include <QFileInfo>
+#include <QSignalSpy>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QScopeGuard>
+#include <QThread>
+
+#include <functional>
+#include <numeric>
 
 #include "qaccessibilityclient/registry.h"
 #include "qaccessibilityclient/accessibleobject.h"
+#include "qaccessibilityclient/registrycache_p.h"
+#include "qaccessibilityclient/eventnames_p.h"
+#include "qaccessibilityclient/identitytable_p.h"
 
+#include "atspi/atspi-constants.h"
 #include "atspi/dbusconnection.h"
 
+#include "mockatspiapplication.h"
+
 typedef QSharedPointer<QAccessibleInterface> QAIPointer;
 
 using namespace QAccessibleClient;
@@ -59,13 +75,37 @@ private Q_SLOTS:
     void tst_hashable();
     void tst_application();
     void tst_navigation();
+    void tst_asyncNavigation();
+    void tst_asyncBeforeConnection();
+    void tst_blockingBeforeConnection();
     void tst_focus();
     void tst_states();
+    void tst_propertyCache();
+    void tst_lruCache();
+    void tst_prefetch();
+    void tst_query();
+    void tst_findMatches();
+    void tst_callPolicy();
+    void tst_serviceHealth();
+    void tst_callStatistics();
 
     void tst_extents();
 
     void tst_characterExtents();
 
+    void tst_mockProvider();
+    void tst_snapshotCache();
+    void tst_serviceLeaves();
+    void tst_eventNames();
+    void tst_identityTable();
+    void tst_eventCoalescing();
+    void tst_accessibleEvent();
+    void tst_eventScope();
+    void tst_eventDetails();
+    void tst_eventReceiverThread();
+    void tst_concurrentAccess();
+    void tst_crawl();
+
 private:
     bool startHelperProcess();
     Registry registry;
@@ -271,6 +311,447 @@ void AccessibilityClientTest::tst_navigation()
     QVERIFY(!accLine.isVisible());
 }
 
+void AccessibilityClientTest::tst_asyncNavigation()
+{
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.setAccessibleName(QStringLiteral("Root Widget"));
+    w.setAccessibleDescription(QStringLiteral("This is a useless widget"));
+    QVBoxLayout *layout = new QVBoxLayout;
+    w.setLayout(layout);
+
+    QPushButton *button = new QPushButton;
+    layout->addWidget(button);
+    button->setText(QLatin1String("Hello a11y"));
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    QFuture<QList<AccessibleObject> > apps = registry.applicationsAsync();
+    QTRY_VERIFY(apps.isFinished());
+    AccessibleObject accApp;
+    const QList<AccessibleObject> appList = apps.result();
+    for (const AccessibleObject &app : appList) {
+        if (app.name() == appName) {
+            accApp = app;
+            break;
+        }
+    }
+    QVERIFY(accApp.isValid());
+
+    QFuture<int> childCount = accApp.childCountAsync();
+    QFuture<AccessibleObject> rootWidget = accApp.childAsync(0);
+    QTRY_VERIFY(childCount.isFinished() && rootWidget.isFinished());
+    QCOMPARE(childCount.result(), 1);
+    AccessibleObject accW = rootWidget.result();
+    QVERIFY(accW.isValid());
+
+    // issue all queries at once, then wait for the replies
+    QFuture<QString> name = accW.nameAsync();
+    QFuture<QString> description = accW.descriptionAsync();
+    QFuture<AccessibleObject::Role> role = accW.roleAsync();
+    QFuture<QList<AccessibleObject> > children = accW.childrenAsync();
+    QFuture<AccessibleObject> parent = accW.parentAsync();
+    QFuture<int> index = accW.indexInParentAsync();
+    QTRY_VERIFY(name.isFinished() && description.isFinished() && role.isFinished()
+                && children.isFinished() && parent.isFinished() && index.isFinished());
+
+    QCOMPARE(name.result(), w.accessibleName());
+    QCOMPARE(description.result(), w.accessibleDescription());
+    QCOMPARE(role.result(), AccessibleObject::Filler);
+    QCOMPARE(children.result().count(), 1);
+    QCOMPARE(children.result().first(), accW.child(0));
+    QCOMPARE(parent.result(), accApp);
+    QCOMPARE(index.result(), 0);
+
+    const AccessibleObject accButton = children.result().first();
+    QFuture<QString> buttonName = accButton.nameAsync();
+    QFuture<quint64> buttonState = accButton.stateAsync();
+    QFuture<QVector< QSharedPointer<QAction> > > buttonActions = accButton.actionsAsync();
+    QTRY_VERIFY(buttonName.isFinished() && buttonState.isFinished() && buttonActions.isFinished());
+    QCOMPARE(buttonName.result(), button->text());
+    QCOMPARE(bool(buttonState.result() & (quint64(1) << AccessibleObject::FocusableState)), accButton.isFocusable());
+    QCOMPARE(bool(buttonState.result() & (quint64(1) << AccessibleObject::EnabledState)), accButton.isEnabled());
+    QVERIFY(!buttonActions.result().isEmpty());
+    // fetched once, the blocking accessor returns the same actions
+    QCOMPARE(buttonActions.result(), accButton.actions());
+
+    // the remaining getters deliver what their blocking variants return
+    QFuture<QString> toolkit = accApp.appToolkitNameAsync();
+    QFuture<int> appId = accApp.appIdAsync();
+    QFuture<int> layer = accButton.layerAsync();
+    QFuture<double> alpha = accButton.alphaAsync();
+    QFuture<QList<AccessibleObject> > selection = accW.selectionAsync();
+    QTRY_VERIFY(toolkit.isFinished() && appId.isFinished() && layer.isFinished() && alpha.isFinished() && selection.isFinished());
+    QCOMPARE(toolkit.result(), accApp.appToolkitName());
+    QCOMPARE(appId.result(), accApp.appId());
+    QCOMPARE(layer.result(), accButton.layer());
+    QCOMPARE(alpha.result(), accButton.alpha());
+    QVERIFY(selection.result().isEmpty());
+}
+
+void AccessibilityClientTest::tst_propertyCache()
+{
+    RegistryPrivateCacheApi cache(&registry);
+    cache.setCacheType(RegistryPrivateCacheApi::WeakCache);
+    registry.subscribeEventListeners(Registry::PropertyChanged | Registry::ChildrenChanged);
+    QSignalSpy nameChanged(&registry, &Registry::accessibleNameChanged);
+
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.setAccessibleName(QStringLiteral("Root Widget"));
+    QVBoxLayout *layout = new QVBoxLayout;
+    w.setLayout(layout);
+
+    QPushButton *button = new QPushButton;
+    layout->addWidget(button);
+    button->setText(QLatin1String("Hello a11y"));
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    AccessibleObject accApp = getAppObject(registry, appName);
+    QVERIFY(accApp.isValid());
+    AccessibleObject accW = accApp.child(0);
+    QVERIFY(accW.isValid());
+    QCOMPARE(accW.childCount(), 1);
+    AccessibleObject accButton = accW.child(0);
+    QVERIFY(accButton.isValid());
+
+    // the first read fills the cache, the name change event has to invalidate it
+    registry.resetCacheStatistics();
+    QCOMPARE(accButton.name(), button->text());
+    QCOMPARE(accButton.name(), button->text());
+    QCOMPARE(accButton.role(), AccessibleObject::Button);
+    QCOMPARE(accButton.parent(), accW);
+    Registry::CacheStatistics statistics = registry.cacheStatistics();
+    QCOMPARE(statistics.names.misses, quint64(1));
+    QCOMPARE(statistics.names.hits, quint64(1));
+    QVERIFY(statistics.objectCount > 0);
+    QVERIFY(statistics.approximateBytes > 0);
+    button->setText(QLatin1String("Changed"));
+    QTRY_VERIFY(!nameChanged.isEmpty());
+    QVERIFY(registry.cacheStatistics().invalidations > statistics.invalidations);
+    QCOMPARE(accButton.name(), button->text());
+    QCOMPARE(accButton.role(), AccessibleObject::Button);
+
+    QSignalSpy statisticsUpdated(&registry, &Registry::cacheStatisticsUpdated);
+    registry.setCacheStatisticsInterval(10);
+    QTRY_VERIFY(!statisticsUpdated.isEmpty());
+    registry.setCacheStatisticsInterval(0);
+
+    // objects are cached by handle, looking them up by id still works
+    QVERIFY(cache.clientCacheObjects().contains(accButton.id()));
+    QCOMPARE(cache.clientCacheObject(accButton.id()), accButton);
+    QCOMPARE(registry.accessibleFromUrl(accButton.url()), accButton);
+
+    cache.setCacheType(RegistryPrivateCacheApi::NoCache);
+}
+
+void AccessibilityClientTest::tst_lruCache()
+{
+    RegistryPrivateCacheApi cache(&registry);
+    cache.setCacheLimits(2, 0);
+    cache.setCacheType(RegistryPrivateCacheApi::StrongLruCache);
+    QCOMPARE(cache.cacheType(), RegistryPrivateCacheApi::StrongLruCache);
+
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.setAccessibleName(QStringLiteral("Root Widget"));
+    QVBoxLayout *layout = new QVBoxLayout;
+    w.setLayout(layout);
+    for (int i = 0; i < 4; ++i)
+        layout->addWidget(new QPushButton(QStringLiteral("Button %1").arg(i)));
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    AccessibleObject accApp = getAppObject(registry, appName);
+    QVERIFY(accApp.isValid());
+    AccessibleObject accW = accApp.child(0);
+    QVERIFY(accW.isValid());
+
+    // the cache keeps an object alive after the last handle is gone
+    QString id = accW.child(0).id();
+    QVERIFY(cache.clientCacheObject(id).isValid());
+    const quint64 hits = cache.cacheHits();
+    QVERIFY(accW.child(0).isValid());
+    QVERIFY(cache.cacheHits() > hits);
+
+    // ... but only up to the limit
+    const quint64 evictions = cache.cacheEvictions();
+    for (int i = 1; i < 4; ++i)
+        QVERIFY(accW.child(i).isValid());
+    QVERIFY(cache.cacheEvictions() > evictions);
+    QVERIFY(!cache.clientCacheObject(id).isValid());
+
+    cache.setCacheLimits(10000, 16 * 1024 * 1024);
+    cache.setCacheType(RegistryPrivateCacheApi::NoCache);
+}
+
+void AccessibilityClientTest::tst_prefetch()
+{
+    registry.subscribeEventListeners(Registry::PropertyChanged);
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.setAccessibleName(QStringLiteral("Root Widget"));
+    QVBoxLayout *layout = new QVBoxLayout;
+    w.setLayout(layout);
+
+    QSlider *slider = new QSlider(Qt::Horizontal);
+    slider->setAccessibleName(QStringLiteral("Volume"));
+    slider->setRange(10, 90);
+    slider->setValue(42);
+    layout->addWidget(slider);
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    AccessibleObject accApp = getAppObject(registry, appName);
+    QVERIFY(accApp.isValid());
+    AccessibleObject accSlider = accApp.child(0).child(0);
+    QVERIFY(accSlider.isValid());
+
+    accSlider.prefetch(AccessibleObject::AccessibleInterface | AccessibleObject::ValueInterface);
+    QCOMPARE(accSlider.name(), slider->accessibleName());
+    QCOMPARE(accSlider.childCount(), 0);
+    QCOMPARE(accSlider.parent(), accApp.child(0));
+    QCOMPARE(accSlider.minimumValue(), 10.0);
+    QCOMPARE(accSlider.maximumValue(), 90.0);
+    QCOMPARE(accSlider.currentValue(), 42.0);
+
+    // the value change event drops the prefetched value, the registry of the test has no cache
+    slider->setValue(57);
+    QTRY_COMPARE(accSlider.currentValue(), 57.0);
+    QCOMPARE(accSlider.maximumValue(), 90.0);
+}
+
+void AccessibilityClientTest::tst_query()
+{
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.setAccessibleName(QStringLiteral("Root Widget"));
+    QVBoxLayout *layout = new QVBoxLayout;
+    w.setLayout(layout);
+
+    const int buttonCount = 20;
+    for (int i = 0; i < buttonCount; ++i) {
+        QPushButton *button = new QPushButton(QStringLiteral("Button %1").arg(i));
+        layout->addWidget(button);
+    }
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    AccessibleObject accApp = getAppObject(registry, appName);
+    QVERIFY(accApp.isValid());
+    const QList<AccessibleObject> buttons = accApp.child(0).children();
+    QCOMPARE(buttons.size(), buttonCount);
+
+    const Registry::QueryResult result = registry.query(buttons, Registry::QueryName | Registry::QueryRole | Registry::QueryChildCount);
+    QCOMPARE(result.objects, buttons);
+    QCOMPARE(result.names.size(), buttonCount);
+    QCOMPARE(result.roles.size(), buttonCount);
+    QCOMPARE(result.childCounts.size(), buttonCount);
+    QVERIFY(result.descriptions.isEmpty());
+    for (int i = 0; i < buttonCount; ++i) {
+        QCOMPARE(result.names.at(i), QStringLiteral("Button %1").arg(i));
+        QCOMPARE(result.roles.at(i), AccessibleObject::Button);
+        QCOMPARE(result.childCounts.at(i), 0);
+    }
+}
+
+void AccessibilityClientTest::tst_findMatches()
+{
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.setAccessibleName(QStringLiteral("Root Widget"));
+    QVBoxLayout *layout = new QVBoxLayout;
+    w.setLayout(layout);
+
+    QPushButton *button1 = new QPushButton(QStringLiteral("One"));
+    layout->addWidget(button1);
+    QLabel *label = new QLabel(QStringLiteral("Some label"));
+    layout->addWidget(label);
+    QWidget *group = new QWidget;
+    QVBoxLayout *groupLayout = new QVBoxLayout;
+    group->setLayout(groupLayout);
+    QPushButton *button2 = new QPushButton(QStringLiteral("Two"));
+    groupLayout->addWidget(button2);
+    QPushButton *button3 = new QPushButton(QStringLiteral("Three"));
+    button3->setEnabled(false);
+    groupLayout->addWidget(button3);
+    layout->addWidget(group);
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    AccessibleObject accApp = getAppObject(registry, appName);
+    QVERIFY(accApp.isValid());
+    AccessibleObject accW = accApp.child(0);
+    QVERIFY(accW.isValid());
+
+    const QList<AccessibleObject::Role> buttonRole = QList<AccessibleObject::Role>() << AccessibleObject::Button;
+    QList<AccessibleObject> buttons = accW.findMatches(buttonRole);
+    QCOMPARE(buttons.size(), 3);
+    QCOMPARE(buttons.at(0).name(), button1->text());
+    QCOMPARE(buttons.at(1).name(), button2->text());
+    QCOMPARE(buttons.at(2).name(), button3->text());
+
+    buttons = accW.findMatches(buttonRole, QList<AccessibleObject::State>() << AccessibleObject::EnabledState);
+    QCOMPARE(buttons.size(), 2);
+
+    QCOMPARE(accW.findMatches(buttonRole, QList<AccessibleObject::State>(), AccessibleObject::NoInterface, QMap<QString, QString>(), 1).size(), 1);
+    QCOMPARE(accW.findMatches(buttonRole, QList<AccessibleObject::State>(), AccessibleObject::NoInterface, QMap<QString, QString>(), -1, 2).size(), 2);
+    QCOMPARE(accW.findMatches(QList<AccessibleObject::Role>() << AccessibleObject::Label).size(), 1);
+}
+
+void AccessibilityClientTest::tst_callPolicy()
+{
+    const Registry::CallPolicy defaults = registry.callPolicy();
+    QCOMPARE(defaults.defaultTimeout, 500);
+    QVERIFY(defaults.interfaceTimeouts.value(QStringLiteral("org.a11y.atspi.Cache")) > defaults.defaultTimeout);
+    // calls changing the application may wait for a modal dialog
+    QCOMPARE(defaults.interfaceTimeouts.value(QStringLiteral("org.a11y.atspi.Action.DoAction")), 25000);
+    QCOMPARE(defaults.interfaceTimeouts.value(QStringLiteral("org.a11y.atspi.EditableText")), 25000);
+    QCOMPARE(defaults.interfaceTimeouts.value(QStringLiteral("org.a11y.atspi.Value.SetCurrentValue")), 25000);
+    QVERIFY(!defaults.interfaceTimeouts.contains(QStringLiteral("org.a11y.atspi.Value")));
+    QVERIFY(defaults.failureThreshold > 0);
+
+    Registry::CallPolicy policy = defaults;
+    policy.defaultTimeout = 2000;
+    policy.interfaceTimeouts.insert(QStringLiteral("org.a11y.atspi.Text"), 100);
+    policy.failureThreshold = 1;
+    registry.setCallPolicy(policy);
+    QCOMPARE(registry.callPolicy().defaultTimeout, 2000);
+    QCOMPARE(registry.callPolicy().interfaceTimeouts.value(QStringLiteral("org.a11y.atspi.Text")), 100);
+
+    // errors of services that answer do not count as failures
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.setAccessibleName(QStringLiteral("Root Widget"));
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+    AccessibleObject accApp = getAppObject(registry, appName);
+    QVERIFY(accApp.isValid());
+    QVERIFY(accApp.text().isEmpty());
+    QCOMPARE(accApp.child(0).name(), QStringLiteral("Root Widget"));
+
+    registry.setCallPolicy(defaults);
+}
+
+void AccessibilityClientTest::tst_serviceHealth()
+{
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.setAccessibleName(QStringLiteral("Root Widget"));
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    AccessibleObject accApp = getAppObject(registry, appName);
+    QVERIFY(accApp.isValid());
+    QCOMPARE(accApp.child(0).name(), QStringLiteral("Root Widget"));
+
+    const QString service = accApp.url().fragment();
+    bool found = false;
+    const QList<Registry::ServiceHealth> health = registry.serviceHealth();
+    for (const Registry::ServiceHealth &entry : health) {
+        if (entry.service != service)
+            continue;
+        found = true;
+        QVERIFY(entry.calls > 0);
+        QCOMPARE(entry.timeouts, 0);
+        QCOMPARE(entry.consecutiveTimeouts, 0);
+        QVERIFY(!entry.quarantined);
+    }
+    QVERIFY(found);
+}
+
+void AccessibilityClientTest::tst_callStatistics()
+{
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.setAccessibleName(QStringLiteral("Root Widget"));
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    AccessibleObject accApp = getAppObject(registry, appName);
+    QVERIFY(accApp.isValid());
+    AccessibleObject accW = accApp.child(0);
+    QVERIFY(accW.isValid());
+
+    registry.resetCallStatistics();
+    QVERIFY(registry.callStatisticsByMethod().isEmpty());
+    QCOMPARE(accW.name(), QStringLiteral("Root Widget"));
+
+    bool found = false;
+    const QList<Registry::CallStatistics> methods = registry.callStatisticsByMethod();
+    for (const Registry::CallStatistics &entry : methods) {
+        if (entry.key != QLatin1String("Properties.Get:Name"))
+            continue;
+        found = true;
+        QCOMPARE(entry.calls, quint64(1));
+        QCOMPARE(entry.errors, quint64(0));
+        QCOMPARE(entry.histogram.size(), Registry::CallStatistics::HistogramBuckets);
+        QCOMPARE(std::accumulate(entry.histogram.cbegin(), entry.histogram.cend(), quint64(0)), entry.calls);
+    }
+    QVERIFY(found);
+
+    const QList<Registry::CallStatistics> services = registry.callStatisticsByService();
+    QCOMPARE(services.size(), 1);
+    QCOMPARE(services.first().key, accW.url().fragment());
+    registry.dumpCallStatistics();
+}
+
+void AccessibilityClientTest::tst_asyncBeforeConnection()
+{
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    // the a11y bus address is still being resolved, the call has to be queued instead of blocking
+    Registry freshRegistry;
+    RegistryPrivateCacheApi hooks(&freshRegistry);
+    QFuture<QList<AccessibleObject> > apps = freshRegistry.applicationsAsync();
+    QVERIFY(!apps.isFinished());
+    QCOMPARE(hooks.queuedCallCount(), 1);
+    QTRY_VERIFY(apps.isFinished());
+    QCOMPARE(hooks.queuedCallCount(), 0);
+    bool found = false;
+    const QList<AccessibleObject> appList = apps.result();
+    for (const AccessibleObject &app : appList) {
+        found = found || app.name() == appName;
+    }
+    QVERIFY(found);
+}
+
+void AccessibilityClientTest::tst_blockingBeforeConnection()
+{
+    QString appName = QLatin1String("Lib QAccessibleClient test");
+    qApp->setApplicationName(appName);
+    QWidget w;
+    w.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&w));
+
+    // the first call waits for the a11y bus address before the event loop got to deliver it
+    Registry freshRegistry;
+    const QList<AccessibleObject> appList = freshRegistry.applications();
+    bool found = false;
+    for (const AccessibleObject &app : appList) {
+        found = found || app.name() == appName;
+    }
+    QVERIFY(found);
+
+    // the answer of the address lookup queued meanwhile does not fetch the connection again
+    QTest::qWait(100);
+    QVERIFY(getAppObject(freshRegistry, appName).isValid());
+}
+
 bool AccessibilityClientTest::startHelperProcess()
 {
     if (!QFileInfo(QCoreApplication::applicationDirPath() + QStringLiteral("/simplewidgetapp")).exists()) {
@@ -472,6 +953,747 @@ void AccessibilityClientTest::tst_characterExtents()
 }
 
 
+void AccessibilityClientTest::tst_mockProvider()
+{
+    // 40 nodes with 4 children each, nodes 10 to 39 are the leaves
+    MockAtspiApplication *mock = new MockAtspiApplication(40, 4);
+    QVERIFY(mock->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_mockprovider"))));
+    QThread thread;
+    mock->moveToThread(&thread);
+    connect(&thread, &QThread::finished, mock, &QObject::deleteLater);
+    thread.start();
+    const auto stop = qScopeGuard([&thread]() {
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_mockprovider"));
+    });
+
+    QUrl url;
+    url.setScheme(QLatin1String("accessibleobject"));
+    url.setPath(mock->path(0));
+    url.setFragment(mock->service());
+    const AccessibleObject root = registry.accessibleFromUrl(url);
+    QVERIFY(root.isValid());
+    QCOMPARE(root.name(), QStringLiteral("mock application"));
+    QCOMPARE(root.childCount(), 4);
+    QVERIFY(root.supportedInterfaces() & AccessibleObject::ApplicationInterface);
+
+    const AccessibleObject button = root.child(1).child(3);
+    QCOMPARE(button.name(), QStringLiteral("node 12"));
+    QCOMPARE(button.role(), AccessibleObject::Button);
+    QCOMPARE(button.parent().parent(), root);
+    QCOMPARE(button.application(), root);
+    QCOMPARE(button.boundingRect(), QRect(240, 0, 20, 20));
+    QCOMPARE(button.actions().size(), 1);
+    QCOMPARE(button.actions().first()->text(), QStringLiteral("press"));
+
+    const AccessibleObject text = root.child(2).child(0);
+    QCOMPARE(text.role(), AccessibleObject::Text);
+    QCOMPARE(text.text(), QStringLiteral("Text of node 13"));
+    QCOMPARE(text.characterCount(), 15);
+    QCOMPARE(text.characterRect(2), QRect(276, 0, 8, 20));
+
+    const AccessibleObject slider = root.child(2).child(1);
+    QCOMPARE(slider.role(), AccessibleObject::Slider);
+    QCOMPARE(slider.maximumValue(), 100.0);
+    QCOMPARE(slider.currentValue(), 14.0);
+
+    QCOMPARE(registry.snapshotApplication(root).size(), 40);
+
+    registry.subscribeEventListeners(Registry::StateChanged);
+    QSignalSpy stateSpy(&registry, SIGNAL(stateChanged(QAccessibleClient::AccessibleObject,QString,bool)));
+    QSignalSpy typedStateSpy(&registry, SIGNAL(accessibleStateChanged(QAccessibleClient::AccessibleObject,QAccessibleClient::AccessibleObject::State,bool)));
+    mock->sendStateChanged(5);
+    QTRY_COMPARE(stateSpy.count(), 5);
+    QCOMPARE(typedStateSpy.count(), 5);
+    QCOMPARE(stateSpy.first().at(1).toString(), QStringLiteral("checked"));
+    QCOMPARE(typedStateSpy.first().at(1).value<AccessibleObject::State>(), AccessibleObject::CheckedState);
+    QCOMPARE(typedStateSpy.first().at(2).toBool(), true);
+
+    const auto health = [this, mock]() {
+        const QList<Registry::ServiceHealth> entries = registry.serviceHealth();
+        for (const Registry::ServiceHealth &entry : entries) {
+            if (entry.service == mock->service())
+                return entry;
+        }
+        return Registry::ServiceHealth();
+    };
+
+    const int errors = health().errors;
+    mock->setFailureRate(1.0);
+    QCOMPARE(text.text(), QString());
+    QCOMPARE(health().errors, errors + 1);
+    mock->setFailureRate(0.0);
+
+    const int timeouts = health().timeouts;
+    mock->setTimeoutRate(1.0);
+    QCOMPARE(text.text(), QString());
+    QCOMPARE(health().timeouts, timeouts + 1);
+    mock->setTimeoutRate(0.0);
+
+    mock->setLatency(100);
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(text.text(), QStringLiteral("Text of node 13"));
+    QVERIFY(timer.elapsed() >= 100);
+    mock->setLatency(0);
+}
+
+void AccessibilityClientTest::tst_snapshotCache()
+{
+    MockAtspiApplication *mock = new MockAtspiApplication(10, 3);
+    QVERIFY(mock->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_snapshotcache"))));
+    QThread thread;
+    mock->moveToThread(&thread);
+    connect(&thread, &QThread::finished, mock, &QObject::deleteLater);
+    thread.start();
+    RegistryPrivateCacheApi cache(&registry);
+    cache.setCacheType(RegistryPrivateCacheApi::WeakCache);
+    const auto stop = qScopeGuard([this, &thread, &cache]() {
+        registry.subscribeEventListeners(Registry::NoEventListeners);
+        cache.setCacheType(RegistryPrivateCacheApi::NoCache);
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_snapshotcache"));
+    });
+
+    QUrl url;
+    url.setScheme(QLatin1String("accessibleobject"));
+    url.setPath(mock->path(0));
+    url.setFragment(mock->service());
+    const AccessibleObject root = registry.accessibleFromUrl(url);
+
+    // without the events nothing would tell that the names got stale, they are not cached
+    registry.subscribeEventListeners(Registry::NoEventListeners);
+    const QList<AccessibleObject> objects = registry.snapshotApplication(root);
+    QCOMPARE(objects.size(), 10);
+    registry.resetCacheStatistics();
+    QCOMPARE(objects.at(1).name(), QStringLiteral("node 1"));
+    QCOMPARE(registry.cacheStatistics().names.hits, quint64(0));
+
+    // mirrored trees are kept up to date by the cache signals and outlive the subscription
+    registry.subscribeEventListeners(Registry::PropertyChanged | Registry::ChildrenChanged);
+    QVERIFY(registry.mirrorApplication(root));
+    registry.subscribeEventListeners(Registry::NoEventListeners);
+    registry.resetCacheStatistics();
+    QCOMPARE(objects.at(1).name(), QStringLiteral("node 1"));
+    QCOMPARE(objects.at(1).childCount(), 3);
+    const Registry::CacheStatistics statistics = registry.cacheStatistics();
+    QCOMPARE(statistics.names.hits, quint64(1));
+    QCOMPARE(statistics.names.misses, quint64(0));
+    registry.stopMirroring(root);
+}
+
+void AccessibilityClientTest::tst_serviceLeaves()
+{
+    MockAtspiApplication *mock = new MockAtspiApplication(10, 3);
+    QVERIFY(mock->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_serviceleaves"))));
+    QThread thread;
+    mock->moveToThread(&thread);
+    connect(&thread, &QThread::finished, mock, &QObject::deleteLater);
+    thread.start();
+    auto stop = qScopeGuard([&thread]() {
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_serviceleaves"));
+    });
+
+    QUrl url;
+    url.setScheme(QLatin1String("accessibleobject"));
+    url.setPath(mock->path(0));
+    url.setFragment(mock->service());
+    const AccessibleObject root = registry.accessibleFromUrl(url);
+    const AccessibleObject child = root.child(0);
+    QVERIFY(root.isValid());
+    QVERIFY(child.isValid());
+
+    // the names and paths interned for the application are dropped once it left the bus
+    stop.dismiss();
+    thread.quit();
+    thread.wait();
+    QDBusConnection::disconnectFromBus(QLatin1String("tst_serviceleaves"));
+    QTRY_VERIFY(!root.isValid());
+    QVERIFY(!child.isValid());
+}
+
+void AccessibilityClientTest::tst_eventNames()
+{
+    for (int state = AccessibleObject::ActiveState; state <= AccessibleObject::VisitedState; ++state) {
+        const QString name = EventNames::stateName(AccessibleObject::State(state));
+        QCOMPARE(EventNames::state(name), state);
+    }
+    QCOMPARE(EventNames::state(u"focused"), int(AccessibleObject::FocusedState));
+    QCOMPARE(EventNames::state(u"defunct"), int(AccessibleObject::DefunctState));
+    QCOMPARE(EventNames::state(u"focus"), 0);
+    QCOMPARE(EventNames::state(u""), 0);
+    QCOMPARE(EventNames::state(u"f\u00f6cused"), 0);
+
+    QCOMPARE(EventNames::detail(u"add"), EventNames::AddDetail);
+    QCOMPARE(EventNames::detail(u"delete"), EventNames::DeleteDetail);
+    QCOMPARE(EventNames::detail(u"accessible-name"), EventNames::AccessibleNameDetail);
+    QCOMPARE(EventNames::detail(u"accessible-value"), EventNames::AccessibleValueDetail);
+    QCOMPARE(EventNames::detail(u"accessible-table-caption"), EventNames::UnknownDetail);
+}
+
+void AccessibilityClientTest::tst_identityTable()
+{
+    IdentityTable table;
+    const QString root = QLatin1String("/org/a11y/atspi/accessible/root");
+    const ObjectHandle first = table.handle(QLatin1String(":1.1"), root);
+    const ObjectHandle second = table.handle(QLatin1String(":1.2"), root);
+    QVERIFY(first != second);
+    QCOMPARE(quint32(first), quint32(second));
+    QCOMPARE(table.path(second), root);
+    QCOMPARE(table.id(first), root + QLatin1String(":1.1"));
+    QCOMPARE(table.find(root + QLatin1String(":1.2")), std::optional<ObjectHandle>(second));
+
+    const ObjectHandle numbered = table.handle(QLatin1String(":1.1"), QLatin1String("/org/a11y/atspi/accessible/42"));
+    QCOMPARE(quint32(numbered), 42u);
+    QVERIFY(!table.isValid(table.handle(QLatin1String(":1.2"), QLatin1String("/org/a11y/atspi/null"))));
+    QCOMPARE(table.internedPathCount(), 2);
+
+    // a path stays while any service uses it
+    table.removeService(QLatin1String(":1.1"));
+    QCOMPARE(table.path(second), root);
+    QVERIFY(table.path(first).isEmpty());
+    QCOMPARE(table.internedPathCount(), 2);
+    table.removeService(QLatin1String(":1.2"));
+    QCOMPARE(table.internedPathCount(), 0);
+    QCOMPARE(table.serviceCount(), 0);
+}
+
+void AccessibilityClientTest::tst_eventCoalescing()
+{
+    MockAtspiApplication *mock = new MockAtspiApplication(10, 4);
+    QVERIFY(mock->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_eventcoalescing"))));
+    QThread thread;
+    mock->moveToThread(&thread);
+    connect(&thread, &QThread::finished, mock, &QObject::deleteLater);
+    thread.start();
+    const auto stop = qScopeGuard([this, &thread]() {
+        registry.setEventCoalescing(Registry::EventCoalescing());
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_eventcoalescing"));
+    });
+
+    registry.subscribeEventListeners(Registry::StateChanged | Registry::ChildrenChanged | Registry::VisibleDataChanged);
+    Registry::EventCoalescing coalescing;
+    coalescing.window = 500;
+    registry.setEventCoalescing(coalescing);
+    registry.resetEventCoalescingStatistics();
+
+    QSignalSpy stateSpy(&registry, SIGNAL(stateChanged(QAccessibleClient::AccessibleObject,QString,bool)));
+    QStringList childrenChanges;
+    QObject context;
+    connect(&registry, &Registry::childAdded, &context, [&childrenChanges](const AccessibleObject &, int index) {
+        childrenChanges.append(QStringLiteral("add %1").arg(index));
+    });
+    connect(&registry, &Registry::childrenAdded, &context, [&childrenChanges](const AccessibleObject &, int first, int last) {
+        childrenChanges.append(QStringLiteral("add %1-%2").arg(first).arg(last));
+    });
+    connect(&registry, &Registry::childRemoved, &context, [&childrenChanges](const AccessibleObject &, int index) {
+        childrenChanges.append(QStringLiteral("remove %1").arg(index));
+    });
+
+    // last value wins for the state, consecutive added children become one range
+    MockAtspiApplication::Event state;
+    state.interface = QLatin1String(ATSPI_DBUS_INTERFACE_EVENT_OBJECT);
+    state.member = QLatin1String("StateChanged");
+    state.detail = QLatin1String("checked");
+    state.detail1 = 1;
+    state.node = 1;
+    mock->sendEvents(state, 20);
+    state.detail1 = 0;
+    mock->sendEvents(state, 1);
+    MockAtspiApplication::Event children = state;
+    children.member = QLatin1String("ChildrenChanged");
+    children.detail = QLatin1String("add");
+    for (const int index : { 2, 3, 4, 40 }) {
+        children.detail1 = index;
+        mock->sendEvents(children, 1);
+    }
+    // a removal in between keeps its place, the following addition is not merged across it
+    children.detail = QLatin1String("remove");
+    children.detail1 = 3;
+    mock->sendEvents(children, 1);
+    children.detail = QLatin1String("add");
+    children.detail1 = 5;
+    mock->sendEvents(children, 1);
+
+    const QStringList expectedChanges = { QStringLiteral("add 2-4"), QStringLiteral("add 40"), QStringLiteral("remove 3"), QStringLiteral("add 5") };
+    QTRY_COMPARE(childrenChanges, expectedChanges);
+    QTRY_COMPARE(stateSpy.count(), 1);
+    QCOMPARE(stateSpy.first().at(0).value<AccessibleObject>().name(), QStringLiteral("node 1"));
+    QCOMPARE(stateSpy.first().at(2).toBool(), false);
+
+    Registry::EventCoalescingStatistics statistics = registry.eventCoalescingStatistics();
+    QCOMPARE(statistics.received, quint64(27));
+    QCOMPARE(statistics.merged, quint64(22));
+    QCOMPARE(statistics.emitted, quint64(5));
+    QCOMPARE(statistics.dropped, quint64(0));
+    QCOMPARE(statistics.pending, 0);
+
+    // only one event is held back, the one of another object is dropped
+    coalescing.maxPendingEvents = 1;
+    registry.setEventCoalescing(coalescing);
+    registry.resetEventCoalescingStatistics();
+    QSignalSpy visibleDataSpy(&registry, SIGNAL(visibleDataChanged(QAccessibleClient::AccessibleObject)));
+    MockAtspiApplication::Event visibleData = state;
+    visibleData.member = QLatin1String("VisibleDataChanged");
+    visibleData.detail.clear();
+    visibleData.node = 2;
+    mock->sendEvents(visibleData, 3);
+    visibleData.node = 3;
+    mock->sendEvents(visibleData, 1);
+
+    QTRY_COMPARE(registry.eventCoalescingStatistics().received, quint64(4));
+    QTRY_COMPARE(visibleDataSpy.count(), 1);
+    statistics = registry.eventCoalescingStatistics();
+    QCOMPARE(statistics.merged, quint64(2));
+    QCOMPARE(statistics.dropped, quint64(1));
+    QCOMPARE(statistics.emitted, quint64(1));
+
+    // disabling the coalescing delivers events right away
+    registry.setEventCoalescing(Registry::EventCoalescing());
+    mock->sendEvents(visibleData, 2);
+    QTRY_COMPARE(visibleDataSpy.count(), 3);
+}
+
+void AccessibilityClientTest::tst_accessibleEvent()
+{
+    MockAtspiApplication *mock = new MockAtspiApplication(10, 4);
+    QVERIFY(mock->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_accessibleevent"))));
+    QThread thread;
+    mock->moveToThread(&thread);
+    connect(&thread, &QThread::finished, mock, &QObject::deleteLater);
+    thread.start();
+    const auto stop = qScopeGuard([&thread]() {
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_accessibleevent"));
+    });
+
+    registry.subscribeEventListeners(Registry::StateChanged | Registry::ChildrenChanged);
+    QSignalSpy eventSpy(&registry, SIGNAL(accessibleEvent(QAccessibleClient::AccessibleEvent)));
+    QSignalSpy batchSpy(&registry, SIGNAL(accessibleEvents(QList<QAccessibleClient::AccessibleEvent>)));
+
+    MockAtspiApplication::Event state;
+    state.interface = QLatin1String(ATSPI_DBUS_INTERFACE_EVENT_OBJECT);
+    state.member = QLatin1String("StateChanged");
+    state.detail = QLatin1String("checked");
+    state.detail1 = 1;
+    state.node = 1;
+    mock->sendEvents(state, 3);
+    MockAtspiApplication::Event children = state;
+    children.member = QLatin1String("ChildrenChanged");
+    children.detail = QLatin1String("add");
+    children.detail1 = 2;
+    mock->sendEvents(children, 1);
+
+    QTRY_COMPARE(eventSpy.count(), 4);
+    const AccessibleEvent stateEvent = eventSpy.first().at(0).value<AccessibleEvent>();
+    QVERIFY(stateEvent.isValid());
+    QCOMPARE(stateEvent.type(), AccessibleEvent::StateChanged);
+    QCOMPARE(stateEvent.detail1(), 1);
+    QCOMPARE(stateEvent.detail2(), int(AccessibleObject::CheckedState));
+    QCOMPARE(stateEvent.payload().toString(), QStringLiteral("checked"));
+    QVERIFY(stateEvent.timestamp() > 0);
+    QCOMPARE(registry.accessibleFromEvent(stateEvent).name(), QStringLiteral("node 1"));
+
+    const AccessibleEvent childEvent = eventSpy.last().at(0).value<AccessibleEvent>();
+    QCOMPARE(childEvent.type(), AccessibleEvent::ChildAdded);
+    QCOMPARE(childEvent.detail1(), 2);
+    QCOMPARE(childEvent.handle(), stateEvent.handle());
+    QVERIFY(childEvent.timestamp() >= stateEvent.timestamp());
+
+    // the batches hold the same events in the same order
+    const auto batchedEvents = [&batchSpy]() {
+        QList<AccessibleEvent> events;
+        for (const QList<QVariant> &arguments : std::as_const(batchSpy))
+            events += arguments.at(0).value<QList<AccessibleEvent> >();
+        return events;
+    };
+    QTRY_COMPARE(batchedEvents().size(), 4);
+    const QList<AccessibleEvent> batched = batchedEvents();
+    QCOMPARE(batched.first().type(), AccessibleEvent::StateChanged);
+    QCOMPARE(batched.last().type(), AccessibleEvent::ChildAdded);
+    QCOMPARE(batched.last().timestamp(), childEvent.timestamp());
+
+    QVERIFY(!AccessibleEvent().isValid());
+    QVERIFY(!registry.accessibleFromEvent(AccessibleEvent()).isValid());
+}
+
+void AccessibilityClientTest::tst_eventScope()
+{
+    // two applications, events are only wanted from the first one
+    MockAtspiApplication *wanted = new MockAtspiApplication(4, 4);
+    MockAtspiApplication *other = new MockAtspiApplication(4, 4);
+    QVERIFY(wanted->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_eventscope_wanted"))));
+    QVERIFY(other->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_eventscope_other"))));
+    QThread thread;
+    wanted->moveToThread(&thread);
+    other->moveToThread(&thread);
+    connect(&thread, &QThread::finished, wanted, &QObject::deleteLater);
+    connect(&thread, &QThread::finished, other, &QObject::deleteLater);
+    thread.start();
+    const auto stop = qScopeGuard([this, &thread]() {
+        registry.setEventScope(QList<AccessibleObject>());
+        registry.subscribeEventListeners(Registry::NoEventListeners);
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_eventscope_wanted"));
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_eventscope_other"));
+    });
+
+    QUrl url;
+    url.setScheme(QLatin1String("accessibleobject"));
+    url.setPath(wanted->path(0));
+    url.setFragment(wanted->service());
+    const AccessibleObject application = registry.accessibleFromUrl(url);
+    QVERIFY(application.isValid());
+
+    registry.subscribeEventListeners(Registry::StateChanged | Registry::ChildrenChanged);
+    registry.setEventScope(QList<AccessibleObject>() << application, Registry::StateChanged);
+    QCOMPARE(registry.eventScope(Registry::StateChanged), QList<AccessibleObject>() << application);
+    QVERIFY(registry.eventScope(Registry::ChildrenChanged).isEmpty());
+
+    QSignalSpy stateSpy(&registry, SIGNAL(stateChanged(QAccessibleClient::AccessibleObject,QString,bool)));
+    QSignalSpy childSpy(&registry, SIGNAL(childAdded(QAccessibleClient::AccessibleObject,int)));
+    const auto senders = [](const QSignalSpy &spy) {
+        QStringList services;
+        for (const QList<QVariant> &arguments : spy)
+            services.append(arguments.at(0).value<AccessibleObject>().url().fragment());
+        services.removeDuplicates();
+        return services;
+    };
+
+    MockAtspiApplication::Event children;
+    children.interface = QLatin1String(ATSPI_DBUS_INTERFACE_EVENT_OBJECT);
+    children.member = QLatin1String("ChildrenChanged");
+    children.detail = QLatin1String("add");
+    children.node = 0;
+    other->sendStateChanged(5);
+    other->sendEvents(children, 1);
+    wanted->sendStateChanged(3);
+    wanted->sendEvents(children, 1);
+
+    // the children changes are not limited and arrive from both
+    QTRY_COMPARE(childSpy.count(), 2);
+    QTRY_COMPARE(stateSpy.count(), 3);
+    QTest::qWait(100);
+    QCOMPARE(stateSpy.count(), 3);
+    QCOMPARE(senders(stateSpy), QStringList() << wanted->service());
+
+    // focus events share the slot of the state changes, they do not widen the scope of the state changes
+    registry.subscribeEventListeners(Registry::StateChanged | Registry::ChildrenChanged | Registry::Focus);
+    stateSpy.clear();
+    other->sendStateChanged(2);
+    wanted->sendStateChanged(1);
+    QTRY_COMPARE(stateSpy.count(), 1);
+    QTest::qWait(100);
+    QCOMPARE(senders(stateSpy), QStringList() << wanted->service());
+
+    // lifting the limit delivers the events of all applications again
+    registry.setEventScope(QList<AccessibleObject>(), Registry::StateChanged);
+    QVERIFY(registry.eventScope(Registry::StateChanged).isEmpty());
+    stateSpy.clear();
+    other->sendStateChanged(2);
+    QTRY_COMPARE(stateSpy.count(), 2);
+    QCOMPARE(senders(stateSpy), QStringList() << other->service());
+}
+
+void AccessibilityClientTest::tst_eventDetails()
+{
+    MockAtspiApplication *mock = new MockAtspiApplication(4, 4);
+    QVERIFY(mock->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_eventdetails"))));
+    QThread thread;
+    mock->moveToThread(&thread);
+    connect(&thread, &QThread::finished, mock, &QObject::deleteLater);
+    thread.start();
+    const auto stop = qScopeGuard([this, &thread]() {
+        registry.subscribeEventDetails(Registry::StateChanged, QStringList());
+        registry.subscribeEventListeners(Registry::NoEventListeners);
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_eventdetails"));
+    });
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("cannot be limited to details")));
+    QVERIFY(!registry.subscribeEventDetails(Registry::Window, QStringList() << QLatin1String("create")));
+    QVERIFY(registry.subscribedEventDetails(Registry::Window).isEmpty());
+
+    registry.subscribeEventListeners(Registry::StateChanged);
+    QVERIFY(registry.subscribeEventDetails(Registry::StateChanged, QStringList() << QLatin1String("focused")));
+    QCOMPARE(registry.subscribedEventDetails(Registry::StateChanged), QStringList() << QLatin1String("focused"));
+
+    QSignalSpy stateSpy(&registry, SIGNAL(stateChanged(QAccessibleClient::AccessibleObject,QString,bool)));
+    MockAtspiApplication::Event state;
+    state.interface = QLatin1String(ATSPI_DBUS_INTERFACE_EVENT_OBJECT);
+    state.member = QLatin1String("StateChanged");
+    state.detail = QLatin1String("checked");
+    state.detail1 = 1;
+    state.node = 1;
+    mock->sendEvents(state, 3);
+    state.detail = QLatin1String("focused");
+    mock->sendEvents(state, 2);
+
+    // the checked events do not match, they are not delivered at all
+    QTRY_COMPARE(stateSpy.count(), 2);
+    QTest::qWait(100);
+    QCOMPARE(stateSpy.count(), 2);
+    for (const QList<QVariant> &arguments : std::as_const(stateSpy))
+        QCOMPARE(arguments.at(1).toString(), QStringLiteral("focused"));
+
+    QVERIFY(registry.subscribeEventDetails(Registry::StateChanged, QStringList()));
+    stateSpy.clear();
+    state.detail = QLatin1String("checked");
+    mock->sendEvents(state, 3);
+    QTRY_COMPARE(stateSpy.count(), 3);
+}
+
+void AccessibilityClientTest::tst_eventReceiverThread()
+{
+    MockAtspiApplication *mock = new MockAtspiApplication(4, 4);
+    QVERIFY(mock->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_eventreceiverthread"))));
+    QThread thread;
+    mock->moveToThread(&thread);
+    connect(&thread, &QThread::finished, mock, &QObject::deleteLater);
+    thread.start();
+    const auto stop = qScopeGuard([this, &thread]() {
+        registry.setEventReceiverThread(false);
+        registry.subscribeEventListeners(Registry::NoEventListeners);
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_eventreceiverthread"));
+    });
+
+    QCOMPARE(registry.eventQueueStatistics().capacity, 0);
+    registry.subscribeEventListeners(Registry::StateChanged);
+    registry.setEventReceiverThread(true, 100);
+    QVERIFY(registry.isEventReceiverThreadEnabled());
+    QCOMPARE(registry.eventQueueStatistics().capacity, 128);
+
+    QSignalSpy stateSpy(&registry, SIGNAL(stateChanged(QAccessibleClient::AccessibleObject,QString,bool)));
+    MockAtspiApplication::Event state;
+    state.interface = QLatin1String(ATSPI_DBUS_INTERFACE_EVENT_OBJECT);
+    state.member = QLatin1String("StateChanged");
+    state.detail = QLatin1String("checked");
+    state.detail1 = 1;
+    state.node = 1;
+    mock->sendEvents(state, 50);
+
+    QTRY_COMPARE(stateSpy.count(), 50);
+    QCOMPARE(stateSpy.first().at(0).value<AccessibleObject>().name(), QStringLiteral("node 1"));
+    QCOMPARE(stateSpy.first().at(1).toString(), QStringLiteral("checked"));
+    Registry::EventQueueStatistics statistics = registry.eventQueueStatistics();
+    QCOMPARE(statistics.received, quint64(50));
+    QCOMPARE(statistics.delivered, quint64(50));
+    QCOMPARE(statistics.dropped, quint64(0));
+    QCOMPARE(statistics.pending, 0);
+    QVERIFY(statistics.highWaterMark >= 1);
+
+    // the registry does not run its event loop, the small queue overflows
+    registry.setEventReceiverThread(true, 8);
+    registry.resetEventQueueStatistics();
+    stateSpy.clear();
+    mock->sendEvents(state, 100);
+    QDeadlineTimer deadline(5000);
+    while (registry.eventQueueStatistics().received < 100 && !deadline.hasExpired())
+        QThread::msleep(10);
+    QCOMPARE(registry.eventQueueStatistics().received, quint64(100));
+    QTRY_COMPARE(registry.eventQueueStatistics().pending, 0);
+    statistics = registry.eventQueueStatistics();
+    QVERIFY(statistics.dropped > 0);
+    QCOMPARE(statistics.highWaterMark, 8);
+    QCOMPARE(statistics.delivered + statistics.dropped, statistics.received);
+    QCOMPARE(quint64(stateSpy.count()), statistics.delivered);
+
+    registry.setEventReceiverThread(false);
+    QVERIFY(!registry.isEventReceiverThreadEnabled());
+    stateSpy.clear();
+    mock->sendEvents(state, 3);
+    QTRY_COMPARE(stateSpy.count(), 3);
+}
+
+void AccessibilityClientTest::tst_concurrentAccess()
+{
+    const int nodeCount = 40;
+    MockAtspiApplication *first = new MockAtspiApplication(nodeCount, 3);
+    MockAtspiApplication *second = new MockAtspiApplication(nodeCount, 3);
+    QVERIFY(first->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_concurrent_first"))));
+    QVERIFY(second->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_concurrent_second"))));
+    QThread thread;
+    first->moveToThread(&thread);
+    second->moveToThread(&thread);
+    connect(&thread, &QThread::finished, first, &QObject::deleteLater);
+    connect(&thread, &QThread::finished, second, &QObject::deleteLater);
+    thread.start();
+
+    // a small cache, so the walkers keep evicting each other's objects
+    RegistryPrivateCacheApi cache(&registry);
+    cache.setCacheLimits(16, 0);
+    cache.setCacheType(RegistryPrivateCacheApi::StrongLruCache);
+    registry.subscribeEventListeners(Registry::PropertyChanged | Registry::ChildrenChanged);
+    const auto stop = qScopeGuard([this, &thread, &cache]() {
+        registry.subscribeEventListeners(Registry::NoEventListeners);
+        cache.setCacheLimits(10000, 16 * 1024 * 1024);
+        cache.setCacheType(RegistryPrivateCacheApi::NoCache);
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_concurrent_first"));
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_concurrent_second"));
+    });
+
+    const auto root = [this](MockAtspiApplication *application) {
+        QUrl url;
+        url.setScheme(QLatin1String("accessibleobject"));
+        url.setPath(application->path(0));
+        url.setFragment(application->service());
+        return registry.accessibleFromUrl(url);
+    };
+    const QList<AccessibleObject> roots = { root(first), root(second), root(first), root(second) };
+
+    // every worker walks a whole tree, two of them per application; the test macros are
+    // not meant for other threads, the workers only record what they find
+    QList<QStringList> names(roots.size());
+    QList<int> mismatchedParents(roots.size(), 0);
+    QList<QThread *> workers;
+    for (int i = 0; i < roots.size(); ++i) {
+        workers.append(QThread::create([&roots, &names, &mismatchedParents, i]() {
+            std::function<void(const AccessibleObject &)> walk = [&](const AccessibleObject &object) {
+                names[i].append(object.name());
+                const QList<AccessibleObject> children = object.children();
+                for (const AccessibleObject &child : children) {
+                    if (child.parent() != object)
+                        ++mismatchedParents[i];
+                    walk(child);
+                }
+            };
+            const QList<AccessibleObject> children = roots.at(i).children();
+            for (const AccessibleObject &child : children)
+                walk(child);
+        }));
+    }
+    for (QThread *worker : std::as_const(workers))
+        worker->start();
+    for (QThread *worker : std::as_const(workers))
+        QTRY_VERIFY_WITH_TIMEOUT(worker->isFinished(), 30000);
+    qDeleteAll(workers);
+
+    QCOMPARE(mismatchedParents, QList<int>(roots.size(), 0));
+    for (QStringList &walked : names) {
+        QCOMPARE(walked.size(), nodeCount - 1);
+        walked.removeDuplicates();
+        QCOMPARE(walked.size(), nodeCount - 1);
+        QVERIFY(walked.contains(QLatin1String("node 1")));
+        QVERIFY(walked.contains(QLatin1String("node %1").arg(nodeCount - 1)));
+    }
+
+    const Registry::CacheStatistics statistics = registry.cacheStatistics();
+    QVERIFY(statistics.evictions > 0);
+    QVERIFY(statistics.objects.hits + statistics.objects.misses > 0);
+}
+
+void AccessibilityClientTest::tst_crawl()
+{
+    const int nodeCount = 40;
+    MockAtspiApplication *first = new MockAtspiApplication(nodeCount, 3);
+    MockAtspiApplication *second = new MockAtspiApplication(nodeCount, 3);
+    QVERIFY(first->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_crawl_first"))));
+    QVERIFY(second->registerOn(MockAtspiApplication::connectToAccessibilityBus(QLatin1String("tst_crawl_second"))));
+    QThread thread;
+    first->moveToThread(&thread);
+    second->moveToThread(&thread);
+    connect(&thread, &QThread::finished, first, &QObject::deleteLater);
+    connect(&thread, &QThread::finished, second, &QObject::deleteLater);
+    thread.start();
+    const auto stop = qScopeGuard([&thread]() {
+        thread.quit();
+        thread.wait();
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_crawl_first"));
+        QDBusConnection::disconnectFromBus(QLatin1String("tst_crawl_second"));
+    });
+
+    const auto root = [this](MockAtspiApplication *application) {
+        QUrl url;
+        url.setScheme(QLatin1String("accessibleobject"));
+        url.setPath(application->path(0));
+        url.setFragment(application->service());
+        return registry.accessibleFromUrl(url);
+    };
+    Registry::CrawlOptions options;
+    options.applications = { root(first), root(second) };
+
+    QList<Registry::CrawledObject> crawled;
+    const auto visit = [&crawled](const Registry::CrawledObject &object) {
+        crawled.append(object);
+    };
+
+    // both trees completely, every object after its parent
+    QFuture<int> future = registry.crawl(options, visit);
+    QTRY_VERIFY_WITH_TIMEOUT(future.isFinished(), 30000);
+    QCOMPARE(future.result(), 2 * nodeCount);
+    QCOMPARE(crawled.size(), 2 * nodeCount);
+    QHash<AccessibleObject, int> depths;
+    QStringList urls;
+    for (const Registry::CrawledObject &object : std::as_const(crawled)) {
+        if (object.parent.isValid()) {
+            QVERIFY(depths.contains(object.parent));
+            QCOMPARE(object.depth, depths.value(object.parent) + 1);
+        } else {
+            QVERIFY(options.applications.contains(object.object));
+            QCOMPARE(object.depth, 0);
+        }
+        depths.insert(object.object, object.depth);
+        urls.append(object.object.url().toString());
+    }
+    urls.removeDuplicates();
+    QCOMPARE(urls.size(), 2 * nodeCount);
+
+    // the applications and their children
+    options.maxDepth = 1;
+    crawled.clear();
+    future = registry.crawl(options, visit);
+    QTRY_VERIFY_WITH_TIMEOUT(future.isFinished(), 30000);
+    QCOMPARE(future.result(), 2 * 4);
+    QCOMPARE(crawled.size(), 2 * 4);
+
+    // the application and the panels of the mock have no role of their own, pruned the walk stops at the roots
+    options.maxDepth = -1;
+    options.prunedRoles = { AccessibleObject::NoRole };
+    crawled.clear();
+    future = registry.crawl(options, visit);
+    QTRY_VERIFY_WITH_TIMEOUT(future.isFinished(), 30000);
+    QCOMPARE(future.result(), 2);
+    QCOMPARE(crawled.size(), 2);
+    QCOMPARE(crawled.at(0).role, AccessibleObject::NoRole);
+
+    // without a cache every reference is a new object, a root listed twice and a cycle are still walked once
+    options.prunedRoles.clear();
+    options.applications = { root(first), root(first) };
+    first->setCycle(true);
+    crawled.clear();
+    future = registry.crawl(options, visit);
+    QTRY_VERIFY_WITH_TIMEOUT(future.isFinished(), 30000);
+    QCOMPARE(future.result(), nodeCount);
+    QCOMPARE(crawled.size(), nodeCount);
+    first->setCycle(false);
+    options.applications = { root(first), root(second) };
+
+    // nothing is visited once the future is canceled
+    options.maxRequestsPerService = 1;
+    crawled.clear();
+    future = registry.crawl(options, [&crawled, &future](const Registry::CrawledObject &object) {
+        crawled.append(object);
+        if (crawled.size() == 5)
+            future.cancel();
+    });
+    QTRY_VERIFY_WITH_TIMEOUT(future.isFinished(), 30000);
+    QVERIFY(future.isCanceled());
+    QCOMPARE(crawled.size(), 5);
+}
+
 QTEST_MAIN(AccessibilityClientTest)
 
 #include "tst_accessibilityclient.moc"
@@ -0,0 +1,323 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QTest>
+
+#include <QDBusConnection>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "qaccessibilityclient/registry.h"
+#include "qaccessibilityclient/accessibleobject.h"
+#include "qaccessibilityclient/registrycache_p.h"
+
+#include "mockatspiapplication.h"
+#include "mockatspiregistry.h"
+
+using namespace QAccessibleClient;
+
+Q_DECLARE_METATYPE(QAccessibleClient::RegistryPrivateCacheApi::CacheType)
+
+/*
+    Measures the Registry against MockAtspiApplication on a private
+    dbus-daemon, no accessibility bus or running application is needed.
+
+    The size of the mock application is read from the environment:
+    QACCESSIBILITYCLIENT_BENCH_NODES      objects in the tree (default 1000)
+    QACCESSIBILITYCLIENT_BENCH_FANOUT     children per object (default 8)
+    QACCESSIBILITYCLIENT_BENCH_EVENTS     events per dispatch run (default 10000)
+    QACCESSIBILITYCLIENT_BENCH_EVENT_RATE events per second, 0 sends them at once (default 0)
+*/
+class RegistryBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void eventDispatch_data();
+    void eventDispatch();
+    void treeWalk_data();
+    void treeWalk();
+    void cacheBehaviour_data();
+    void cacheBehaviour();
+    void memoryPerObject_data();
+    void memoryPerObject();
+
+private:
+    static int environment(const char *name, int defaultValue);
+    static quint64 misses(const Registry::CacheStatistics &statistics);
+    void cacheTypes();
+    int walk(const AccessibleObject &object);
+
+    QTemporaryDir m_busDir;
+    QProcess m_bus;
+    QThread m_providerThread;
+    MockAtspiRegistry *m_desktop = nullptr;
+    MockAtspiApplication *m_application = nullptr;
+    Registry *m_registry = nullptr;
+    AccessibleObject m_root;
+
+    int m_nodes = 0;
+    int m_events = 0;
+    int m_eventRate = 0;
+    int m_stateChanges = 0;
+};
+
+int RegistryBenchmark::environment(const char *name, int defaultValue)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok ? value : defaultValue;
+}
+
+quint64 RegistryBenchmark::misses(const Registry::CacheStatistics &statistics)
+{
+    return statistics.names.misses + statistics.descriptions.misses + statistics.roles.misses
+            + statistics.parents.misses + statistics.children.misses + statistics.childCounts.misses
+            + statistics.interfaces.misses + statistics.states.misses;
+}
+
+void RegistryBenchmark::initTestCase()
+{
+    QVERIFY(m_busDir.isValid());
+    QFile config(m_busDir.filePath(QLatin1String("bus.conf")));
+    QVERIFY(config.open(QIODevice::WriteOnly));
+    // no service directories, nothing may get activated behind the benchmark's back
+    config.write("<!DOCTYPE busconfig PUBLIC \"-//freedesktop//DTD D-Bus Bus Configuration 1.0//EN\"\n"
+                 " \"http://www.freedesktop.org/standards/dbus/1.0/busconfig.dtd\">\n"
+                 "<busconfig>\n"
+                 "  <type>session</type>\n"
+                 "  <listen>unix:dir=" + m_busDir.path().toUtf8() + "</listen>\n"
+                 "  <auth>EXTERNAL</auth>\n"
+                 "  <policy context=\"default\">\n"
+                 "    <allow send_destination=\"*\" eavesdrop=\"true\"/>\n"
+                 "    <allow eavesdrop=\"true\"/>\n"
+                 "    <allow own=\"*\"/>\n"
+                 "  </policy>\n"
+                 "</busconfig>\n");
+    config.close();
+
+    m_bus.start(QLatin1String("dbus-daemon"), QStringList() << QLatin1String("--nofork") << QLatin1String("--print-address")
+                << (QLatin1String("--config-file=") + config.fileName()));
+    if (!m_bus.waitForStarted())
+        QSKIP("dbus-daemon is not available.");
+    QVERIFY(m_bus.waitForReadyRead(10000));
+    const QString address = QString::fromUtf8(m_bus.readLine()).trimmed();
+    QVERIFY(!address.isEmpty());
+
+    // The Registry finds no org.a11y.Bus on the private bus and falls back to it as session bus,
+    // where MockAtspiRegistry stands in for at-spi2-registryd.
+    qputenv("DBUS_SESSION_BUS_ADDRESS", address.toUtf8());
+
+    m_nodes = environment("QACCESSIBILITYCLIENT_BENCH_NODES", 1000);
+    m_events = environment("QACCESSIBILITYCLIENT_BENCH_EVENTS", 10000);
+    m_eventRate = environment("QACCESSIBILITYCLIENT_BENCH_EVENT_RATE", 0);
+
+    m_desktop = new MockAtspiRegistry;
+    QVERIFY(m_desktop->registerOn(QDBusConnection::connectToBus(address, QLatin1String("mockatspiregistry"))));
+    m_application = new MockAtspiApplication(m_nodes, environment("QACCESSIBILITYCLIENT_BENCH_FANOUT", 8));
+    QVERIFY(m_application->registerOn(QDBusConnection::connectToBus(address, QLatin1String("mockatspiapplication"))));
+    m_desktop->addApplication(m_application->reference(0));
+
+    for (QObject *provider : {static_cast<QObject*>(m_desktop), static_cast<QObject*>(m_application)}) {
+        provider->moveToThread(&m_providerThread);
+        connect(&m_providerThread, &QThread::finished, provider, &QObject::deleteLater);
+    }
+    m_providerThread.start();
+
+    m_registry = new Registry;
+    connect(m_registry, &Registry::stateChanged, this, [this]() { ++m_stateChanges; });
+    m_registry->subscribeEventListeners(Registry::StateChanged | Registry::PropertyChanged | Registry::ChildrenChanged);
+
+    const QList<AccessibleObject> applications = m_registry->applications();
+    QCOMPARE(applications.size(), 1);
+    m_root = applications.first();
+    QTRY_VERIFY(m_desktop->registeredEvents().contains(QLatin1String("object:state-changed")));
+    QCOMPARE(m_root.name(), QLatin1String("mock application"));
+
+    // the match rules are in place once a first event arrives
+    m_application->sendStateChanged(1, 0);
+    QVERIFY(QTest::qWaitFor([this]() { return m_stateChanges == 1; }, 10000));
+}
+
+void RegistryBenchmark::cleanupTestCase()
+{
+    m_root = AccessibleObject();
+    delete m_registry;
+    m_registry = nullptr;
+
+    if (m_providerThread.isRunning()) {
+        m_providerThread.quit();
+        m_providerThread.wait();
+        m_desktop = nullptr;
+        m_application = nullptr;
+        QDBusConnection::disconnectFromBus(QLatin1String("mockatspiregistry"));
+        QDBusConnection::disconnectFromBus(QLatin1String("mockatspiapplication"));
+    }
+
+    if (m_bus.state() != QProcess::NotRunning) {
+        m_bus.terminate();
+        m_bus.waitForFinished();
+    }
+}
+
+void RegistryBenchmark::init()
+{
+    RegistryPrivateCacheApi cache(m_registry);
+    cache.clearClientCache();
+    m_registry->resetCacheStatistics();
+    m_stateChanges = 0;
+}
+
+void RegistryBenchmark::cacheTypes()
+{
+    QTest::addColumn<RegistryPrivateCacheApi::CacheType>("cacheType");
+    QTest::addColumn<int>("maxObjects");
+
+    QTest::newRow("NoCache") << RegistryPrivateCacheApi::NoCache << 0;
+    QTest::newRow("WeakCache") << RegistryPrivateCacheApi::WeakCache << 0;
+    QTest::newRow("StrongLruCache") << RegistryPrivateCacheApi::StrongLruCache << 0;
+    QTest::newRow("StrongLruCache, half the tree") << RegistryPrivateCacheApi::StrongLruCache << qMax(1, m_nodes / 2);
+}
+
+int RegistryBenchmark::walk(const AccessibleObject &object)
+{
+    object.name();
+    object.role();
+    object.childCount();
+    int count = 1;
+    const QList<AccessibleObject> children = object.children();
+    for (const AccessibleObject &child : children)
+        count += walk(child);
+    return count;
+}
+
+void RegistryBenchmark::eventDispatch_data()
+{
+    cacheTypes();
+}
+
+void RegistryBenchmark::eventDispatch()
+{
+    QFETCH(RegistryPrivateCacheApi::CacheType, cacheType);
+    QFETCH(int, maxObjects);
+
+    RegistryPrivateCacheApi cache(m_registry);
+    cache.setCacheType(cacheType);
+    cache.setCacheLimits(maxObjects, 0);
+
+    QElapsedTimer timer;
+    qint64 fastest = -1;
+    QBENCHMARK {
+        m_stateChanges = 0;
+        timer.start();
+        m_application->sendStateChanged(m_events, m_eventRate);
+        QVERIFY(QTest::qWaitFor([this]() { return m_stateChanges >= m_events; }, 60000));
+        const qint64 elapsed = timer.nsecsElapsed();
+        if (fastest < 0 || elapsed < fastest)
+            fastest = elapsed;
+    }
+    QCOMPARE(m_stateChanges, m_events);
+    qInfo("%d events in %.1f ms, %.0f events/s", m_events, fastest / 1e6, m_events * 1e9 / qMax<qint64>(1, fastest));
+}
+
+void RegistryBenchmark::treeWalk_data()
+{
+    cacheTypes();
+}
+
+void RegistryBenchmark::treeWalk()
+{
+    QFETCH(RegistryPrivateCacheApi::CacheType, cacheType);
+    QFETCH(int, maxObjects);
+
+    RegistryPrivateCacheApi cache(m_registry);
+    cache.setCacheType(cacheType);
+    cache.setCacheLimits(maxObjects, 0);
+
+    // the first walk is cold, the benchmarked ones find whatever the cache kept
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(walk(m_root), m_nodes);
+    qInfo("cold walk of %d objects in %.1f ms", m_nodes, timer.nsecsElapsed() / 1e6);
+
+    QBENCHMARK {
+        walk(m_root);
+    }
+}
+
+void RegistryBenchmark::cacheBehaviour_data()
+{
+    cacheTypes();
+}
+
+void RegistryBenchmark::cacheBehaviour()
+{
+    QFETCH(RegistryPrivateCacheApi::CacheType, cacheType);
+    QFETCH(int, maxObjects);
+
+    RegistryPrivateCacheApi cache(m_registry);
+    cache.setCacheType(cacheType);
+    cache.setCacheLimits(maxObjects, 0);
+
+    QCOMPARE(walk(m_root), m_nodes);
+    const Registry::CacheStatistics cold = m_registry->cacheStatistics();
+    QCOMPARE(walk(m_root), m_nodes);
+    const Registry::CacheStatistics warm = m_registry->cacheStatistics();
+
+    qInfo("second walk: %llu property hits, %llu misses, %llu evictions, %d objects cached",
+          warm.names.hits - cold.names.hits + warm.roles.hits - cold.roles.hits
+              + warm.children.hits - cold.children.hits + warm.childCounts.hits - cold.childCounts.hits,
+          misses(warm) - misses(cold), warm.evictions - cold.evictions, warm.objectCount);
+    QTest::setBenchmarkResult(qreal(misses(warm) - misses(cold)), QTest::CacheMisses);
+}
+
+void RegistryBenchmark::memoryPerObject_data()
+{
+    QTest::addColumn<RegistryPrivateCacheApi::CacheType>("cacheType");
+
+    QTest::newRow("WeakCache") << RegistryPrivateCacheApi::WeakCache;
+    QTest::newRow("StrongLruCache") << RegistryPrivateCacheApi::StrongLruCache;
+}
+
+void RegistryBenchmark::memoryPerObject()
+{
+    QFETCH(RegistryPrivateCacheApi::CacheType, cacheType);
+
+    RegistryPrivateCacheApi cache(m_registry);
+    cache.setCacheType(cacheType);
+    cache.setCacheLimits(0, 0);
+
+    // keep every object referenced, the weak cache drops released ones
+    QList<AccessibleObject> objects;
+    objects.reserve(m_nodes);
+    QList<AccessibleObject> pending = QList<AccessibleObject>() << m_root;
+    while (!pending.isEmpty()) {
+        const AccessibleObject object = pending.takeLast();
+        object.name();
+        object.role();
+        object.childCount();
+        pending += object.children();
+        objects.append(object);
+    }
+    QCOMPARE(objects.size(), m_nodes);
+
+    const Registry::CacheStatistics statistics = m_registry->cacheStatistics();
+    QVERIFY(statistics.objectCount > 0);
+    const qreal bytes = qreal(statistics.approximateBytes) / statistics.objectCount;
+    qInfo("%d objects cached in about %lld bytes", statistics.objectCount, statistics.approximateBytes);
+    QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+}
+
+QTEST_GUILESS_MAIN(RegistryBenchmark)
+
+#include "bench_registry.moc"
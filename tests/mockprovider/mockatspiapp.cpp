@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <cstdio>
+
+#include "mockatspiapplication.h"
+#include "mockatspiregistry.h"
+
+// Runs MockAtspiApplication as separate process, prints its service name once it is registered.
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QLatin1String("Synthetic AT-SPI application for tests and benchmarks"));
+    parser.addHelpOption();
+    const QCommandLineOption address(QLatin1String("address"), QLatin1String("Bus to connect to, defaults to the accessibility bus."), QLatin1String("address"));
+    const QCommandLineOption nodes(QLatin1String("nodes"), QLatin1String("Number of accessible objects."), QLatin1String("count"), QLatin1String("100"));
+    const QCommandLineOption fanOut(QLatin1String("fanout"), QLatin1String("Children per object."), QLatin1String("count"), QLatin1String("4"));
+    const QCommandLineOption latency(QLatin1String("latency"), QLatin1String("Delay of every reply."), QLatin1String("msec"), QLatin1String("0"));
+    const QCommandLineOption failureRate(QLatin1String("failure-rate"), QLatin1String("Fraction of calls answered with an error."), QLatin1String("rate"), QLatin1String("0"));
+    const QCommandLineOption timeoutRate(QLatin1String("timeout-rate"), QLatin1String("Fraction of calls left unanswered."), QLatin1String("rate"), QLatin1String("0"));
+    const QCommandLineOption events(QLatin1String("events"), QLatin1String("StateChanged events to send after start."), QLatin1String("count"), QLatin1String("0"));
+    const QCommandLineOption eventRate(QLatin1String("event-rate"), QLatin1String("Events per second, 0 sends them at once."), QLatin1String("rate"), QLatin1String("0"));
+    const QCommandLineOption registry(QLatin1String("registry"), QLatin1String("Also provide org.a11y.atspi.Registry, only on a private bus."));
+    parser.addOptions({address, nodes, fanOut, latency, failureRate, timeoutRate, events, eventRate, registry});
+    parser.process(app);
+
+    const auto connectToBus = [&parser, &address](const QString &name) {
+        return parser.isSet(address) ? QDBusConnection::connectToBus(parser.value(address), name)
+                                     : MockAtspiApplication::connectToAccessibilityBus(name);
+    };
+    const QDBusConnection connection = connectToBus(QLatin1String("mockatspiapp"));
+    if (!connection.isConnected()) {
+        fprintf(stderr, "Could not connect to the bus: %s\n", qPrintable(connection.lastError().message()));
+        return 1;
+    }
+
+    MockAtspiApplication application(parser.value(nodes).toInt(), parser.value(fanOut).toInt());
+    application.setLatency(parser.value(latency).toInt());
+    application.setFailureRate(parser.value(failureRate).toDouble());
+    application.setTimeoutRate(parser.value(timeoutRate).toDouble());
+    if (!application.registerOn(connection)) {
+        fprintf(stderr, "Could not register the application.\n");
+        return 1;
+    }
+
+    // the registry needs a connection of its own, both serve /org/a11y/atspi
+    MockAtspiRegistry desktop;
+    if (parser.isSet(registry)) {
+        if (!desktop.registerOn(connectToBus(QLatin1String("mockatspiregistry")))) {
+            fprintf(stderr, "Could not register org.a11y.atspi.Registry.\n");
+            return 1;
+        }
+        desktop.addApplication(application.reference(0));
+    }
+
+    fprintf(stdout, "%s\n", qPrintable(application.service()));
+    fflush(stdout);
+
+    application.sendStateChanged(parser.value(events).toInt(), parser.value(eventRate).toInt());
+    return app.exec();
+}
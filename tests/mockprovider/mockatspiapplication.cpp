@@ -0,0 +1,524 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "mockatspiapplication.h"
+
+#include <QDBusMessage>
+#include <QDBusReply>
+#include <QDBusVariant>
+#include <QRandomGenerator>
+
+#include "atspi/atspi-constants.h"
+
+using namespace QAccessibleClient;
+
+static const int EventInterval = 10;
+static const int ExtentSize = 20;
+static const int CharacterWidth = 8;
+
+MockAtspiApplication::MockAtspiApplication(int nodeCount, int fanOut, QObject *parent)
+    : QDBusVirtualObject(parent)
+    , m_nodeCount(qMax(1, nodeCount))
+    , m_fanOut(qMax(1, fanOut))
+    , m_connection(QString())
+    , m_eventTimer(this)
+{
+    registerDBusTypes();
+    m_eventTimer.setInterval(EventInterval);
+    connect(&m_eventTimer, SIGNAL(timeout()), this, SLOT(sendPendingEvents()));
+}
+
+MockAtspiApplication::~MockAtspiApplication()
+{
+    if (m_connection.isConnected())
+        m_connection.unregisterObject(QLatin1String("/org/a11y/atspi"), QDBusConnection::UnregisterTree);
+}
+
+QDBusConnection MockAtspiApplication::connectToAccessibilityBus(const QString &name)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(QLatin1String("org.a11y.Bus"), QLatin1String("/org/a11y/bus"),
+                                                          QLatin1String("org.a11y.Bus"), QLatin1String("GetAddress"));
+    const QDBusReply<QString> address = QDBusConnection::sessionBus().call(message);
+    if (address.isValid() && !address.value().isEmpty())
+        return QDBusConnection::connectToBus(address.value(), name);
+    return QDBusConnection::connectToBus(QDBusConnection::SessionBus, name);
+}
+
+bool MockAtspiApplication::registerOn(const QDBusConnection &connection)
+{
+    m_connection = connection;
+    // covers the accessibles below /org/a11y/atspi/accessible and /org/a11y/atspi/cache
+    return m_connection.registerVirtualObject(QLatin1String("/org/a11y/atspi"), this, QDBusConnection::SubPath);
+}
+
+QString MockAtspiApplication::service() const
+{
+    return m_connection.baseService();
+}
+
+int MockAtspiApplication::nodeCount() const
+{
+    return m_nodeCount;
+}
+
+QString MockAtspiApplication::path(int node) const
+{
+    if (node == 0)
+        return QLatin1String(ATSPI_DBUS_PATH_ROOT);
+    return QLatin1String("/org/a11y/atspi/accessible/") + QString::number(node);
+}
+
+QSpiObjectReference MockAtspiApplication::reference(int node) const
+{
+    QSpiObjectReference reference;
+    reference.service = service();
+    reference.path = QDBusObjectPath(node < 0 ? QLatin1String(ATSPI_DBUS_PATH_NULL) : path(node));
+    return reference;
+}
+
+void MockAtspiApplication::setLatency(int msec)
+{
+    m_latency.storeRelaxed(qMax(0, msec));
+}
+
+void MockAtspiApplication::setFailureRate(qreal rate)
+{
+    m_failurePermille.storeRelaxed(qBound(0, qRound(rate * 1000), 1000));
+}
+
+void MockAtspiApplication::setTimeoutRate(qreal rate)
+{
+    m_timeoutPermille.storeRelaxed(qBound(0, qRound(rate * 1000), 1000));
+}
+
+void MockAtspiApplication::setCycle(bool cycle)
+{
+    m_cycle.storeRelaxed(cycle);
+}
+
+void MockAtspiApplication::sendEvents(const Event &event, int count, int rate)
+{
+    if (count <= 0)
+        return;
+    QMetaObject::invokeMethod(this, [this, event, count, rate]() {
+        m_pendingEvents.append(PendingEvents{event, count, rate > 0 ? qMax(1, rate * EventInterval / 1000) : count});
+        sendPendingEvents();
+        if (!m_pendingEvents.isEmpty())
+            m_eventTimer.start();
+    }, Qt::QueuedConnection);
+}
+
+void MockAtspiApplication::sendStateChanged(int count, int rate)
+{
+    Event event;
+    event.interface = QLatin1String(ATSPI_DBUS_INTERFACE_EVENT_OBJECT);
+    event.member = QLatin1String("StateChanged");
+    event.detail = QLatin1String("checked");
+    event.detail1 = 1;
+    sendEvents(event, count, rate);
+}
+
+void MockAtspiApplication::sendPendingEvents()
+{
+    if (m_pendingEvents.isEmpty()) {
+        m_eventTimer.stop();
+        return;
+    }
+
+    PendingEvents &pending = m_pendingEvents.first();
+    const QVariant application = QVariant::fromValue(reference(0));
+    const int count = qMin(pending.remaining, pending.perTick);
+    for (int i = 0; i < count; ++i) {
+        int node = pending.event.node;
+        if (node < 0) {
+            node = m_nextEventNode;
+            m_nextEventNode = (m_nextEventNode + 1) % m_nodeCount;
+        }
+
+        QDBusMessage event = QDBusMessage::createSignal(path(node), pending.event.interface, pending.event.member);
+        event.setArguments(QVariantList() << pending.event.detail << pending.event.detail1 << pending.event.detail2
+                           << QVariant::fromValue(QDBusVariant(pending.event.any)) << application);
+        m_connection.send(event);
+    }
+    pending.remaining -= count;
+    if (pending.remaining == 0)
+        m_pendingEvents.removeFirst();
+    if (m_pendingEvents.isEmpty())
+        m_eventTimer.stop();
+}
+
+QString MockAtspiApplication::introspect(const QString &path) const
+{
+    Q_UNUSED(path)
+    return QString();
+}
+
+bool MockAtspiApplication::roll(const QAtomicInt &permille)
+{
+    const int value = permille.loadRelaxed();
+    return value > 0 && int(QRandomGenerator::global()->bounded(1000)) < value;
+}
+
+bool MockAtspiApplication::handleMessage(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    if (roll(m_timeoutPermille))
+        return true;
+
+    QDBusMessage answer;
+    if (roll(m_failurePermille)) {
+        answer = message.createErrorReply(QDBusError::Failed, QLatin1String("Injected failure"));
+    } else if (message.path() == QLatin1String("/org/a11y/atspi/cache")) {
+        if (message.interface() == QLatin1String(ATSPI_DBUS_INTERFACE_CACHE) && message.member() == QLatin1String("GetItems")) {
+            QSpiAccessibleCacheArray items;
+            items.reserve(m_nodeCount);
+            for (int node = 0; node < m_nodeCount; ++node)
+                items.append(cacheItem(node));
+            answer = message.createReply(QVariant::fromValue(items));
+        }
+    } else {
+        const int node = nodeFromPath(message.path());
+        if (node < 0)
+            return false;
+        answer = reply(node, message);
+    }
+
+    if (answer.type() == QDBusMessage::InvalidMessage)
+        answer = message.createErrorReply(QDBusError::UnknownMethod, QLatin1String("Not implemented by the mock: ") + message.interface() + QLatin1Char('.') + message.member());
+
+    const int latency = m_latency.loadRelaxed();
+    if (latency > 0) {
+        QTimer::singleShot(latency, this, [connection, answer]() {
+            connection.send(answer);
+        });
+        return true;
+    }
+    return connection.send(answer);
+}
+
+QDBusMessage MockAtspiApplication::reply(int node, const QDBusMessage &message) const
+{
+    const QString interface = message.interface();
+    if (interface == QLatin1String("org.freedesktop.DBus.Properties"))
+        return propertiesReply(node, message);
+    if (!interfaces(node).contains(interface))
+        return QDBusMessage();
+    if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE))
+        return accessibleReply(node, message);
+    if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_COMPONENT))
+        return componentReply(node, message);
+    if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_TEXT))
+        return textReply(node, message);
+    if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_ACTION))
+        return actionReply(node, message);
+    if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_VALUE) && message.member() == QLatin1String("SetCurrentValue"))
+        return message.createReply(true);
+    if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_APPLICATION) && message.member() == QLatin1String("GetLocale"))
+        return message.createReply(QLatin1String("en_US"));
+    return QDBusMessage();
+}
+
+QDBusMessage MockAtspiApplication::accessibleReply(int node, const QDBusMessage &message) const
+{
+    const QString member = message.member();
+    const QVariantList arguments = message.arguments();
+
+    if (member == QLatin1String("GetChildren")) {
+        QSpiObjectReferenceList references;
+        const QList<int> nodes = children(node);
+        for (int child : nodes)
+            references.append(reference(child));
+        return message.createReply(QVariant::fromValue(references));
+    }
+    if (member == QLatin1String("GetChildAtIndex") && arguments.size() == 1) {
+        const QList<int> nodes = children(node);
+        const int index = arguments.at(0).toInt();
+        return message.createReply(QVariant::fromValue(reference(index >= 0 && index < nodes.size() ? nodes.at(index) : -1)));
+    }
+    if (member == QLatin1String("GetIndexInParent"))
+        return message.createReply(node == 0 ? -1 : (node - 1) % m_fanOut);
+    if (member == QLatin1String("GetRole"))
+        return message.createReply(cacheItem(node).role);
+    if (member == QLatin1String("GetRoleName") || member == QLatin1String("GetLocalizedRoleName")) {
+        static const char *const names[] = {"application", "panel", "push button", "text", "slider", "label"};
+        return message.createReply(QLatin1String(names[kind(node)]));
+    }
+    if (member == QLatin1String("GetState"))
+        return message.createReply(QVariant::fromValue(cacheItem(node).state));
+    if (member == QLatin1String("GetInterfaces"))
+        return message.createReply(interfaces(node));
+    if (member == QLatin1String("GetApplication"))
+        return message.createReply(QVariant::fromValue(reference(0)));
+    return QDBusMessage();
+}
+
+QDBusMessage MockAtspiApplication::componentReply(int node, const QDBusMessage &message) const
+{
+    const QString member = message.member();
+    const QVariantList arguments = message.arguments();
+    const QRect rect = extents(node);
+
+    if (member == QLatin1String("GetExtents"))
+        return message.createReply(rect);
+    if (member == QLatin1String("GetPosition"))
+        return message.createReply(QVariantList() << rect.x() << rect.y());
+    if (member == QLatin1String("GetSize"))
+        return message.createReply(QVariantList() << rect.width() << rect.height());
+    if (member == QLatin1String("Contains") && arguments.size() == 3)
+        return message.createReply(rect.contains(arguments.at(0).toInt(), arguments.at(1).toInt()));
+    if (member == QLatin1String("GetLayer"))
+        return message.createReply(uint(ATSPI_LAYER_WIDGET));
+    if (member == QLatin1String("GetMDIZOrder"))
+        return message.createReply(QVariant::fromValue(short(0)));
+    if (member == QLatin1String("GetAlpha"))
+        return message.createReply(1.0);
+    if (member == QLatin1String("GrabFocus"))
+        return message.createReply(true);
+    return QDBusMessage();
+}
+
+QDBusMessage MockAtspiApplication::textReply(int node, const QDBusMessage &message) const
+{
+    const QString member = message.member();
+    const QVariantList arguments = message.arguments();
+    const QString content = text(node);
+
+    if (member == QLatin1String("GetText") && arguments.size() == 2) {
+        const int start = qBound(0, arguments.at(0).toInt(), int(content.size()));
+        int end = arguments.at(1).toInt();
+        end = end < 0 ? int(content.size()) : qBound(start, end, int(content.size()));
+        return message.createReply(content.mid(start, end - start));
+    }
+    if (member == QLatin1String("GetTextAtOffset") || member == QLatin1String("GetTextBeforeOffset")
+            || member == QLatin1String("GetTextAfterOffset")) {
+        // every boundary spans the whole text
+        return message.createReply(QVariantList() << content << 0 << int(content.size()));
+    }
+    if (member == QLatin1String("GetCharacterExtents") && !arguments.isEmpty()) {
+        const QRect rect = extents(node);
+        const int offset = arguments.at(0).toInt();
+        return message.createReply(QVariantList() << rect.x() + offset * CharacterWidth << rect.y() << CharacterWidth << rect.height());
+    }
+    if (member == QLatin1String("GetNSelections"))
+        return message.createReply(0);
+    if (member == QLatin1String("GetSelection"))
+        return message.createReply(QVariantList() << 0 << 0);
+    if (member == QLatin1String("SetSelection") || member == QLatin1String("AddSelection") || member == QLatin1String("RemoveSelection"))
+        return message.createReply(true);
+    return QDBusMessage();
+}
+
+QDBusMessage MockAtspiApplication::actionReply(int node, const QDBusMessage &message) const
+{
+    Q_UNUSED(node)
+    const QString member = message.member();
+    const QVariantList arguments = message.arguments();
+    const bool first = !arguments.isEmpty() && arguments.at(0).toInt() == 0;
+
+    if (member == QLatin1String("GetActions")) {
+        QSpiAction action;
+        action.name = QLatin1String("press");
+        action.description = QLatin1String("Presses the button");
+        action.keyBinding = QLatin1String("Space");
+        return message.createReply(QVariant::fromValue(QSpiActionArray() << action));
+    }
+    if (member == QLatin1String("DoAction"))
+        return message.createReply(first);
+    if (member == QLatin1String("GetName"))
+        return message.createReply(first ? QLatin1String("press") : QString());
+    if (member == QLatin1String("GetDescription"))
+        return message.createReply(first ? QLatin1String("Presses the button") : QString());
+    if (member == QLatin1String("GetKeyBinding"))
+        return message.createReply(first ? QLatin1String("Space") : QString());
+    return QDBusMessage();
+}
+
+QDBusMessage MockAtspiApplication::propertiesReply(int node, const QDBusMessage &message) const
+{
+    const QVariantList arguments = message.arguments();
+    if (arguments.isEmpty())
+        return QDBusMessage();
+    const QString interface = arguments.at(0).toString();
+    if (!interfaces(node).contains(interface))
+        return message.createErrorReply(QDBusError::UnknownInterface, interface);
+
+    if (message.member() == QLatin1String("Get") && arguments.size() == 2) {
+        const QVariant value = property(node, interface, arguments.at(1).toString());
+        if (!value.isValid())
+            return message.createErrorReply(QDBusError::UnknownProperty, arguments.at(1).toString());
+        return message.createReply(QVariant::fromValue(QDBusVariant(value)));
+    }
+    if (message.member() == QLatin1String("GetAll")) {
+        QVariantMap properties;
+        const QStringList names = propertyNames(interface);
+        for (const QString &name : names)
+            properties.insert(name, property(node, interface, name));
+        return message.createReply(properties);
+    }
+    if (message.member() == QLatin1String("Set"))
+        return message.createReply();
+    return QDBusMessage();
+}
+
+int MockAtspiApplication::nodeFromPath(const QString &path) const
+{
+    if (path == QLatin1String(ATSPI_DBUS_PATH_ROOT))
+        return 0;
+    const QLatin1String prefix("/org/a11y/atspi/accessible/");
+    if (!path.startsWith(prefix))
+        return -1;
+    bool ok = false;
+    const int node = QStringView(path).mid(prefix.size()).toInt(&ok);
+    return ok && node > 0 && node < m_nodeCount ? node : -1;
+}
+
+MockAtspiApplication::Kind MockAtspiApplication::kind(int node) const
+{
+    if (node == 0)
+        return Application;
+    if (qint64(node) * m_fanOut + 1 < m_nodeCount)
+        return Panel;
+    static const Kind leaves[] = {Button, TextField, Slider, Label};
+    return leaves[node % 4];
+}
+
+int MockAtspiApplication::parent(int node) const
+{
+    return node == 0 ? -1 : (node - 1) / m_fanOut;
+}
+
+QList<int> MockAtspiApplication::children(int node) const
+{
+    QList<int> nodes;
+    const qint64 first = qint64(node) * m_fanOut + 1;
+    for (qint64 child = first; child < first + m_fanOut && child < m_nodeCount; ++child)
+        nodes.append(int(child));
+    if (node == m_nodeCount - 1 && m_cycle.loadRelaxed())
+        nodes.append(0);
+    return nodes;
+}
+
+QStringList MockAtspiApplication::interfaces(int node) const
+{
+    QStringList names;
+    names << QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE);
+    switch (kind(node)) {
+    case Application:
+        names << QLatin1String(ATSPI_DBUS_INTERFACE_APPLICATION);
+        return names;
+    case Button:
+        names << QLatin1String(ATSPI_DBUS_INTERFACE_ACTION);
+        break;
+    case TextField:
+    case Label:
+        names << QLatin1String(ATSPI_DBUS_INTERFACE_TEXT);
+        break;
+    case Slider:
+        names << QLatin1String(ATSPI_DBUS_INTERFACE_VALUE);
+        break;
+    case Panel:
+        break;
+    }
+    names << QLatin1String(ATSPI_DBUS_INTERFACE_COMPONENT);
+    return names;
+}
+
+QStringList MockAtspiApplication::propertyNames(const QString &interface) const
+{
+    QStringList names;
+    if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE))
+        names << QLatin1String("Name") << QLatin1String("Description") << QLatin1String("ChildCount")
+              << QLatin1String("Parent") << QLatin1String("Locale") << QLatin1String("AccessibleId");
+    else if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_TEXT))
+        names << QLatin1String("CharacterCount") << QLatin1String("CaretOffset");
+    else if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_VALUE))
+        names << QLatin1String("MinimumValue") << QLatin1String("MaximumValue")
+              << QLatin1String("MinimumIncrement") << QLatin1String("CurrentValue");
+    else if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_ACTION))
+        names << QLatin1String("NActions");
+    else if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_APPLICATION))
+        names << QLatin1String("ToolkitName") << QLatin1String("Version") << QLatin1String("AtspiVersion") << QLatin1String("Id");
+    return names;
+}
+
+QVariant MockAtspiApplication::property(int node, const QString &interface, const QString &name) const
+{
+    if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE)) {
+        if (name == QLatin1String("Name"))
+            return node == 0 ? QStringLiteral("mock application") : QLatin1String("node ") + QString::number(node);
+        if (name == QLatin1String("Description"))
+            return QString();
+        if (name == QLatin1String("ChildCount"))
+            return int(children(node).size());
+        if (name == QLatin1String("Parent"))
+            return QVariant::fromValue(reference(parent(node)));
+        if (name == QLatin1String("Locale"))
+            return QStringLiteral("en_US");
+        if (name == QLatin1String("AccessibleId"))
+            return QLatin1String("node") + QString::number(node);
+    } else if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_TEXT)) {
+        if (name == QLatin1String("CharacterCount"))
+            return int(text(node).size());
+        if (name == QLatin1String("CaretOffset"))
+            return 0;
+    } else if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_VALUE)) {
+        if (name == QLatin1String("MinimumValue"))
+            return 0.0;
+        if (name == QLatin1String("MaximumValue"))
+            return 100.0;
+        if (name == QLatin1String("MinimumIncrement"))
+            return 1.0;
+        if (name == QLatin1String("CurrentValue"))
+            return double(node % 101);
+    } else if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_ACTION)) {
+        if (name == QLatin1String("NActions"))
+            return 1;
+    } else if (interface == QLatin1String(ATSPI_DBUS_INTERFACE_APPLICATION)) {
+        if (name == QLatin1String("ToolkitName"))
+            return QStringLiteral("mock");
+        if (name == QLatin1String("Version"))
+            return QStringLiteral("1.0");
+        if (name == QLatin1String("AtspiVersion"))
+            return QStringLiteral("2.1");
+        if (name == QLatin1String("Id"))
+            return 0;
+    }
+    return QVariant();
+}
+
+QString MockAtspiApplication::text(int node) const
+{
+    return QLatin1String("Text of node ") + QString::number(node);
+}
+
+QRect MockAtspiApplication::extents(int node) const
+{
+    return QRect((node % 32) * ExtentSize, (node / 32) * ExtentSize, ExtentSize, ExtentSize);
+}
+
+QSpiAccessibleCacheItem MockAtspiApplication::cacheItem(int node) const
+{
+    static const uint roles[] = {ATSPI_ROLE_APPLICATION, ATSPI_ROLE_PANEL, ATSPI_ROLE_PUSH_BUTTON,
+                                 ATSPI_ROLE_TEXT, ATSPI_ROLE_SLIDER, ATSPI_ROLE_LABEL};
+
+    QSpiAccessibleCacheItem item;
+    item.path = reference(node);
+    item.application = reference(0);
+    item.parent = reference(parent(node));
+    const QList<int> nodes = children(node);
+    for (int child : nodes)
+        item.children.append(reference(child));
+    item.supportedInterfaces = interfaces(node);
+    item.name = property(node, QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE), QLatin1String("Name")).toString();
+    item.role = roles[kind(node)];
+    quint64 state = (quint64(1) << ATSPI_STATE_ENABLED) | (quint64(1) << ATSPI_STATE_SENSITIVE)
+            | (quint64(1) << ATSPI_STATE_SHOWING) | (quint64(1) << ATSPI_STATE_VISIBLE);
+    if (kind(node) == Button || kind(node) == TextField || kind(node) == Slider)
+        state |= quint64(1) << ATSPI_STATE_FOCUSABLE;
+    item.state << quint32(state) << quint32(state >> 32);
+    return item;
+}
+
+#include "moc_mockatspiapplication.cpp"
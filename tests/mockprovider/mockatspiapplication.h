@@ -0,0 +1,146 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef MOCKATSPIAPPLICATION_H
+#define MOCKATSPIAPPLICATION_H
+
+#include <QAtomicInt>
+#include <QDBusConnection>
+#include <QDBusVirtualObject>
+#include <QList>
+#include <QRect>
+#include <QTimer>
+
+#include "atspi/qt-atspi.h"
+
+/*
+    A synthetic AT-SPI application for tests and benchmarks.
+
+    Exposes a tree of nodeCount objects in which every node has up to
+    fanOut children. The root lives at /org/a11y/atspi/accessible/root,
+    node n > 0 at /org/a11y/atspi/accessible/<n> and its parent is node
+    (n - 1) / fanOut. Inner nodes are panels, leaves are in turn push
+    buttons (Action), text fields (Text), sliders (Value) and labels
+    (Text). Every node but the root implements Component, the root
+    implements Application and the whole tree is served by Cache.
+
+    Calls can be delayed, answered with an error or left unanswered,
+    see setLatency(), setFailureRate() and setTimeoutRate().
+
+    The tree never changes after construction, calls that would modify
+    it succeed without effect. handleMessage() may be called from the
+    D-Bus thread and only reads immutable data or atomics.
+*/
+class MockAtspiApplication : public QDBusVirtualObject
+{
+    Q_OBJECT
+public:
+    /*
+        An event sent by a node, the arguments follow the siiv(so)
+        signature of the org.a11y.atspi.Event interfaces.
+    */
+    struct Event
+    {
+        QString interface;
+        QString member;
+        QString detail;
+        int detail1 = 0;
+        int detail2 = 0;
+        QVariant any = 0;
+        int node = -1; // -1 sends from every node in turn
+    };
+
+    MockAtspiApplication(int nodeCount, int fanOut, QObject *parent = nullptr);
+    ~MockAtspiApplication() override;
+
+    // Connects to the accessibility bus, or the session bus when there is none.
+    static QDBusConnection connectToAccessibilityBus(const QString &name);
+
+    // Registers the object tree on \a connection, the service is its base service.
+    bool registerOn(const QDBusConnection &connection);
+    QString service() const;
+    int nodeCount() const;
+
+    QString path(int node) const;
+    QAccessibleClient::QSpiObjectReference reference(int node) const;
+
+    // Delays every reply by \a msec milliseconds.
+    void setLatency(int msec);
+    // Answers the fraction \a rate of all calls with org.freedesktop.DBus.Error.Failed.
+    void setFailureRate(qreal rate);
+    // Leaves the fraction \a rate of all calls unanswered, the callers run into their timeout.
+    void setTimeoutRate(qreal rate);
+    // Lists the root as another child of the last node, the tree then has a cycle.
+    void setCycle(bool cycle);
+
+    /*
+        Sends \a event \a count times.
+
+        With a \a rate of 0 all events are sent at once, otherwise about
+        \a rate events per second. Can be called from any thread, the
+        events are sent from the thread this object lives in.
+    */
+    void sendEvents(const Event &event, int count, int rate = 0);
+    // Sends \a count StateChanged events spread over all nodes.
+    void sendStateChanged(int count, int rate = 0);
+
+    QString introspect(const QString &path) const override;
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override;
+
+private Q_SLOTS:
+    void sendPendingEvents();
+
+private:
+    enum Kind {
+        Application,
+        Panel,
+        Button,
+        TextField,
+        Slider,
+        Label
+    };
+
+    struct PendingEvents
+    {
+        Event event;
+        int remaining;
+        int perTick;
+    };
+
+    QDBusMessage reply(int node, const QDBusMessage &message) const;
+    QDBusMessage accessibleReply(int node, const QDBusMessage &message) const;
+    QDBusMessage componentReply(int node, const QDBusMessage &message) const;
+    QDBusMessage textReply(int node, const QDBusMessage &message) const;
+    QDBusMessage actionReply(int node, const QDBusMessage &message) const;
+    QDBusMessage propertiesReply(int node, const QDBusMessage &message) const;
+
+    int nodeFromPath(const QString &path) const;
+    Kind kind(int node) const;
+    int parent(int node) const;
+    QList<int> children(int node) const;
+    QStringList interfaces(int node) const;
+    QStringList propertyNames(const QString &interface) const;
+    QVariant property(int node, const QString &interface, const QString &name) const;
+    QString text(int node) const;
+    QRect extents(int node) const;
+    QAccessibleClient::QSpiAccessibleCacheItem cacheItem(int node) const;
+    static bool roll(const QAtomicInt &permille);
+
+    const int m_nodeCount;
+    const int m_fanOut;
+    QDBusConnection m_connection;
+
+    QAtomicInt m_latency;
+    QAtomicInt m_failurePermille;
+    QAtomicInt m_timeoutPermille;
+    QAtomicInt m_cycle;
+
+    QTimer m_eventTimer;
+    QList<PendingEvents> m_pendingEvents;
+    int m_nextEventNode = 0;
+};
+
+#endif
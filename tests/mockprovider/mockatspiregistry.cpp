@@ -0,0 +1,138 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "mockatspiregistry.h"
+
+#include <QDBusMessage>
+#include <QDBusVariant>
+#include <QMutexLocker>
+
+#include "atspi/atspi-constants.h"
+
+using namespace QAccessibleClient;
+
+MockAtspiRegistry::MockAtspiRegistry(QObject *parent)
+    : QDBusVirtualObject(parent)
+    , m_connection(QString())
+{
+    registerDBusTypes();
+}
+
+MockAtspiRegistry::~MockAtspiRegistry()
+{
+    if (m_connection.isConnected()) {
+        m_connection.unregisterObject(QLatin1String("/org/a11y/atspi"), QDBusConnection::UnregisterTree);
+        m_connection.unregisterService(QLatin1String(ATSPI_DBUS_NAME_REGISTRY));
+    }
+}
+
+bool MockAtspiRegistry::registerOn(const QDBusConnection &connection)
+{
+    m_connection = connection;
+    return m_connection.registerService(QLatin1String(ATSPI_DBUS_NAME_REGISTRY))
+            && m_connection.registerVirtualObject(QLatin1String("/org/a11y/atspi"), this, QDBusConnection::SubPath);
+}
+
+void MockAtspiRegistry::addApplication(const QSpiObjectReference &root)
+{
+    QMutexLocker locker(&m_mutex);
+    m_applications.append(root);
+}
+
+void MockAtspiRegistry::removeApplication(const QString &service)
+{
+    QMutexLocker locker(&m_mutex);
+    m_applications.removeIf([&service](const QSpiObjectReference &reference) {
+        return reference.service == service;
+    });
+}
+
+QSpiObjectReferenceList MockAtspiRegistry::applications() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_applications;
+}
+
+QStringList MockAtspiRegistry::registeredEvents() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_events;
+}
+
+QString MockAtspiRegistry::introspect(const QString &path) const
+{
+    Q_UNUSED(path)
+    return QString();
+}
+
+bool MockAtspiRegistry::handleMessage(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    QDBusMessage answer;
+    if (message.path() == QLatin1String(ATSPI_DBUS_PATH_REGISTRY)) {
+        if (message.interface() != QLatin1String(ATSPI_DBUS_INTERFACE_REGISTRY) || message.arguments().isEmpty())
+            return false;
+        const QString event = message.arguments().at(0).toString();
+        QMutexLocker locker(&m_mutex);
+        if (message.member() == QLatin1String("RegisterEvent"))
+            m_events.append(event);
+        else if (message.member() == QLatin1String("DeregisterEvent"))
+            m_events.removeOne(event);
+        else
+            return false;
+        answer = message.createReply();
+    } else if (message.path() == QLatin1String(ATSPI_DBUS_PATH_ROOT)) {
+        answer = desktopReply(message);
+    } else {
+        return false;
+    }
+
+    if (answer.type() == QDBusMessage::InvalidMessage)
+        answer = message.createErrorReply(QDBusError::UnknownMethod, QLatin1String("Not implemented by the mock: ") + message.interface() + QLatin1Char('.') + message.member());
+    return connection.send(answer);
+}
+
+QDBusMessage MockAtspiRegistry::desktopReply(const QDBusMessage &message) const
+{
+    const QString member = message.member();
+    const QVariantList arguments = message.arguments();
+    const QSpiObjectReferenceList applications = this->applications();
+
+    if (message.interface() == QLatin1String("org.freedesktop.DBus.Properties")) {
+        if (member != QLatin1String("Get") || arguments.size() != 2 || arguments.at(0).toString() != QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE))
+            return QDBusMessage();
+        const QString name = arguments.at(1).toString();
+        QVariant value;
+        if (name == QLatin1String("Name"))
+            value = QStringLiteral("main");
+        else if (name == QLatin1String("Description"))
+            value = QString();
+        else if (name == QLatin1String("ChildCount"))
+            value = int(applications.size());
+        else
+            return message.createErrorReply(QDBusError::UnknownProperty, name);
+        return message.createReply(QVariant::fromValue(QDBusVariant(value)));
+    }
+
+    if (message.interface() != QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE))
+        return QDBusMessage();
+    if (member == QLatin1String("GetChildren"))
+        return message.createReply(QVariant::fromValue(applications));
+    if (member == QLatin1String("GetChildAtIndex") && arguments.size() == 1) {
+        const int index = arguments.at(0).toInt();
+        if (index >= 0 && index < applications.size())
+            return message.createReply(QVariant::fromValue(applications.at(index)));
+        QSpiObjectReference null;
+        null.path = QDBusObjectPath(QLatin1String(ATSPI_DBUS_PATH_NULL));
+        return message.createReply(QVariant::fromValue(null));
+    }
+    if (member == QLatin1String("GetRole"))
+        return message.createReply(uint(ATSPI_ROLE_DESKTOP_FRAME));
+    if (member == QLatin1String("GetInterfaces"))
+        return message.createReply(QStringList() << QLatin1String(ATSPI_DBUS_INTERFACE_ACCESSIBLE));
+    return QDBusMessage();
+}
+
+#include "moc_mockatspiregistry.cpp"
@@ -0,0 +1,55 @@
+/*
+    SPDX-FileCopyrightText: 2026 libqaccessibilityclient contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#ifndef MOCKATSPIREGISTRY_H
+#define MOCKATSPIREGISTRY_H
+
+#include <QDBusConnection>
+#include <QDBusVirtualObject>
+#include <QMutex>
+#include <QStringList>
+
+#include "atspi/qt-atspi.h"
+
+/*
+    Stands in for at-spi2-registryd on a private bus.
+
+    Owns org.a11y.atspi.Registry, lists the added applications as
+    children of the desktop at /org/a11y/atspi/accessible/root and
+    remembers the events clients register with RegisterEvent. Only
+    useful where no real registry runs, the name cannot be taken on
+    a desktop's accessibility bus.
+*/
+class MockAtspiRegistry : public QDBusVirtualObject
+{
+    Q_OBJECT
+public:
+    explicit MockAtspiRegistry(QObject *parent = nullptr);
+    ~MockAtspiRegistry() override;
+
+    bool registerOn(const QDBusConnection &connection);
+
+    void addApplication(const QAccessibleClient::QSpiObjectReference &root);
+    void removeApplication(const QString &service);
+    QAccessibleClient::QSpiObjectReferenceList applications() const;
+
+    // The event names passed to RegisterEvent and not deregistered since.
+    QStringList registeredEvents() const;
+
+    QString introspect(const QString &path) const override;
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override;
+
+private:
+    QDBusMessage desktopReply(const QDBusMessage &message) const;
+
+    QDBusConnection m_connection;
+
+    mutable QMutex m_mutex;
+    QAccessibleClient::QSpiObjectReferenceList m_applications;
+    QStringList m_events;
+};
+
+#endif